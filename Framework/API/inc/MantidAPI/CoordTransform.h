@@ -43,6 +43,9 @@ public:
   /// Wrapper for VMD
   Mantid::Kernel::VMD applyVMD(const Mantid::Kernel::VMD &inputVector) const;
 
+  virtual void applyBatch(const coord_t *inputVectors, coord_t *outVectors,
+                          const size_t numPoints) const;
+
   /// @return the number of input dimensions
   size_t getInD() const { return inD; };
 
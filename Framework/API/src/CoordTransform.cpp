@@ -58,5 +58,21 @@ CoordTransform::applyVMD(const Mantid::Kernel::VMD &inputVector) const {
   return out;
 }
 
+//----------------------------------------------------------------------------------------------
+/** Apply the coordinate transformation to several points. Subclasses
+ * override this to transform the points together, which is faster than one
+ * call to apply() per point.
+ *
+ * @param inputVectors :: the input coordinates of each point, inD per point
+ * @param outVectors :: the output coordinates of each point, outD per point
+ * @param numPoints :: the number of points
+ */
+void CoordTransform::applyBatch(const coord_t *inputVectors,
+                                coord_t *outVectors,
+                                const size_t numPoints) const {
+  for (size_t i = 0; i < numPoints; ++i)
+    this->apply(inputVectors + i * inD, outVectors + i * outD);
+}
+
 } // namespace API
 } // namespace Mantid
@@ -15,6 +15,7 @@
 #include "MantidAPI/MatrixWorkspace_fwd.h"
 #include "MantidAPI/MultiDomainFunction.h"
 #include "MantidAlgorithms/DllConfig.h"
+#include "MantidAlgorithms/PeakWindowFitter.h"
 #include "MantidDataObjects/EventWorkspace.h"
 #include "MantidDataObjects/TableWorkspace.h"
 #include "MantidKernel/cow_ptr.h"
@@ -278,6 +279,10 @@ private:
   bool m_fitPeaksFromRight;
   /// Fit iterations
   int m_fitIterations;
+  /// Fit the peaks with PeakWindowFitter instead of the Fit algorithm
+  bool m_fastFit;
+  /// Fitter of each thread, if m_fastFit
+  std::vector<FitPeaksAlgorithm::PeakWindowFitter> m_windowFitters;
 
   //-------- Input param init values --------------------------------
   /// input starting parameters' indexes in peak function
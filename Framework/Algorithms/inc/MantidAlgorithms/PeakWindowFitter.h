@@ -0,0 +1,87 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2020 ISIS Rutherford Appleton Laboratory UKRI,
+//   NScD Oak Ridge National Laboratory, European Spallation Source,
+//   Institut Laue - Langevin & CSNS, Institute of High Energy Physics, CAS
+// SPDX - License - Identifier: GPL - 3.0 +
+#pragma once
+
+#include "MantidAPI/FunctionValues.h"
+#include "MantidAPI/IFunction.h"
+#include "MantidAlgorithms/DllConfig.h"
+
+#include <vector>
+
+namespace Mantid {
+namespace HistogramData {
+class Histogram;
+} // namespace HistogramData
+
+namespace Algorithms {
+namespace FitPeaksAlgorithm {
+
+/** PeakWindowFitter : a light-weight Levenberg-Marquardt least squares fit of
+  a function to a window of a spectrum.
+
+  FitPeaks fits thousands of small windows with the same function form. Running
+  the Fit algorithm for each of them is dominated by setting properties,
+  creating the domain and allocating the minimizer. This fitter keeps its data,
+  Jacobian and normal equations between fits and works on the function
+  directly. It reproduces the Fit algorithm with the Levenberg-Marquardt
+  minimizer, the Least squares cost function and CalcErrors: points are
+  weighted by their inverse errors (1 for zero errors), bin centres are used
+  for histograms, and tied or fixed parameters are left alone. Constraints are
+  not applied: functions with constraints must be fitted with Fit.
+
+  A fitter is not thread-safe: use one per thread.
+*/
+class MANTID_ALGORITHMS_DLL PeakWindowFitter {
+public:
+  explicit PeakWindowFitter(const size_t maxIterations = 50);
+
+  double fit(API::IFunction &function,
+             const HistogramData::Histogram &histogram, const double startX,
+             const double endX);
+
+  /// Return the number of iterations of the last fit
+  size_t getNumberIterations() const { return m_iterations; }
+  /// Return the number of data points of the last fit
+  size_t getNumberPoints() const { return m_x.size(); }
+
+private:
+  bool setData(const HistogramData::Histogram &histogram, const double startX,
+               const double endX);
+  double evaluate(API::IFunction &function, const bool withDerivatives);
+  bool solve(const double lambda);
+  void setErrors(API::IFunction &function);
+  double transformDerivative(API::IFunction &function, const size_t i) const;
+
+  /// Maximum number of iterations
+  size_t m_maxIterations;
+  /// Number of iterations of the last fit
+  size_t m_iterations;
+  /// X values of the points in the window
+  std::vector<double> m_x;
+  /// Y values of the points in the window
+  std::vector<double> m_y;
+  /// Fit weights of the points in the window
+  std::vector<double> m_weights;
+  /// Calculated values of the function
+  API::FunctionValues m_values;
+  /// Indices of the active parameters
+  std::vector<size_t> m_active;
+  /// Derivatives of the function by all parameters, row major
+  std::vector<double> m_jacobian;
+  /// Weighted normal matrix J^T W^2 J of the active parameters
+  std::vector<double> m_hessian;
+  /// Weighted gradient J^T W^2 (y - f) of the active parameters
+  std::vector<double> m_gradient;
+  /// Step of the active parameters, in their active values
+  std::vector<double> m_step;
+  /// Work matrix for solving the damped normal equations
+  std::vector<double> m_work;
+};
+
+} // namespace FitPeaksAlgorithm
+} // namespace Algorithms
+} // namespace Mantid
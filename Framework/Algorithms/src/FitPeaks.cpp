@@ -29,6 +29,7 @@
 #include "MantidKernel/BoundedValidator.h"
 #include "MantidKernel/IValidator.h"
 #include "MantidKernel/ListValidator.h"
+#include "MantidKernel/MultiThreaded.h"
 #include "MantidKernel/StartsWithValidator.h"
 
 #include "boost/algorithm/string.hpp"
@@ -67,6 +68,7 @@ const std::string FIT_FROM_RIGHT("FitFromRight");
 const std::string MINIMIZER("Minimizer");
 const std::string COST_FUNC("CostFunction");
 const std::string MAX_FIT_ITER("MaxFitIterations");
+const std::string FAST_FIT("FastFit");
 const std::string BACKGROUND_Z_SCORE("FindBackgroundSigma");
 const std::string HIGH_BACKGROUND("HighBackground");
 const std::string POSITION_TOL("PositionTolerance");
@@ -78,6 +80,15 @@ const std::string OUTPUT_WKSP_PARAM_ERRS("OutputParameterFitErrorsWorkspace");
 const std::string RAW_PARAMS("RawPeakParameters");
 
 } // namespace PropertyNames
+
+/// Does any parameter of the function have a constraint?
+bool hasConstraints(const API::IFunction &function) {
+  for (size_t i = 0; i < function.nParams(); ++i) {
+    if (function.getConstraint(i))
+      return true;
+  }
+  return false;
+}
 } // namespace
 
 namespace FitPeaksAlgorithm {
@@ -232,7 +243,8 @@ enum PeakFitResult { NOSIGNAL, LOWPEAK, OUTOFBOUND, GOOD };
 
 //----------------------------------------------------------------------------------------------
 FitPeaks::FitPeaks()
-    : m_fitPeaksFromRight(true), m_fitIterations(50), m_numPeaksToFit(0),
+    : m_fitPeaksFromRight(true), m_fitIterations(50), m_fastFit(false),
+      m_numPeaksToFit(0),
       m_minPeakHeight(20.), m_bkgdSimga(1.), m_peakPosTolCase234(false) {}
 
 //----------------------------------------------------------------------------------------------
@@ -357,9 +369,18 @@ void FitPeaks::init() {
   declareProperty(PropertyNames::MAX_FIT_ITER, 50, min_max_iter,
                   "Maximum number of function fitting iterations.");
 
+  declareProperty(
+      PropertyNames::FAST_FIT, false,
+      "If true, the peaks are fitted by a built-in least squares fitter "
+      "instead of running the Fit algorithm for each peak, which is much "
+      "faster for many small peaks. Only used with the Levenberg-Marquardt "
+      "minimizers, the Least squares cost function and without peak "
+      "position constraints.");
+
   const std::string optimizergrp("Optimization Setup");
   setPropertyGroup(PropertyNames::MINIMIZER, optimizergrp);
   setPropertyGroup(PropertyNames::COST_FUNC, optimizergrp);
+  setPropertyGroup(PropertyNames::FAST_FIT, optimizergrp);
 
   // other helping information
   declareProperty(
@@ -562,6 +583,16 @@ void FitPeaks::processInputs() {
   m_fitPeaksFromRight = getProperty(PropertyNames::FIT_FROM_RIGHT);
   m_constrainPeaksPosition = getProperty(PropertyNames::CONSTRAIN_PEAK_POS);
   m_fitIterations = getProperty(PropertyNames::MAX_FIT_ITER);
+  m_fastFit = getProperty(PropertyNames::FAST_FIT);
+  if (m_fastFit && ((m_minimizer != "Levenberg-Marquardt" &&
+                     m_minimizer != "Levenberg-MarquardtMD") ||
+                    m_costFunction != "Least squares" ||
+                    m_constrainPeaksPosition)) {
+    g_log.warning("FastFit is only used with the Levenberg-Marquardt "
+                  "minimizers, the Least squares cost function and without "
+                  "peak position constraints. The Fit algorithm is used.");
+    m_fastFit = false;
+  }
 
   // Peak centers, tolerance and fitting range
   processInputPeakCenters();
@@ -582,6 +613,14 @@ void FitPeaks::processInputs() {
 
   // Set up peak and background functions
   processInputFunctions();
+  // PeakWindowFitter does not apply the constraints of the functions, such
+  // as the mixing of a PseudoVoigt
+  if (m_fastFit &&
+      (hasConstraints(*m_peakFunction) || hasConstraints(*m_bkgdFunction))) {
+    g_log.warning("FastFit is not used with constrained peak or background "
+                  "functions. The Fit algorithm is used.");
+    m_fastFit = false;
+  }
 
   // about peak width and other peak parameter estimating method
   if (m_peakWidthPercentage > 0.)
@@ -938,6 +977,13 @@ FitPeaks::fitPeaks() {
   std::vector<std::shared_ptr<FitPeaksAlgorithm::PeakFitResult>>
       fit_result_vector(num_fit_result);
 
+  // one fitter per thread, reused for all of the peaks it fits
+  if (m_fastFit)
+    m_windowFitters.assign(
+        PARALLEL_GET_MAX_THREADS,
+        FitPeaksAlgorithm::PeakWindowFitter(
+            static_cast<size_t>(m_fitIterations)));
+
   // cppcheck-suppress syntaxError
   PRAGMA_OMP(parallel for schedule(dynamic, 1) )
   for (auto wi = static_cast<int>(m_startWorkspaceIndex);
@@ -1032,15 +1078,23 @@ void FitPeaks::fitSpectrumPeaks(
     return; // don't do anything
   }
 
-  // Set up sub algorithm Fit for peak and background
+  // Set up sub algorithm Fit for peak and background, unless the peaks are
+  // fitted by the built-in fitter
   IAlgorithm_sptr peak_fitter; // both peak and background (combo)
-  try {
-    peak_fitter = createChildAlgorithm("Fit", -1, -1, false);
-  } catch (Exception::NotFoundError &) {
-    std::stringstream errss;
-    errss << "The FitPeak algorithm requires the CurveFitting library";
-    g_log.error(errss.str());
-    throw std::runtime_error(errss.str());
+  if (!m_fastFit) {
+    try {
+      peak_fitter = createChildAlgorithm("Fit", -1, -1, false);
+    } catch (Exception::NotFoundError &) {
+      std::stringstream errss;
+      errss << "The FitPeak algorithm requires the CurveFitting library";
+      g_log.error(errss.str());
+      throw std::runtime_error(errss.str());
+    }
+
+    // set up properties of algorithm (reference) 'Fit'
+    peak_fitter->setProperty("Minimizer", m_minimizer);
+    peak_fitter->setProperty("CostFunction", m_costFunction);
+    peak_fitter->setProperty("CalcErrors", true);
   }
 
   // Clone the function
@@ -1050,11 +1104,6 @@ void FitPeaks::fitSpectrumPeaks(
       std::dynamic_pointer_cast<API::IBackgroundFunction>(
           m_bkgdFunction->clone());
 
-  // set up properties of algorithm (reference) 'Fit'
-  peak_fitter->setProperty("Minimizer", m_minimizer);
-  peak_fitter->setProperty("CostFunction", m_costFunction);
-  peak_fitter->setProperty("CalcErrors", true);
-
   // store the peak fit parameters once one works
   bool foundAnyPeak = false;
   std::vector<double> lastGoodPeakParameters(peakfunction->nParams(), 0.);
@@ -1728,6 +1777,12 @@ double FitPeaks::fitFunctionSD(
   comp_func->addFunction(bkgd_function);
   IFunction_sptr fitfunc = std::dynamic_pointer_cast<IFunction>(comp_func);
 
+  if (m_fastFit) {
+    // the peak and background functions are fitted in place
+    auto &fitter = m_windowFitters[PARALLEL_THREAD_NUMBER];
+    return fitter.fit(*comp_func, dataws->histogram(wsindex), xmin, xmax);
+  }
+
   // Set the properties
   fit->setProperty("Function", fitfunc);
   fit->setProperty("InputWorkspace", dataws);
@@ -0,0 +1,341 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2020 ISIS Rutherford Appleton Laboratory UKRI,
+//   NScD Oak Ridge National Laboratory, European Spallation Source,
+//   Institut Laue - Langevin & CSNS, Institute of High Energy Physics, CAS
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidAlgorithms/PeakWindowFitter.h"
+#include "MantidAPI/FunctionDomain1D.h"
+#include "MantidAPI/Jacobian.h"
+#include "MantidHistogramData/Histogram.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace Mantid {
+namespace Algorithms {
+namespace FitPeaksAlgorithm {
+
+namespace {
+/// Tolerance of the convergence test on the steps, as in the Fit algorithm
+constexpr double STEP_TOLERANCE = 1e-4;
+/// Starting damping of the Levenberg-Marquardt steps
+constexpr double INITIAL_DAMPING = 1e-3;
+/// Damping above which no step can decrease the cost any more
+constexpr double MAX_DAMPING = 1e10;
+
+/// A Jacobian writing into a row major array
+class ArrayJacobian : public API::Jacobian {
+public:
+  ArrayJacobian(std::vector<double> &data, const size_t numParams)
+      : m_data(data), m_numParams(numParams) {}
+  void set(size_t iY, size_t iP, double value) override {
+    m_data[iY * m_numParams + iP] = value;
+  }
+  double get(size_t iY, size_t iP) override {
+    return m_data[iY * m_numParams + iP];
+  }
+  void zero() override { std::fill(m_data.begin(), m_data.end(), 0.); }
+
+private:
+  std::vector<double> &m_data;
+  const size_t m_numParams;
+};
+
+/** Cholesky decomposition of a symmetric matrix, in place
+ * @param a :: n x n row major matrix, replaced by its lower triangular factor
+ * @param n :: size of the matrix
+ * @return false if the matrix is not positive definite
+ */
+bool choleskyDecompose(std::vector<double> &a, const size_t n) {
+  for (size_t j = 0; j < n; ++j) {
+    double diagonal = a[j * n + j];
+    for (size_t k = 0; k < j; ++k)
+      diagonal -= a[j * n + k] * a[j * n + k];
+    if (!(diagonal > 0.))
+      return false;
+    diagonal = std::sqrt(diagonal);
+    a[j * n + j] = diagonal;
+    for (size_t i = j + 1; i < n; ++i) {
+      double value = a[i * n + j];
+      for (size_t k = 0; k < j; ++k)
+        value -= a[i * n + k] * a[j * n + k];
+      a[i * n + j] = value / diagonal;
+    }
+  }
+  return true;
+}
+
+/** Solve L L^T x = b given the Cholesky factor L
+ * @param l :: n x n row major lower triangular factor
+ * @param n :: size of the matrix
+ * @param b :: the right hand side, replaced by the solution
+ */
+void choleskySolve(const std::vector<double> &l, const size_t n,
+                   std::vector<double> &b) {
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t k = 0; k < i; ++k)
+      b[i] -= l[i * n + k] * b[k];
+    b[i] /= l[i * n + i];
+  }
+  for (size_t i = n; i-- > 0;) {
+    for (size_t k = i + 1; k < n; ++k)
+      b[i] -= l[k * n + i] * b[k];
+    b[i] /= l[i * n + i];
+  }
+}
+} // namespace
+
+/** Constructor
+ * @param maxIterations :: maximum number of iterations of a fit
+ */
+PeakWindowFitter::PeakWindowFitter(const size_t maxIterations)
+    : m_maxIterations(maxIterations), m_iterations(0) {}
+
+/** Fit a function to the points of a histogram within a window. If the fit
+ * converged, the parameters of the function are set to the fitted values and
+ * their errors are set. Otherwise the parameters are left at their starting
+ * values.
+ * @param function :: the function to fit, with its starting parameters
+ * @param histogram :: the data, with x in ascending order
+ * @param startX :: start of the window
+ * @param endX :: end of the window
+ * @return the chi squared divided by the degrees of freedom, or DBL_MAX if
+ * the window holds no data or the fit did not converge
+ */
+double PeakWindowFitter::fit(API::IFunction &function,
+                             const HistogramData::Histogram &histogram,
+                             const double startX, const double endX) {
+  m_iterations = 0;
+  if (!setData(histogram, startX, endX))
+    return DBL_MAX;
+
+  m_active.clear();
+  for (size_t i = 0; i < function.nParams(); ++i) {
+    if (function.isActive(i))
+      m_active.emplace_back(i);
+  }
+  const size_t numActive = m_active.size();
+  const size_t numPoints = m_x.size();
+  const double dof =
+      numPoints > numActive ? static_cast<double>(numPoints - numActive) : 1.;
+
+  // The starting parameters, to put back if the fit fails
+  std::vector<double> start(function.nParams());
+  for (size_t i = 0; i < start.size(); ++i)
+    start[i] = function.getParameter(i);
+  const auto restoreStart = [&function, &start]() {
+    for (size_t i = 0; i < start.size(); ++i)
+      function.setParameter(i, start[i], function.isExplicitlySet(i));
+    return DBL_MAX;
+  };
+
+  function.applyTies();
+  double chi2 = evaluate(function, true);
+  if (!std::isfinite(chi2))
+    return restoreStart();
+
+  std::vector<double> previous(numActive);
+  double lambda = INITIAL_DAMPING;
+  bool converged = numActive == 0;
+  while (!converged && m_iterations < m_maxIterations) {
+    ++m_iterations;
+    // Increase the damping until a step decreases the cost
+    bool improved = false;
+    while (!improved && lambda < MAX_DAMPING) {
+      if (!solve(lambda)) {
+        lambda *= 10.;
+        continue;
+      }
+      for (size_t a = 0; a < numActive; ++a) {
+        previous[a] = function.activeParameter(m_active[a]);
+        function.setActiveParameter(m_active[a], previous[a] + m_step[a]);
+      }
+      function.applyTies();
+      const double trial = evaluate(function, false);
+      if (trial <= chi2) {
+        chi2 = trial;
+        lambda = std::max(lambda / 10., DBL_EPSILON);
+        improved = true;
+      } else {
+        for (size_t a = 0; a < numActive; ++a)
+          function.setActiveParameter(m_active[a], previous[a]);
+        function.applyTies();
+        lambda *= 10.;
+      }
+    }
+    if (!improved)
+      break;
+
+    converged = true;
+    for (size_t a = 0; a < numActive; ++a) {
+      const double value = function.activeParameter(m_active[a]);
+      converged = converged && std::fabs(m_step[a]) <
+                                   STEP_TOLERANCE * (1. + std::fabs(value));
+    }
+    evaluate(function, true);
+  }
+  if (!converged)
+    return restoreStart();
+
+  setErrors(function);
+  return chi2 / dof;
+}
+
+/** Copy the points of a histogram within a window, with their weights
+ * @param histogram :: the data
+ * @param startX :: start of the window
+ * @param endX :: end of the window
+ * @return false if the window holds no points
+ */
+bool PeakWindowFitter::setData(const HistogramData::Histogram &histogram,
+                               const double startX, const double endX) {
+  m_x.clear();
+  m_y.clear();
+  m_weights.clear();
+  const auto &x = histogram.x();
+  if (x.empty())
+    return false;
+  const auto from = std::lower_bound(x.cbegin(), x.cend(),
+                                     std::min(startX, endX));
+  auto to = std::upper_bound(from, x.cend(), std::max(startX, endX));
+  if (from == to)
+    return false;
+  const bool isHistogram =
+      histogram.xMode() == HistogramData::Histogram::XMode::BinEdges;
+  if (isHistogram && to == x.cend())
+    --to;
+
+  const auto &y = histogram.y();
+  const auto &e = histogram.e();
+  for (auto i = static_cast<size_t>(from - x.cbegin());
+       i < static_cast<size_t>(to - x.cbegin()); ++i) {
+    m_x.emplace_back(isHistogram ? 0.5 * (x[i] + x[i + 1]) : x[i]);
+    double value = y[i];
+    double weight = 0.;
+    if (!std::isfinite(value)) {
+      value = 0.;
+    } else if (std::isfinite(e[i])) {
+      weight = e[i] <= 0. ? 1. : 1. / e[i];
+      if (!std::isfinite(weight))
+        weight = 0.;
+    }
+    m_y.emplace_back(value);
+    m_weights.emplace_back(weight);
+  }
+  return !m_x.empty();
+}
+
+/** Calculate the function and the weighted chi squared. Optionally calculate
+ * the derivatives and the normal equations.
+ * @param function :: the function being fitted
+ * @param withDerivatives :: if true, calculate the derivatives
+ * @return the weighted chi squared
+ */
+double PeakWindowFitter::evaluate(API::IFunction &function,
+                                  const bool withDerivatives) {
+  const size_t numPoints = m_x.size();
+  API::FunctionDomain1DView domain(m_x.data(), numPoints);
+  m_values.reset(domain);
+  function.function(domain, m_values);
+  double chi2 = 0.;
+  for (size_t i = 0; i < numPoints; ++i) {
+    const double residual = (m_y[i] - m_values.getCalculated(i)) * m_weights[i];
+    chi2 += residual * residual;
+  }
+  if (!withDerivatives)
+    return std::isfinite(chi2) ? chi2 : DBL_MAX;
+
+  const size_t numParams = function.nParams();
+  const size_t numActive = m_active.size();
+  m_jacobian.assign(numPoints * numParams, 0.);
+  ArrayJacobian jacobian(m_jacobian, numParams);
+  function.functionDeriv(domain, jacobian);
+  m_hessian.assign(numActive * numActive, 0.);
+  m_gradient.assign(numActive, 0.);
+  for (size_t i = 0; i < numPoints; ++i) {
+    const double weightSquared = m_weights[i] * m_weights[i];
+    if (weightSquared == 0.)
+      continue;
+    const double residual = m_y[i] - m_values.getCalculated(i);
+    const double *derivatives = m_jacobian.data() + i * numParams;
+    for (size_t a = 0; a < numActive; ++a) {
+      const double da = derivatives[m_active[a]] * weightSquared;
+      m_gradient[a] += da * residual;
+      for (size_t b = 0; b <= a; ++b)
+        m_hessian[a * numActive + b] += da * derivatives[m_active[b]];
+    }
+  }
+  for (size_t a = 0; a < numActive; ++a) {
+    for (size_t b = 0; b < a; ++b)
+      m_hessian[b * numActive + a] = m_hessian[a * numActive + b];
+  }
+  return std::isfinite(chi2) ? chi2 : DBL_MAX;
+}
+
+/** Solve the damped normal equations for the step of the active parameters
+ * @param lambda :: the damping, relative to the diagonal of the normal matrix
+ * @return false if the equations cannot be solved
+ */
+bool PeakWindowFitter::solve(const double lambda) {
+  const size_t numActive = m_active.size();
+  m_work = m_hessian;
+  for (size_t a = 0; a < numActive; ++a) {
+    double &diagonal = m_work[a * numActive + a];
+    diagonal += lambda * (diagonal > 0. ? diagonal : 1.);
+  }
+  if (!choleskyDecompose(m_work, numActive))
+    return false;
+  m_step = m_gradient;
+  choleskySolve(m_work, numActive, m_step);
+  return std::all_of(m_step.cbegin(), m_step.cend(),
+                     [](const double step) { return std::isfinite(step); });
+}
+
+/** Set the errors of the parameters from the inverse of the normal matrix.
+ * The normal matrix is in the active parameters, so the errors are scaled by
+ * the derivative of each declared parameter by its active value, like the
+ * transformation of the covariance matrix in CostFuncFitting. The errors of
+ * parameters that are not fitted are set to 0.
+ * @param function :: the fitted function
+ */
+void PeakWindowFitter::setErrors(API::IFunction &function) {
+  for (size_t i = 0; i < function.nParams(); ++i)
+    function.setError(i, 0.);
+  const size_t numActive = m_active.size();
+  m_work = m_hessian;
+  if (!choleskyDecompose(m_work, numActive))
+    return;
+  for (size_t a = 0; a < numActive; ++a) {
+    m_step.assign(numActive, 0.);
+    m_step[a] = 1.;
+    choleskySolve(m_work, numActive, m_step);
+    const size_t i = m_active[a];
+    function.setError(i, std::fabs(transformDerivative(function, i)) *
+                             std::sqrt(m_step[a]));
+  }
+}
+
+/** Calculate the derivative of a declared parameter by its active value
+ * numerically. It is 1 where the two are the same.
+ * @param function :: the fitted function
+ * @param i :: index of an active parameter
+ * @return the derivative
+ */
+double PeakWindowFitter::transformDerivative(API::IFunction &function,
+                                             const size_t i) const {
+  const double declared = function.getParameter(i);
+  const double active = function.activeParameter(i);
+  if (active == declared)
+    return 1.;
+  const double step = active == 0. ? 1e-8 : active * 1e-8;
+  function.setActiveParameter(i, active + step);
+  const double derivative = (function.getParameter(i) - declared) / step;
+  function.setParameter(i, declared, false);
+  return derivative;
+}
+
+} // namespace FitPeaksAlgorithm
+} // namespace Algorithms
+} // namespace Mantid
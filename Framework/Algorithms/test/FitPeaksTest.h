@@ -244,6 +244,119 @@ public:
     AnalysisDataService::Instance().remove("PeakParametersWS");
   }
 
+  //----------------------------------------------------------------------------------------------
+  /** Test fitting multiple peaks in multiple spectra with the built-in fitter
+   */
+  void test_multiPeaksMultiSpectra_FastFit() {
+    std::vector<string> peakparnames;
+    std::vector<double> peakparvalues;
+    createGuassParameters(peakparnames, peakparvalues);
+    createTestData(m_inputWorkspaceName);
+
+    FitPeaks fitpeaks;
+    fitpeaks.initialize();
+    fitpeaks.setProperty("InputWorkspace", m_inputWorkspaceName);
+    fitpeaks.setProperty("StartWorkspaceIndex", 0);
+    fitpeaks.setProperty("StopWorkspaceIndex", 2);
+    fitpeaks.setProperty("PeakCenters", "5.0, 10.0");
+    fitpeaks.setProperty("FitWindowBoundaryList", "2.5, 6.5, 8.0, 12.0");
+    fitpeaks.setProperty("FitFromRight", true);
+    fitpeaks.setProperty("PeakParameterNames", peakparnames);
+    fitpeaks.setProperty("PeakParameterValues", peakparvalues);
+    fitpeaks.setProperty("HighBackground", false);
+    fitpeaks.setProperty("ConstrainPeakPositions", false);
+    fitpeaks.setProperty("FastFit", true);
+    fitpeaks.setProperty("OutputWorkspace", "PeakPositionsWS");
+    fitpeaks.setProperty("OutputPeakParametersWorkspace", "PeakParametersWS");
+    fitpeaks.setProperty("FittedPeaksWorkspace", "FittedPeaksWS");
+
+    fitpeaks.execute();
+    TS_ASSERT(fitpeaks.isExecuted());
+    if (!fitpeaks.isExecuted())
+      return;
+
+    // same results as with the Fit algorithm
+    API::MatrixWorkspace_sptr main_out_ws =
+        std::dynamic_pointer_cast<API::MatrixWorkspace>(
+            AnalysisDataService::Instance().retrieve("PeakPositionsWS"));
+    TS_ASSERT(main_out_ws);
+    const auto &fitted_positions_0 = main_out_ws->histogram(0).y();
+    TS_ASSERT_DELTA(fitted_positions_0[0], 5.0, 1.E-5);
+    TS_ASSERT_DELTA(fitted_positions_0[1], 10.0, 1.E-5);
+    const auto &fitted_positions_2 = main_out_ws->histogram(2).y();
+    TS_ASSERT_DELTA(fitted_positions_2[0], 5.03, 1.E-5);
+    TS_ASSERT_DELTA(fitted_positions_2[1], 10.02, 1.E-5);
+
+    API::ITableWorkspace_sptr param_ws =
+        std::dynamic_pointer_cast<API::ITableWorkspace>(
+            AnalysisDataService::Instance().retrieve("PeakParametersWS"));
+    TS_ASSERT(param_ws);
+    TS_ASSERT_DELTA(param_ws->cell<double>(2, 2), 4., 1E-5);
+    TS_ASSERT_DELTA(param_ws->cell<double>(2, 4), 0.17, 1E-5);
+    TS_ASSERT_DELTA(param_ws->cell<double>(3, 2), 2., 1E-5);
+    TS_ASSERT_DELTA(param_ws->cell<double>(3, 4), 0.12, 1E-5);
+
+    // clean up
+    AnalysisDataService::Instance().remove(m_inputWorkspaceName);
+    AnalysisDataService::Instance().remove("PeakPositionsWS");
+    AnalysisDataService::Instance().remove("FittedPeaksWS");
+    AnalysisDataService::Instance().remove("PeakParametersWS");
+  }
+
+  //----------------------------------------------------------------------------------------------
+  /** The built-in fitter does not apply constraints, so peak functions with
+   * constraints are fitted with the Fit algorithm even with FastFit
+   */
+  void test_FastFit_constrainedPeakFunction() {
+    createTestData(m_inputWorkspaceName);
+
+    auto fitPseudoVoigt = [this](const bool fastFit,
+                                 const std::string &paramWSName) {
+      FitPeaks fitpeaks;
+      fitpeaks.initialize();
+      fitpeaks.setProperty("InputWorkspace", m_inputWorkspaceName);
+      fitpeaks.setProperty("StartWorkspaceIndex", 0);
+      fitpeaks.setProperty("StopWorkspaceIndex", 2);
+      fitpeaks.setProperty("PeakFunction", "PseudoVoigt");
+      fitpeaks.setProperty("PeakCenters", "5.0, 10.0");
+      fitpeaks.setProperty("FitWindowBoundaryList", "2.5, 6.5, 8.0, 12.0");
+      fitpeaks.setProperty("HighBackground", false);
+      fitpeaks.setProperty("ConstrainPeakPositions", false);
+      fitpeaks.setProperty("FastFit", fastFit);
+      fitpeaks.setProperty("OutputWorkspace", "PeakPositionsWS");
+      fitpeaks.setProperty("OutputPeakParametersWorkspace", paramWSName);
+      fitpeaks.setProperty("FittedPeaksWorkspace", "FittedPeaksWS");
+      fitpeaks.execute();
+      TS_ASSERT(fitpeaks.isExecuted());
+      return AnalysisDataService::Instance().retrieveWS<API::ITableWorkspace>(
+          paramWSName);
+    };
+    const auto fitParams = fitPseudoVoigt(false, "PeakParametersWS");
+    const auto fastParams = fitPseudoVoigt(true, "FastPeakParametersWS");
+
+    TS_ASSERT_EQUALS(fastParams->rowCount(), fitParams->rowCount());
+    TS_ASSERT_EQUALS(fastParams->columnCount(), fitParams->columnCount());
+    for (size_t col = 0; col < fitParams->columnCount(); ++col) {
+      if (fitParams->getColumn(col)->type() != "double")
+        continue;
+      for (size_t row = 0; row < fitParams->rowCount(); ++row)
+        TS_ASSERT_EQUALS(fastParams->cell<double>(row, col),
+                         fitParams->cell<double>(row, col));
+    }
+    const auto mixing = fastParams->getColumn("Mixing");
+    for (size_t row = 0; row < fastParams->rowCount(); ++row) {
+      TS_ASSERT_LESS_THAN_EQUALS(0., mixing->toDouble(row));
+      TS_ASSERT_LESS_THAN_EQUALS(mixing->toDouble(row), 1.);
+    }
+
+    // clean up
+    AnalysisDataService::Instance().remove(m_inputWorkspaceName);
+    AnalysisDataService::Instance().remove("PeakPositionsWS");
+    AnalysisDataService::Instance().remove("FittedPeaksWS");
+    AnalysisDataService::Instance().remove("PeakParametersWS");
+    AnalysisDataService::Instance().remove("FastPeakParametersWS");
+  }
+
   //----------------------------------------------------------------------------------------------
   /** Test output of effective peak parameters
    * @brief test_effectivePeakParameters
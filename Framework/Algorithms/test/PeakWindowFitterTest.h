@@ -0,0 +1,232 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2020 ISIS Rutherford Appleton Laboratory UKRI,
+//   NScD Oak Ridge National Laboratory, European Spallation Source,
+//   Institut Laue - Langevin & CSNS, Institute of High Energy Physics, CAS
+// SPDX - License - Identifier: GPL - 3.0 +
+#pragma once
+
+#include "MantidAPI/CompositeFunction.h"
+#include "MantidAPI/IFunction1D.h"
+#include "MantidAPI/ParamFunction.h"
+#include "MantidAlgorithms/PeakWindowFitter.h"
+#include "MantidHistogramData/Histogram.h"
+
+#include <cxxtest/TestSuite.h>
+
+#include <cfloat>
+#include <cmath>
+
+using namespace Mantid::API;
+using namespace Mantid::HistogramData;
+using Mantid::Algorithms::FitPeaksAlgorithm::PeakWindowFitter;
+
+namespace {
+/// Gaussian without analytic derivatives
+class PeakWindowFitterTest_Gauss : public ParamFunction, public IFunction1D {
+public:
+  PeakWindowFitterTest_Gauss() {
+    declareParameter("Height");
+    declareParameter("Centre");
+    declareParameter("Sigma");
+  }
+  std::string name() const override { return "PeakWindowFitterTest_Gauss"; }
+  void function1D(double *out, const double *xValues,
+                  const size_t nData) const override {
+    const double height = getParameter(0);
+    const double centre = getParameter(1);
+    const double sigma = getParameter(2);
+    for (size_t i = 0; i < nData; ++i) {
+      const double x = (xValues[i] - centre) / sigma;
+      out[i] = height * std::exp(-0.5 * x * x);
+    }
+  }
+};
+
+class PeakWindowFitterTest_Linear : public ParamFunction, public IFunction1D {
+public:
+  PeakWindowFitterTest_Linear() {
+    declareParameter("A0");
+    declareParameter("A1");
+  }
+  std::string name() const override { return "PeakWindowFitterTest_Linear"; }
+  void function1D(double *out, const double *xValues,
+                  const size_t nData) const override {
+    for (size_t i = 0; i < nData; ++i)
+      out[i] = getParameter(0) + getParameter(1) * xValues[i];
+  }
+  void functionDeriv1D(Jacobian *out, const double *xValues,
+                       const size_t nData) override {
+    for (size_t i = 0; i < nData; ++i) {
+      out->set(i, 0, 1.);
+      out->set(i, 1, xValues[i]);
+    }
+  }
+};
+
+/// Straight line fitted with twice the slope as the active parameter
+class PeakWindowFitterTest_ScaledLinear : public PeakWindowFitterTest_Linear {
+public:
+  std::string name() const override {
+    return "PeakWindowFitterTest_ScaledLinear";
+  }
+  void functionDeriv1D(Jacobian *out, const double *xValues,
+                       const size_t nData) override {
+    for (size_t i = 0; i < nData; ++i) {
+      out->set(i, 0, 1.);
+      out->set(i, 1, 0.5 * xValues[i]);
+    }
+  }
+  double activeParameter(size_t i) const override {
+    return i == 1 ? 2. * getParameter(1) : getParameter(i);
+  }
+  void setActiveParameter(size_t i, double value) override {
+    setParameter(i, i == 1 ? 0.5 * value : value, false);
+  }
+};
+
+/// Points with unit errors
+Histogram makeHistogram(const std::vector<double> &x,
+                        const std::vector<double> &y) {
+  return Histogram(Points(x), Counts(y),
+                   CountStandardDeviations(std::vector<double>(y.size(), 1.)));
+}
+} // namespace
+
+class PeakWindowFitterTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static PeakWindowFitterTest *createSuite() {
+    return new PeakWindowFitterTest();
+  }
+  static void destroySuite(PeakWindowFitterTest *suite) { delete suite; }
+
+  void test_peak_on_background() {
+    std::vector<double> x, y;
+    for (size_t i = 0; i < 200; ++i) {
+      x.emplace_back(0.05 * double(i));
+      const double peak = (x.back() - 5.2) / 0.3;
+      y.emplace_back(10. * std::exp(-0.5 * peak * peak) + 2. - 0.1 * x.back());
+    }
+    auto peak = std::make_shared<PeakWindowFitterTest_Gauss>();
+    peak->initialize();
+    peak->setParameter("Height", 8.);
+    peak->setParameter("Centre", 5.);
+    peak->setParameter("Sigma", 0.4);
+    auto background = std::make_shared<PeakWindowFitterTest_Linear>();
+    background->initialize();
+    CompositeFunction function;
+    function.addFunction(peak);
+    function.addFunction(background);
+
+    PeakWindowFitter fitter;
+    const double chi2 = fitter.fit(function, makeHistogram(x, y), 2.99, 7.01);
+    TS_ASSERT_DELTA(chi2, 0., 1e-8);
+    TS_ASSERT_EQUALS(fitter.getNumberPoints(), 81);
+    TS_ASSERT_LESS_THAN(0, fitter.getNumberIterations());
+    TS_ASSERT_DELTA(peak->getParameter("Height"), 10., 1e-5);
+    TS_ASSERT_DELTA(peak->getParameter("Centre"), 5.2, 1e-5);
+    TS_ASSERT_DELTA(peak->getParameter("Sigma"), 0.3, 1e-5);
+    TS_ASSERT_DELTA(background->getParameter("A0"), 2., 1e-5);
+    TS_ASSERT_DELTA(background->getParameter("A1"), -0.1, 1e-5);
+  }
+
+  void test_parameters_are_restored_if_the_fit_does_not_converge() {
+    std::vector<double> x, y;
+    for (size_t i = 0; i < 200; ++i) {
+      x.emplace_back(0.05 * double(i));
+      const double peak = (x.back() - 5.2) / 0.3;
+      y.emplace_back(10. * std::exp(-0.5 * peak * peak));
+    }
+    PeakWindowFitterTest_Gauss function;
+    function.initialize();
+    function.setParameter("Height", 8.);
+    function.setParameter("Centre", 5.);
+    function.setParameter("Sigma", 0.4);
+
+    PeakWindowFitter fitter(1);
+    TS_ASSERT_EQUALS(fitter.fit(function, makeHistogram(x, y), 2.99, 7.01),
+                     DBL_MAX);
+    TS_ASSERT_EQUALS(fitter.getNumberIterations(), 1);
+    TS_ASSERT_EQUALS(function.getParameter("Height"), 8.);
+    TS_ASSERT_EQUALS(function.getParameter("Centre"), 5.);
+    TS_ASSERT_EQUALS(function.getParameter("Sigma"), 0.4);
+  }
+
+  void test_errors_of_a_straight_line() {
+    // Var(A0) = sum(x^2) / D, Var(A1) = n / D with D = n sum(x^2) - sum(x)^2
+    std::vector<double> x, y;
+    for (size_t i = 0; i < 10; ++i) {
+      x.emplace_back(double(i));
+      y.emplace_back(1. + 2. * double(i) + (i % 2 == 0 ? 0.5 : -0.5));
+    }
+    PeakWindowFitterTest_Linear function;
+    function.initialize();
+    PeakWindowFitter fitter;
+    const double chi2 = fitter.fit(function, makeHistogram(x, y), 0., 9.);
+    TS_ASSERT_LESS_THAN(chi2, DBL_MAX);
+    TS_ASSERT_DELTA(function.getError(0), std::sqrt(285. / 825.), 1e-6);
+    TS_ASSERT_DELTA(function.getError(1), std::sqrt(10. / 825.), 1e-6);
+  }
+
+  void test_steps_and_errors_of_transformed_parameters() {
+    std::vector<double> x, y;
+    for (size_t i = 0; i < 10; ++i) {
+      x.emplace_back(double(i));
+      y.emplace_back(1. + 2. * double(i) + (i % 2 == 0 ? 0.5 : -0.5));
+    }
+    PeakWindowFitterTest_ScaledLinear function;
+    function.initialize();
+    PeakWindowFitter fitter;
+    const double chi2 = fitter.fit(function, makeHistogram(x, y), 0., 9.);
+    TS_ASSERT_LESS_THAN(chi2, DBL_MAX);
+    TS_ASSERT_DELTA(function.getParameter(1), 2. - 1. / 33., 1e-6);
+    TS_ASSERT_DELTA(function.getError(1), std::sqrt(10. / 825.), 1e-6);
+  }
+
+  void test_fixed_parameters_are_not_fitted() {
+    std::vector<double> x, y;
+    for (size_t i = 0; i < 10; ++i) {
+      x.emplace_back(double(i));
+      y.emplace_back(1. + 2. * double(i));
+    }
+    PeakWindowFitterTest_Linear function;
+    function.initialize();
+    function.setParameter("A1", 3.);
+    function.fix(1);
+    PeakWindowFitter fitter;
+    fitter.fit(function, makeHistogram(x, y), 0., 9.);
+    TS_ASSERT_EQUALS(function.getParameter("A1"), 3.);
+    TS_ASSERT_EQUALS(function.getError(1), 0.);
+    // The mean of y - 3 x
+    TS_ASSERT_DELTA(function.getParameter("A0"), 1. - 4.5, 1e-6);
+  }
+
+  void test_bin_centres_of_histograms() {
+    std::vector<double> edges, y;
+    for (size_t i = 0; i < 11; ++i)
+      edges.emplace_back(double(i));
+    for (size_t i = 0; i < 10; ++i)
+      y.emplace_back(1. + 2. * (double(i) + 0.5));
+    const Histogram histogram(BinEdges(edges), Counts(y),
+                              CountStandardDeviations(y.size(), 1.));
+    PeakWindowFitterTest_Linear function;
+    function.initialize();
+    PeakWindowFitter fitter;
+    fitter.fit(function, histogram, 0., 10.);
+    TS_ASSERT_EQUALS(fitter.getNumberPoints(), 10);
+    TS_ASSERT_DELTA(function.getParameter("A0"), 1., 1e-6);
+    TS_ASSERT_DELTA(function.getParameter("A1"), 2., 1e-6);
+  }
+
+  void test_window_without_data() {
+    PeakWindowFitterTest_Linear function;
+    function.initialize();
+    PeakWindowFitter fitter;
+    TS_ASSERT_EQUALS(
+        fitter.fit(function, makeHistogram({0., 1., 2.}, {1., 1., 1.}), 5.,
+                   6.),
+        DBL_MAX);
+  }
+};
@@ -71,7 +71,8 @@ private:
                                           bool outputCompositeMembers,
                                           bool outputConvolvedMembers,
                                           const API::IFunction_sptr &ifun,
-                                          const InputSpectraToFit &data);
+                                          const InputSpectraToFit &data,
+                                          const std::string &minimizer);
 
   double calculateLogValue(const std::string &logName,
                            const InputSpectraToFit &data);
@@ -80,10 +81,10 @@ private:
   createResultsTable(const std::string &logName,
                      const API::IFunction_sptr &ifunSingle, bool &isDataName);
 
-  void appendTableRow(bool isDataName, API::ITableWorkspace_sptr &result,
-                      const API::IFunction *const ifun,
-                      const InputSpectraToFit &data, double logValue,
-                      double chi2) const;
+  void setTableRow(bool isDataName, API::ITableWorkspace_sptr &result,
+                   size_t rowIndex, const API::IFunction *const ifun,
+                   const InputSpectraToFit &data, double logValue,
+                   double chi2) const;
 
   void finaliseOutputWorkspaces(
       bool createFitOutput,
@@ -125,8 +125,8 @@ public:
   /// Set up the function for a fit.
   void setUpForFit() override;
 
-  /// Deletes and zeroes pointer m_resolution forsing function(...) to
-  /// recalculate the resolution function
+  /// Forget the cached transform of the resolution, forcing function(...) to
+  /// transform it again
   void refreshResolution() const;
 
 protected:
@@ -134,10 +134,18 @@ protected:
   void init() override;
 
 private:
+  struct FFTTables;
+  void checkResolutionCache(const double *xValues, size_t nData) const;
+  const FFTTables &fftTables(size_t nData) const;
+
   /// Keep the Fourier transform of the resolution function (divided by the
-  /// step in xValues) when in FFT mode, and the inverted resolution if in
-  /// Direct mode
+  /// step in xValues) when in FFT mode
   mutable std::vector<double> m_resolution;
+  /// The range of the domain and the resolution parameters m_resolution was
+  /// calculated with
+  mutable std::vector<double> m_cachedKey;
+  /// Fft tables for the size of the last domain
+  mutable std::shared_ptr<FFTTables> m_fftTables;
   void innerFunctionsAre1D() const;
 };
 
@@ -72,6 +72,8 @@ public:
   }
   /// overwrite base method
   void zero() override { m_data.assign(m_data.size(), 0.0); }
+  /// Get the derivatives, stored row by row: m_ny rows of m_np values
+  const std::vector<double> &getJ() const { return m_data; }
 };
 
 } // namespace CurveFitting
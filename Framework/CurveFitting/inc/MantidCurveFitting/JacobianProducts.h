@@ -0,0 +1,37 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2020 ISIS Rutherford Appleton Laboratory UKRI,
+//   NScD Oak Ridge National Laboratory, European Spallation Source,
+//   Institut Laue - Langevin & CSNS, Institute of High Energy Physics, CAS
+// SPDX - License - Identifier: GPL - 3.0 +
+#pragma once
+
+//----------------------------------------------------------------------
+// Includes
+//----------------------------------------------------------------------
+#include "MantidCurveFitting/DllConfig.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace Mantid {
+namespace CurveFitting {
+
+/**
+  Products of a Jacobian with itself and with the residuals, as needed by the
+  least squares minimizers: the normal matrix J^T W^2 J and the gradient
+  J^T W^2 r of a Jacobian J stored row by row (one row per data point), the
+  weights W and the residuals r.
+
+  The data points are split into contiguous blocks which are summed in
+  parallel. The sums of the blocks are added in order, so the results do not
+  depend on the number of threads.
+*/
+MANTID_CURVEFITTING_DLL double
+weightedJacobianProducts(const double *jacobian, size_t numPoints,
+                         size_t rowStride, const std::vector<size_t> &columns,
+                         const double *weights, const double *residuals,
+                         double *hessian, double *gradient);
+
+} // namespace CurveFitting
+} // namespace Mantid
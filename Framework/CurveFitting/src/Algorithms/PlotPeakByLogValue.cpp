@@ -31,8 +31,10 @@
 #include "MantidCurveFitting/Algorithms/PlotPeakByLogValue.h"
 #include "MantidDataObjects/Workspace2D.h"
 #include "MantidKernel/ArrayProperty.h"
+#include "MantidKernel/BoundedValidator.h"
 #include "MantidKernel/ListValidator.h"
 #include "MantidKernel/MandatoryValidator.h"
+#include "MantidKernel/MultiThreaded.h"
 #include "MantidKernel/TimeSeriesProperty.h"
 
 namespace {
@@ -166,6 +168,15 @@ void PlotPeakByLogValue::init() {
       "OutputFitStatus", false,
       "Flag to output fit status information which consists of the fit "
       "OutputStatus and the OutputChiSquared");
+
+  auto mustBePositive = std::make_shared<BoundedValidator<int>>();
+  mustBePositive->setLower(1);
+  declareProperty("ParallelBlocks", 1, mustBePositive,
+                  "Split the inputs into this many contiguous blocks which "
+                  "are fitted in parallel. In a Sequential fit the first fit "
+                  "of each block starts with the initial values defined in "
+                  "the Function property. The default of 1 fits all the "
+                  "inputs one after another.");
 }
 
 /**
@@ -187,6 +198,7 @@ void PlotPeakByLogValue::exec() {
   bool outputCompositeMembers = getProperty("OutputCompositeMembers");
   bool outputConvolvedMembers = getProperty("ConvolveMembers");
   bool outputFitStatus = getProperty("OutputFitStatus");
+  int parallelBlocks = getProperty("ParallelBlocks");
   m_baseName = getPropertyValue("OutputWorkspace");
 
   bool isDataName = false; // if true first output column is of type string and
@@ -203,23 +215,45 @@ void PlotPeakByLogValue::exec() {
   IFunction_sptr ifunSingle =
       isMultiDomainFunction ? inputFunction->getFunction(0) : inputFunction;
 
-  // for inidividual fittings store the initial parameters
+  // store the initial parameters for individual fittings and for the starts
+  // of the blocks of sequential fittings
   std::vector<double> initialParams(ifunSingle->nParams());
-  if (individual) {
-    for (size_t i = 0; i < initialParams.size(); ++i) {
-      initialParams[i] = ifunSingle->getParameter(i);
-    }
+  for (size_t i = 0; i < initialParams.size(); ++i) {
+    initialParams[i] = ifunSingle->getParameter(i);
   }
   ITableWorkspace_sptr result =
       createResultsTable(logName, ifunSingle, isDataName);
 
+  // Select the inputs to fit and create their minimizers
+  std::vector<int> toFit;
+  std::vector<std::string> minimizers;
+  for (int i = 0; i < static_cast<int>(wsNames.size()); ++i) {
+    const InputSpectraToFit &data = wsNames[i];
+
+    if (!data.ws) {
+      g_log.warning() << "Cannot access workspace " << data.name << '\n';
+      continue;
+    }
+
+    if (data.i < 0) {
+      g_log.warning() << "Zero spectra selected for fitting in workspace "
+                      << wsNames[i].name << '\n';
+      continue;
+    }
+    toFit.emplace_back(i);
+    minimizers.emplace_back(
+        getMinimizerString(data.name, std::to_string(data.i)));
+  }
+  const auto numFits = static_cast<int>(toFit.size());
+  result->setRowCount(toFit.size());
+
   std::vector<MatrixWorkspace_sptr> fitWorkspaces;
   std::vector<ITableWorkspace_sptr> parameterWorkspaces;
   std::vector<ITableWorkspace_sptr> covarianceWorkspaces;
   if (createFitOutput) {
-    covarianceWorkspaces.reserve(wsNames.size());
-    fitWorkspaces.reserve(wsNames.size());
-    parameterWorkspaces.reserve(wsNames.size());
+    covarianceWorkspaces.resize(toFit.size());
+    fitWorkspaces.resize(toFit.size());
+    parameterWorkspaces.resize(toFit.size());
   }
 
   std::vector<std::string> fitStatus;
@@ -229,65 +263,69 @@ void PlotPeakByLogValue::exec() {
         "OutputStatus", Direction::Output));
     declareProperty(std::make_unique<ArrayProperty<double>>("OutputChiSquared",
                                                             Direction::Output));
-    fitStatus.reserve(wsNames.size());
-    fitChiSquared.reserve(wsNames.size());
+    fitStatus.resize(toFit.size());
+    fitChiSquared.resize(toFit.size());
   }
 
-  double dProg = 1. / static_cast<double>(wsNames.size());
-  double Prog = 0.;
-  for (int i = 0; i < static_cast<int>(wsNames.size()); ++i) {
-    InputSpectraToFit data = wsNames[i];
-
-    if (!data.ws) {
-      g_log.warning() << "Cannot access workspace " << data.name << '\n';
-      continue;
-    }
-
-    if (data.i < 0) {
-      g_log.warning() << "Zero spectra selected for fitting in workspace "
-                      << wsNames[i].name << '\n';
-      continue;
-    }
+  // Split the fits into contiguous blocks fitted in parallel. Every block
+  // but the last fits a copy of the function, so that the last fit is left
+  // in the Function property as before.
+  const int numBlocks = std::max(1, std::min(parallelBlocks, numFits));
+  std::vector<IFunction_sptr> blockFunctions(numBlocks, inputFunction);
+  if (!isMultiDomainFunction) {
+    for (int block = 0; block < numBlocks - 1; ++block)
+      blockFunctions[block] = inputFunction->clone();
+  }
 
-    IFunction_sptr ifun =
-        setupFunction(individual, passWSIndexToFunction, inputFunction,
-                      initialParams, isMultiDomainFunction, i, data);
-
-    auto fit = runSingleFit(createFitOutput, outputCompositeMembers,
-                            outputConvolvedMembers, ifun, data);
-
-    ifun = fit->getProperty("Function");
-    double chi2 = fit->getProperty("OutputChi2overDoF");
-
-    if (createFitOutput) {
-      MatrixWorkspace_sptr outputFitWorkspace =
-          fit->getProperty("OutputWorkspace");
-      ITableWorkspace_sptr outputParamWorkspace =
-          fit->getProperty("OutputParameters");
-      ITableWorkspace_sptr outputCovarianceWorkspace =
-          fit->getProperty("OutputNormalisedCovarianceMatrix");
-      fitWorkspaces.emplace_back(outputFitWorkspace);
-      parameterWorkspaces.emplace_back(outputParamWorkspace);
-      covarianceWorkspaces.emplace_back(outputCovarianceWorkspace);
-    }
-    if (outputFitStatus) {
-      fitStatus.push_back(fit->getProperty("OutputStatus"));
-      fitChiSquared.push_back(chi2);
-    }
+  Progress prog(this, 0.0, 1.0, toFit.size());
+  PARALLEL_FOR_IF(numBlocks > 1)
+  for (int block = 0; block < numBlocks; ++block) {
+    PARALLEL_START_INTERUPT_REGION
+    const int blockStart = block * numFits / numBlocks;
+    const int blockEnd = (block + 1) * numFits / numBlocks;
+    for (int k = blockStart; k < blockEnd; ++k) {
+      const int i = toFit[k];
+      const InputSpectraToFit &data = wsNames[i];
+
+      // the first fit of a block starts from the initial values
+      IFunction_sptr ifun = setupFunction(
+          individual || k == blockStart, passWSIndexToFunction,
+          blockFunctions[block], initialParams, isMultiDomainFunction, i, data);
+
+      auto fit = runSingleFit(createFitOutput, outputCompositeMembers,
+                              outputConvolvedMembers, ifun, data,
+                              minimizers[k]);
+
+      ifun = fit->getProperty("Function");
+      double chi2 = fit->getProperty("OutputChi2overDoF");
+
+      if (createFitOutput) {
+        fitWorkspaces[k] = fit->getProperty("OutputWorkspace");
+        parameterWorkspaces[k] = fit->getProperty("OutputParameters");
+        covarianceWorkspaces[k] =
+            fit->getProperty("OutputNormalisedCovarianceMatrix");
+      }
+      if (outputFitStatus) {
+        fitStatus[k] = fit->getPropertyValue("OutputStatus");
+        fitChiSquared[k] = chi2;
+      }
 
-    g_log.debug() << "Fit result " << fit->getPropertyValue("OutputStatus")
-                  << ' ' << chi2 << '\n';
+      g_log.debug() << "Fit result " << fit->getPropertyValue("OutputStatus")
+                    << ' ' << chi2 << '\n';
 
-    // Find the log value: it is either a log-file value or
-    // simply the workspace number
-    double logValue = calculateLogValue(logName, data);
-    appendTableRow(isDataName, result, ifun.get(), data, logValue, chi2);
+      // Find the log value: it is either a log-file value or
+      // simply the workspace number
+      double logValue = calculateLogValue(logName, data);
+      setTableRow(isDataName, result, static_cast<size_t>(k), ifun.get(), data,
+                  logValue, chi2);
 
-    Prog += dProg;
-    std::string current = std::to_string(i);
-    progress(Prog, ("Fitting Workspace: (" + current + ") - "));
-    interruption_point();
+      std::string current = std::to_string(i);
+      prog.report("Fitting Workspace: (" + current + ") - ");
+      interruption_point();
+    }
+    PARALLEL_END_INTERUPT_REGION
   }
+  PARALLEL_CHECK_INTERUPT_REGION
 
   if (outputFitStatus) {
     setProperty("OutputStatus", fitStatus);
@@ -366,13 +404,14 @@ void PlotPeakByLogValue::finaliseOutputWorkspaces(
   }
 }
 
-void PlotPeakByLogValue::appendTableRow(bool isDataName,
-                                        ITableWorkspace_sptr &result,
-                                        const IFunction *const ifun,
-                                        const InputSpectraToFit &data,
-                                        double logValue, double chi2)
+void PlotPeakByLogValue::setTableRow(bool isDataName,
+                                     ITableWorkspace_sptr &result,
+                                     size_t rowIndex,
+                                     const IFunction *const ifun,
+                                     const InputSpectraToFit &data,
+                                     double logValue, double chi2)
     const { // Extract the fitted parameters and put them into the result table
-  TableRow row = result->appendRow();
+  TableRow row = result->getRow(rowIndex);
   if (isDataName) {
     row << data.name;
   } else {
@@ -415,7 +454,7 @@ PlotPeakByLogValue::createResultsTable(const std::string &logName,
 std::shared_ptr<Algorithm> PlotPeakByLogValue::runSingleFit(
     bool createFitOutput, bool outputCompositeMembers,
     bool outputConvolvedMembers, const IFunction_sptr &ifun,
-    const InputSpectraToFit &data) {
+    const InputSpectraToFit &data, const std::string &minimizer) {
   g_log.debug() << "Fitting " << data.ws->getName() << " index " << data.i
                 << " with \n";
   g_log.debug() << ifun->asString() << '\n';
@@ -440,8 +479,7 @@ std::shared_ptr<Algorithm> PlotPeakByLogValue::runSingleFit(
   fit->setPropertyValue("StartX", this->getPropertyValue("StartX"));
   fit->setPropertyValue("EndX", this->getPropertyValue("EndX"));
   fit->setProperty("IgnoreInvalidData", ignoreInvalidData);
-  fit->setPropertyValue("Minimizer",
-                        this->getMinimizerString(data.name, spectrum_index));
+  fit->setPropertyValue("Minimizer", minimizer);
   fit->setPropertyValue("CostFunction", this->getPropertyValue("CostFunction"));
   fit->setPropertyValue("MaxIterations",
                         this->getPropertyValue("MaxIterations"));
@@ -511,6 +511,15 @@ void QENSFitSequential::init() {
       "OutputFitStatus", false,
       "Flag to output fit status information, which consists of the fit "
       "OutputStatus and the OutputChiSquared");
+
+  auto mustBePositive = std::make_shared<BoundedValidator<int>>();
+  mustBePositive->setLower(1);
+  declareProperty("ParallelBlocks", 1, mustBePositive,
+                  "Split the spectra into this many contiguous blocks which "
+                  "are fitted in parallel. In a Sequential fit the first fit "
+                  "of each block starts with the initial values defined in "
+                  "the Function property. The default of 1 fits all the "
+                  "spectra one after another.");
 }
 
 std::map<std::string, std::string> QENSFitSequential::validateInputs() {
@@ -795,6 +804,8 @@ ITableWorkspace_sptr QENSFitSequential::performFit(const std::string &input,
   plotPeaks->setProperty("FitType", getPropertyValue("FitType"));
   plotPeaks->setProperty("CostFunction", getPropertyValue("CostFunction"));
   plotPeaks->setProperty("OutputFitStatus", outputFitStatus);
+  plotPeaks->setPropertyValue("ParallelBlocks",
+                              getPropertyValue("ParallelBlocks"));
 
   plotPeaks->executeAsChildAlg();
 
@@ -12,6 +12,7 @@
 #include "MantidAPI/FunctionValues.h"
 #include "MantidAPI/IConstraint.h"
 #include "MantidCurveFitting/Jacobian.h"
+#include "MantidCurveFitting/JacobianProducts.h"
 #include "MantidCurveFitting/SeqDomain.h"
 #include "MantidKernel/Logger.h"
 #include "MantidKernel/MultiThreaded.h"
@@ -79,29 +80,29 @@ void CostFuncLeastSquares::addValDerivHessian(API::IFunction_sptr function,
   Jacobian jacobian(ny, np);
   function->functionDeriv(*domain, jacobian);
 
-  size_t iActiveP = 0;
-  double fVal = 0.0;
+  std::vector<size_t> activeParams;
+  for (size_t ip = 0; ip < np; ++ip) {
+    if (function->isActive(ip))
+      activeParams.emplace_back(ip);
+  }
+  const size_t na = activeParams.size();
+
   std::vector<double> weights = getFitWeights(values);
+  std::vector<double> residuals(ny);
+  for (size_t i = 0; i < ny; ++i) {
+    residuals[i] = values->getCalculated(i) - values->getFitData(i);
+  }
 
-  for (size_t ip = 0; ip < np; ++ip) {
-    if (!function->isActive(ip))
-      continue;
-    double d = 0.0;
-    for (size_t i = 0; i < ny; ++i) {
-      double calc = values->getCalculated(i);
-      double obs = values->getFitData(i);
-      double w = weights[i];
-      double y = (calc - obs) * w;
-      d += y * jacobian.get(i, ip) * w;
-      if (iActiveP == 0) {
-        fVal += y * y;
-      }
-    }
-    PARALLEL_CRITICAL(der_set) {
-      double der = m_der.get(iActiveP);
-      m_der.set(iActiveP, der + d);
+  std::vector<double> der(na);
+  std::vector<double> hessian(evalHessian ? na * na : 0);
+  const double fVal = weightedJacobianProducts(
+      jacobian.getJ().data(), ny, np, activeParams, weights.data(),
+      residuals.data(), evalHessian ? hessian.data() : nullptr, der.data());
+
+  PARALLEL_CRITICAL(der_set) {
+    for (size_t i1 = 0; i1 < na; ++i1) {
+      m_der.set(i1, m_der.get(i1) + der[i1]);
     }
-    ++iActiveP;
   }
 
   PARALLEL_ATOMIC
@@ -110,32 +111,12 @@ void CostFuncLeastSquares::addValDerivHessian(API::IFunction_sptr function,
   if (!evalHessian)
     return;
 
-  size_t i1 = 0;                  // active parameter index
-  for (size_t i = 0; i < np; ++i) // over parameters
-  {
-    if (!function->isActive(i))
-      continue;
-    size_t i2 = 0;                  // active parameter index
-    for (size_t j = 0; j <= i; ++j) // over ~ half of parameters
-    {
-      if (!function->isActive(j))
-        continue;
-      double d = 0.0;
-      for (size_t k = 0; k < ny; ++k) // over fitting data
-      {
-        double w = weights[k];
-        d += jacobian.get(k, i) * jacobian.get(k, j) * w * w;
-      }
-      PARALLEL_CRITICAL(hessian_set) {
-        double h = m_hessian.get(i1, i2);
-        m_hessian.set(i1, i2, h + d);
-        if (i1 != i2) {
-          m_hessian.set(i2, i1, h + d);
-        }
+  PARALLEL_CRITICAL(hessian_set) {
+    for (size_t i1 = 0; i1 < na; ++i1) {
+      for (size_t i2 = 0; i2 < na; ++i2) {
+        m_hessian.set(i1, i2, m_hessian.get(i1, i2) + hessian[i1 * na + i2]);
       }
-      ++i2;
     }
-    ++i1;
   }
 }
 
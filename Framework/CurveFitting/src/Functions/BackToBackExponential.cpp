@@ -111,6 +111,7 @@ void BackToBackExponential::function1D(double *out, const double *xValues,
   extent *= 100;
 
   double s2 = s * s;
+  const double sqrt2s = sqrt(2 * s2);
   double normFactor = a * b / (a + b) / 2;
   // Needed for IntegratePeaksMD for cylinder profile fitted with b=0
   if (normFactor == 0.0)
@@ -121,10 +122,10 @@ void BackToBackExponential::function1D(double *out, const double *xValues,
       double val = 0.0;
       double arg1 = a / 2 * (a * s2 + 2 * diff);
       val += exp(arg1 + gsl_sf_log_erfc((a * s2 + diff) /
-                                        sqrt(2 * s2))); // prevent overflow
+                                        sqrt2s)); // prevent overflow
       double arg2 = b / 2 * (b * s2 - 2 * diff);
       val += exp(arg2 + gsl_sf_log_erfc((b * s2 - diff) /
-                                        sqrt(2 * s2))); // prevent overflow
+                                        sqrt2s)); // prevent overflow
       out[i] = I * val * normFactor;
     } else
       out[i] = 0.0;
@@ -132,13 +133,65 @@ void BackToBackExponential::function1D(double *out, const double *xValues,
 }
 
 /**
- * Evaluate function derivatives numerically.
+ * Evaluate function derivatives analytically. With d = x - X0 and the two
+ * terms E1 = exp(A/2*(A*S^2+2*d))*erfc((A*S^2+d)/sqrt(2*S^2)),
+ * E2 = exp(B/2*(B*S^2-2*d))*erfc((B*S^2-d)/sqrt(2*S^2)) the derivatives of
+ * the erfc's combine with the exponentials into the same gaussian
+ * G = exp(-d^2/(2*S^2)). As the erfc's depend on |S|, so do their terms, and
+ * the one in the derivative by S changes sign with S.
  */
 void BackToBackExponential::functionDeriv1D(Jacobian *jacobian,
                                             const double *xValues,
                                             const size_t nData) {
-  FunctionDomain1DView domain(xValues, nData);
-  this->calNumericalDeriv(domain, *jacobian);
+  const double I = getParameter(0);
+  const double a = getParameter(1);
+  const double b = getParameter(2);
+  const double x0 = getParameter(3);
+  const double s = getParameter(4);
+
+  // find the reasonable extent of the peak ~100 fwhm
+  double extent = expWidth();
+  if (s > extent)
+    extent = s;
+  extent *= 100;
+
+  const double s2 = s * s;
+  const double sqrt2s = sqrt(2 * s2);
+  const double absS = fabs(s);
+  double normFactor = a * b / (a + b) / 2;
+  double normByA = b * b / (a + b) / (a + b) / 2;
+  double normByB = a * a / (a + b) / (a + b) / 2;
+  // Needed for IntegratePeaksMD for cylinder profile fitted with b=0
+  if (normFactor == 0.0) {
+    normFactor = 1.0;
+    normByA = 0.0;
+    normByB = 0.0;
+  }
+  // 2/sqrt(pi) from the derivative of erfc times 1/sqrt(2)
+  const double gaussFactor = M_2_SQRTPI * M_SQRT1_2;
+  for (size_t i = 0; i < nData; i++) {
+    const double diff = xValues[i] - x0;
+    if (fabs(diff) < extent) {
+      const double e1 = exp(a / 2 * (a * s2 + 2 * diff) +
+                            gsl_sf_log_erfc((a * s2 + diff) / sqrt2s));
+      const double e2 = exp(b / 2 * (b * s2 - 2 * diff) +
+                            gsl_sf_log_erfc((b * s2 - diff) / sqrt2s));
+      const double g = gaussFactor * exp(-diff * diff / (2 * s2));
+      const double sum = e1 + e2;
+      const double In = I * normFactor;
+      jacobian->set(i, 0, normFactor * sum);
+      jacobian->set(i, 1,
+                    I * normByA * sum + In * (e1 * (a * s2 + diff) - g * absS));
+      jacobian->set(i, 2,
+                    I * normByB * sum + In * (e2 * (b * s2 - diff) - g * absS));
+      jacobian->set(i, 3, -In * (a * e1 - b * e2));
+      jacobian->set(i, 4, In * (s * (a * a * e1 + b * b * e2) -
+                                copysign(g, s) * (a + b)));
+    } else {
+      for (size_t j = 0; j < 5; ++j)
+        jacobian->set(i, j, 0.0);
+    }
+  }
 }
 
 /**
@@ -104,22 +104,24 @@ void Convolution::setAttribute(const std::string &attName,
   CompositeFunction::setAttribute(attName, att);
 }
 
-namespace {
-// anonymous namespace for local definitions
-
-// A struct incapsulating workspaces for real fft
-struct RealFFTWorkspace {
-  explicit RealFFTWorkspace(size_t nData)
-      : workspace(gsl_fft_real_workspace_alloc(nData)),
-        wavetable(gsl_fft_real_wavetable_alloc(nData)) {}
-  ~RealFFTWorkspace() {
+/// Workspace and wavetables of the real fft and its inverse for one size
+struct Convolution::FFTTables {
+  explicit FFTTables(size_t nData)
+      : size(nData), workspace(gsl_fft_real_workspace_alloc(nData)),
+        wavetable(gsl_fft_real_wavetable_alloc(nData)),
+        inverseWavetable(gsl_fft_halfcomplex_wavetable_alloc(nData)) {}
+  ~FFTTables() {
+    gsl_fft_halfcomplex_wavetable_free(inverseWavetable);
     gsl_fft_real_wavetable_free(wavetable);
     gsl_fft_real_workspace_free(workspace);
   }
+  FFTTables(const FFTTables &) = delete;
+  FFTTables &operator=(const FFTTables &) = delete;
+  size_t size;
   gsl_fft_real_workspace *workspace;
   gsl_fft_real_wavetable *wavetable;
+  gsl_fft_halfcomplex_wavetable *inverseWavetable;
 };
-} // namespace
 
 /**
  * Calculates convolution of the two member functions. Switches from FFT mode
@@ -179,8 +181,8 @@ void Convolution::functionFFTMode(const FunctionDomain &domain,
   const auto &d1d = dynamic_cast<const FunctionDomain1D &>(domain);
   size_t nData = domain.size();
   const double *xValues = d1d.getPointerAt(0);
-  refreshResolution();
-  RealFFTWorkspace workspace(nData);
+  checkResolutionCache(xValues, nData);
+  const FFTTables &workspace = fftTables(nData);
   int n2 = static_cast<int>(nData) / 2;
   bool odd = n2 * 2 != static_cast<int>(nData);
   if (m_resolution.empty()) {
@@ -305,11 +307,8 @@ void Convolution::functionFFTMode(const FunctionDomain &domain,
     }
 
     // Inverse fourier transform of fun
-    gsl_fft_halfcomplex_wavetable *wavetable_r =
-        gsl_fft_halfcomplex_wavetable_alloc(nData);
-    gsl_fft_halfcomplex_inverse(out, 1, nData, wavetable_r,
+    gsl_fft_halfcomplex_inverse(out, 1, nData, workspace.inverseWavetable,
                                 workspace.workspace);
-    gsl_fft_halfcomplex_wavetable_free(wavetable_r);
 
     // Inverse fourier transform is integration - multiply by the step in the
     // integration variable
@@ -365,8 +364,6 @@ void Convolution::functionDirectMode(const FunctionDomain &domain,
                                                            // x-values
   auto ixN = nData - ixP - 1; // negative x-values (ixP+ixN=nData-1)
 
-  refreshResolution();
-
   // double the domain where to evaluate the convolution. Guarantees complete
   // overlap betwen convolution and signal in the original range.
   const size_t mData = nData + ixN + ixP; // equal to 2*nData-1
@@ -378,16 +375,14 @@ void Convolution::functionDirectMode(const FunctionDomain &domain,
     xValuesExtd[i] = -Dx + static_cast<double>(i) * dx;
   }
 
-  if (m_resolution.empty()) {
-    m_resolution.resize(nData);
-  }
-  // Fill m_resolution with the resolution function data
+  // Fill resolution with the resolution function data
   // Lines 341-349 is duplicated in functionFFTmode. To be cleanup
   // in issue 16064
-  evaluateFunctionOnRange(getFunction(0), nData, &xValues[0], m_resolution);
+  std::vector<double> resolution(nData);
+  evaluateFunctionOnRange(getFunction(0), nData, &xValues[0], resolution);
 
   // Reverse the axis of the resolution data
-  std::reverse(m_resolution.begin(), m_resolution.end());
+  std::reverse(resolution.begin(), resolution.end());
 
   // check for delta functions
   std::vector<std::shared_ptr<DeltaFunction>> dltFuns;
@@ -435,7 +430,7 @@ void Convolution::functionDirectMode(const FunctionDomain &domain,
     for (size_t i = 0; i < nData; i++) {
       double tmp{0.0};
       for (size_t j = 0; j < nData; j++) {
-        tmp += outExt[i + j] * m_resolution[j];
+        tmp += outExt[i + j] * resolution[j];
       }
       out[i] = tmp * dx;
     }
@@ -488,6 +483,9 @@ size_t Convolution::addFunction(IFunction_sptr f) {
       f->fix(i);
     }
   }
+  // A new resolution may have the same parameters as the one it replaces
+  if (nFunctions() == 0)
+    refreshResolution();
   size_t iFun = 0;
   if (nFunctions() < 2) {
     iFun = CompositeFunction::addFunction(f);
@@ -517,27 +515,54 @@ size_t Convolution::addFunction(IFunction_sptr f) {
  * Make sure that the resolution is updated if this function is reused in
  * several Fits.
  */
-void Convolution::setUpForFit() { m_resolution.clear(); }
+void Convolution::setUpForFit() { refreshResolution(); }
 
-/// Deletes and zeroes pointer m_resolution forsing function(...) to recalculate
-/// the resolution function
+/**
+ * Forget the Fourier transform of the resolution and the key it was
+ * calculated with, so that function(...) transforms the resolution again.
+ * This is the only place the cached transform is invalidated.
+ */
 void Convolution::refreshResolution() const {
-  // refresh when calculation for the first time
-  bool needRefreshing = m_resolution.empty();
-  if (!needRefreshing) {
-    // if resolution has active parameters always refresh
-    IFunction &res = *getFunction(0);
-    for (size_t i = 0; i < res.nParams(); ++i) {
-      if (res.isActive(i)) {
-        needRefreshing = true;
-        break;
-      }
-    }
-  }
-  if (!needRefreshing)
-    return;
-  // delete fourier transform of the resolution to force its recalculation
   m_resolution.clear();
+  m_cachedKey.clear();
+}
+
+/**
+ * Clear the Fourier transform of the resolution unless it was calculated on a
+ * domain of the same size and range and with the same parameters of the
+ * resolution. A resolution with free parameters is then transformed again
+ * only when its own parameters change, and not for the derivatives by the
+ * parameters of the model. Changes of the attributes are picked up by
+ * setUpForFit().
+ * @param xValues :: the x values of the domain
+ * @param nData :: the size of the domain
+ */
+void Convolution::checkResolutionCache(const double *xValues,
+                                       size_t nData) const {
+  const IFunction &res = *getFunction(0);
+  std::vector<double> key(res.nParams() + 2);
+  key[0] = xValues[0];
+  key[1] = xValues[nData - 1];
+  for (size_t i = 0; i < res.nParams(); ++i) {
+    key[i + 2] = res.getParameter(i);
+  }
+  if (m_resolution.size() != nData || key != m_cachedKey) {
+    refreshResolution();
+    m_cachedKey.swap(key);
+  }
+}
+
+/**
+ * Get the workspace and wavetables of the fft, allocated only when the size of
+ * the domain changes.
+ * @param nData :: the size of the domain
+ * @return the tables
+ */
+const Convolution::FFTTables &Convolution::fftTables(size_t nData) const {
+  if (!m_fftTables || m_fftTables->size != nData) {
+    m_fftTables = std::make_shared<FFTTables>(nData);
+  }
+  return *m_fftTables;
 }
 
 } // namespace Functions
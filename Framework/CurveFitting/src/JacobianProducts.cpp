@@ -0,0 +1,117 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2020 ISIS Rutherford Appleton Laboratory UKRI,
+//   NScD Oak Ridge National Laboratory, European Spallation Source,
+//   Institut Laue - Langevin & CSNS, Institute of High Energy Physics, CAS
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidCurveFitting/JacobianProducts.h"
+#include "MantidKernel/MultiThreaded.h"
+
+#include <algorithm>
+
+namespace Mantid {
+namespace CurveFitting {
+
+namespace {
+/// Smallest number of data points worth a block of its own
+constexpr size_t MIN_BLOCK_SIZE = 2048;
+/// Largest number of blocks, which bounds the memory for their sums
+constexpr size_t MAX_BLOCKS = 64;
+} // namespace
+
+/**
+ * Calculate the weighted products of a Jacobian.
+ * @param jacobian :: the derivatives, numPoints rows of rowStride values
+ * @param numPoints :: the number of data points
+ * @param rowStride :: the distance between the rows of the Jacobian
+ * @param columns :: the columns of the Jacobian to use, usually the active
+ * parameters
+ * @param weights :: the weights of the data points, or nullptr for 1
+ * @param residuals :: the residuals of the data points, or nullptr if the
+ * gradient is not needed
+ * @param hessian :: a columns.size() x columns.size() row major array for the
+ * normal matrix J^T W^2 J, or nullptr if it is not needed
+ * @param gradient :: an array of columns.size() values for the gradient
+ * J^T W^2 r, used only with the residuals
+ * @return the weighted sum of squares of the residuals, 0 without residuals
+ */
+double weightedJacobianProducts(const double *jacobian, const size_t numPoints,
+                                const size_t rowStride,
+                                const std::vector<size_t> &columns,
+                                const double *weights,
+                                const double *residuals, double *hessian,
+                                double *gradient) {
+  const size_t n = columns.size();
+  const size_t numBlocks = std::max(
+      size_t{1}, std::min(MAX_BLOCKS, numPoints / MIN_BLOCK_SIZE));
+  // the sums of each block: n * n of the normal matrix, n of the gradient and
+  // the sum of squares
+  const size_t blockSums = n * n + n + 1;
+  std::vector<double> sums(numBlocks * blockSums, 0.0);
+
+  PARALLEL_FOR_IF(numBlocks > 1)
+  for (int64_t block = 0; block < static_cast<int64_t>(numBlocks); ++block) {
+    const auto iBlock = static_cast<size_t>(block);
+    const size_t start = iBlock * numPoints / numBlocks;
+    const size_t end = (iBlock + 1) * numPoints / numBlocks;
+    double *blockHessian = sums.data() + iBlock * blockSums;
+    double *blockGradient = blockHessian + n * n;
+    double &blockSquares = blockGradient[n];
+    std::vector<double> row(n);
+    for (size_t i = start; i < end; ++i) {
+      const double w = weights ? weights[i] : 1.0;
+      const double w2 = w * w;
+      if (w2 == 0.0)
+        continue;
+      const double *derivatives = jacobian + i * rowStride;
+      for (size_t a = 0; a < n; ++a)
+        row[a] = derivatives[columns[a]];
+      if (residuals) {
+        const double r = residuals[i];
+        blockSquares += w2 * r * r;
+        for (size_t a = 0; a < n; ++a)
+          blockGradient[a] += w2 * r * row[a];
+      }
+      if (hessian) {
+        for (size_t a = 0; a < n; ++a) {
+          const double da = w2 * row[a];
+          double *hessianRow = blockHessian + a * n;
+          for (size_t b = 0; b <= a; ++b)
+            hessianRow[b] += da * row[b];
+        }
+      }
+    }
+  }
+
+  // add up the blocks in order
+  double sumOfSquares = 0.0;
+  if (hessian)
+    std::fill(hessian, hessian + n * n, 0.0);
+  if (residuals)
+    std::fill(gradient, gradient + n, 0.0);
+  for (size_t iBlock = 0; iBlock < numBlocks; ++iBlock) {
+    const double *blockHessian = sums.data() + iBlock * blockSums;
+    const double *blockGradient = blockHessian + n * n;
+    if (hessian) {
+      for (size_t a = 0; a < n; ++a) {
+        for (size_t b = 0; b <= a; ++b)
+          hessian[a * n + b] += blockHessian[a * n + b];
+      }
+    }
+    if (residuals) {
+      for (size_t a = 0; a < n; ++a)
+        gradient[a] += blockGradient[a];
+      sumOfSquares += blockGradient[n];
+    }
+  }
+  if (hessian) {
+    for (size_t a = 0; a < n; ++a) {
+      for (size_t b = 0; b < a; ++b)
+        hessian[b * n + a] = hessian[a * n + b];
+    }
+  }
+  return sumOfSquares;
+}
+
+} // namespace CurveFitting
+} // namespace Mantid
@@ -10,10 +10,12 @@
 // Includes
 //----------------------------------------------------------------------
 #include "MantidCurveFitting/RalNlls/TrustRegion.h"
+#include "MantidCurveFitting/JacobianProducts.h"
 
 #include <algorithm>
 #include <functional>
 #include <limits>
+#include <numeric>
 #include <string>
 
 #include <cmath>
@@ -36,7 +38,19 @@ const double EPSILON_MCH = std::numeric_limits<double>::epsilon();
 void matmultInner(const DoubleFortranMatrix &J, DoubleFortranMatrix &A) {
   auto n = J.len2();
   A.allocate(n, n);
-  gsl_blas_dgemm(CblasTrans, CblasNoTrans, 1.0, J.gsl(), J.gsl(), 0.0, A.gsl());
+  // The data points of a large fit are summed in parallel
+  const gsl_matrix *j = J.gsl();
+  std::vector<size_t> columns(j->size2);
+  std::iota(columns.begin(), columns.end(), 0);
+  std::vector<double> product(columns.size() * columns.size());
+  weightedJacobianProducts(j->data, j->size1, j->tda, columns, nullptr,
+                           nullptr, product.data(), nullptr);
+  for (size_t row = 0; row < columns.size(); ++row) {
+    for (size_t column = 0; column < columns.size(); ++column) {
+      gsl_matrix_set(A.gsl(), row, column,
+                     product[row * columns.size() + column]);
+    }
+  }
 }
 
 /**  Given an (m x n)  matrix J held by columns as a vector,
@@ -226,6 +226,46 @@ public:
     WorkspaceCreationHelper::removeWS("PlotPeakResult");
   }
 
+  void test_sequential_fit_in_parallel_blocks() {
+    createData();
+
+    PlotPeakByLogValue alg;
+    alg.initialize();
+    alg.setPropertyValue("Input",
+                         "PlotPeakGroup_0;PlotPeakGroup_1;PlotPeakGroup_2");
+    alg.setPropertyValue("OutputWorkspace", "PlotPeakResult");
+    alg.setPropertyValue("WorkspaceIndex", "1");
+    alg.setPropertyValue("LogValue", "var");
+    alg.setPropertyValue("Function", "name=LinearBackground,A0=1,A1=0.3;name="
+                                     "Gaussian,PeakCentre=5,Height=2,Sigma=0."
+                                     "1");
+    alg.setProperty("ParallelBlocks", 2);
+    alg.setProperty("OutputFitStatus", true);
+    alg.execute();
+    TS_ASSERT(alg.isExecuted());
+
+    TWS_type result =
+        WorkspaceCreationHelper::getWS<TableWorkspace>("PlotPeakResult");
+    TS_ASSERT_EQUALS(result->rowCount(), 3);
+    for (size_t row = 0; row < 3; ++row) {
+      const auto ws = static_cast<double>(row);
+      TS_ASSERT_DELTA(result->Double(row, 0), 1. + 0.3 * ws, 1e-10);
+      TS_ASSERT_DELTA(result->Double(row, 1), 1. + 0.1 * ws, 1e-10);
+      TS_ASSERT_DELTA(result->Double(row, 3), 0.3 - 0.02 * ws, 1e-10);
+      TS_ASSERT_DELTA(result->Double(row, 5), 2. - 0.2 * ws, 1e-10);
+      TS_ASSERT_DELTA(result->Double(row, 7), 5. + 0.03 * ws, 1e-10);
+      TS_ASSERT_DELTA(result->Double(row, 9), 0.1 + 0.01 * ws, 1e-10);
+    }
+    const std::vector<std::string> status = alg.getProperty("OutputStatus");
+    TS_ASSERT_EQUALS(status.size(), 3);
+    // The last block leaves its last fit in the function
+    IFunction_sptr fun = alg.getProperty("Function");
+    TS_ASSERT_DELTA(fun->getParameter("f1.PeakCentre"), 5.06, 1e-10);
+
+    deleteData();
+    WorkspaceCreationHelper::removeWS("PlotPeakResult");
+  }
+
   void testWorkspaceList_plotting_against_ws_names() {
     createData();
 
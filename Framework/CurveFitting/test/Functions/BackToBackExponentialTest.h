@@ -11,6 +11,7 @@
 #include "MantidAPI/FunctionDomain1D.h"
 #include "MantidAPI/FunctionValues.h"
 #include "MantidCurveFitting/Functions/BackToBackExponential.h"
+#include "MantidCurveFitting/Jacobian.h"
 
 #include <cmath>
 
@@ -173,6 +174,32 @@ public:
     }
   }
 
+  void test_analytic_derivatives_match_numerical() {
+    // the function only depends on |S|, a fit may make S negative
+    for (const double s : {1.3, -1.3}) {
+      BackToBackExponential b2bExp;
+      b2bExp.initialize();
+      b2bExp.setParameter("I", 2.1);
+      b2bExp.setParameter("A", 1.1);
+      b2bExp.setParameter("B", 0.3);
+      b2bExp.setParameter("X0", 0.5);
+      b2bExp.setParameter("S", s);
+
+      Mantid::API::FunctionDomain1DVector x(-10, 20, 61);
+      Mantid::CurveFitting::Jacobian analytic(x.size(), 5);
+      Mantid::CurveFitting::Jacobian numerical(x.size(), 5);
+      b2bExp.functionDeriv(x, analytic);
+      b2bExp.calNumericalDeriv(x, numerical);
+      for (size_t i = 0; i < x.size(); ++i) {
+        for (size_t j = 0; j < 5; ++j) {
+          const double expected = numerical.get(i, j);
+          TS_ASSERT_DELTA(analytic.get(i, j), expected,
+                          1e-2 * std::fabs(expected) + 1e-3);
+        }
+      }
+    }
+  }
+
   void testIntensity() {
     const double s = 4.0;
     const double I = 2.1;
@@ -302,6 +302,44 @@ public:
     //}
   }
 
+  void test_resolution_transform_follows_resolution_and_domain() {
+    Convolution conv;
+
+    const double a = 1.3;
+    const double h = 3.;
+    auto res = std::make_shared<ConvolutionTest_Gauss>();
+    res->setParameter("c", 0);
+    res->setParameter("h", h);
+    res->setParameter("s", a);
+    conv.addFunction(res);
+
+    const double pi = acos(0.) * 2;
+    const double dx = 0.3;
+    auto checkTransform = [&](const int n, const double height) {
+      std::vector<double> x(n);
+      for (int i = 0; i < n; i++)
+        x[i] = i * dx;
+      FunctionDomain1DView xView(x.data(), x.size());
+      FunctionValues values(xView);
+      conv.function(xView, values);
+      Convolution::HalfComplex hout(values.getPointerToCalculated(0), n);
+      const double df = 1. / (dx * n);
+      const double cc = pi * pi * df * df / a;
+      for (size_t i = 0; i < hout.size(); i++) {
+        TS_ASSERT_DELTA(hout.real(i),
+                        height * sqrt(pi / a) * exp(-cc * double(i * i)),
+                        1e-7);
+      }
+    };
+
+    checkTransform(116, h);
+    // the resolution is fixed but its parameters have changed
+    res->setParameter("h", 2 * h);
+    checkTransform(116, 2 * h);
+    // a domain of a different size
+    checkTransform(58, 2 * h);
+  }
+
   void testConvolution() {
     Convolution conv;
 
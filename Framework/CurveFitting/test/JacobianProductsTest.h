@@ -0,0 +1,85 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2020 ISIS Rutherford Appleton Laboratory UKRI,
+//   NScD Oak Ridge National Laboratory, European Spallation Source,
+//   Institut Laue - Langevin & CSNS, Institute of High Energy Physics, CAS
+// SPDX - License - Identifier: GPL - 3.0 +
+#pragma once
+
+#include <cxxtest/TestSuite.h>
+
+#include "MantidCurveFitting/JacobianProducts.h"
+
+#include <cmath>
+#include <vector>
+
+using Mantid::CurveFitting::weightedJacobianProducts;
+
+class JacobianProductsTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static JacobianProductsTest *createSuite() {
+    return new JacobianProductsTest();
+  }
+  static void destroySuite(JacobianProductsTest *suite) { delete suite; }
+
+  void test_products_of_a_large_jacobian() {
+    // enough points to be split into blocks
+    const size_t numPoints = 20001;
+    const size_t stride = 5;
+    const std::vector<size_t> columns{0, 2, 3};
+    std::vector<double> jacobian(numPoints * stride), weights(numPoints),
+        residuals(numPoints);
+    for (size_t i = 0; i < numPoints; ++i) {
+      const double x = static_cast<double>(i) / static_cast<double>(numPoints);
+      for (size_t j = 0; j < stride; ++j)
+        jacobian[i * stride + j] = std::cos(x * static_cast<double>(j + 1));
+      weights[i] = i % 7 == 0 ? 0.0 : 1.0 + x;
+      residuals[i] = std::sin(10.0 * x);
+    }
+
+    std::vector<double> hessian(9), gradient(3);
+    const double sumOfSquares = weightedJacobianProducts(
+        jacobian.data(), numPoints, stride, columns, weights.data(),
+        residuals.data(), hessian.data(), gradient.data());
+
+    double expectedSquares = 0.0;
+    std::vector<double> expectedHessian(9, 0.0), expectedGradient(3, 0.0);
+    for (size_t i = 0; i < numPoints; ++i) {
+      const double w2 = weights[i] * weights[i];
+      expectedSquares += w2 * residuals[i] * residuals[i];
+      for (size_t a = 0; a < 3; ++a) {
+        const double da = jacobian[i * stride + columns[a]];
+        expectedGradient[a] += w2 * residuals[i] * da;
+        for (size_t b = 0; b < 3; ++b)
+          expectedHessian[a * 3 + b] +=
+              w2 * da * jacobian[i * stride + columns[b]];
+      }
+    }
+    TS_ASSERT_DELTA(sumOfSquares, expectedSquares, 1e-9 * expectedSquares);
+    for (size_t a = 0; a < 3; ++a) {
+      TS_ASSERT_DELTA(gradient[a], expectedGradient[a],
+                      1e-9 * std::fabs(expectedGradient[a]));
+      for (size_t b = 0; b < 3; ++b) {
+        TS_ASSERT_DELTA(hessian[a * 3 + b], expectedHessian[a * 3 + b],
+                        1e-9 * std::fabs(expectedHessian[a * 3 + b]));
+        TS_ASSERT_EQUALS(hessian[a * 3 + b], hessian[b * 3 + a]);
+      }
+    }
+  }
+
+  void test_normal_matrix_only() {
+    // J = [[1, 2], [3, 4], [5, 6]] with unit weights
+    const std::vector<double> jacobian{1., 2., 3., 4., 5., 6.};
+    std::vector<double> hessian(4);
+    const double sumOfSquares =
+        weightedJacobianProducts(jacobian.data(), 3, 2, {0, 1}, nullptr,
+                                 nullptr, hessian.data(), nullptr);
+    TS_ASSERT_EQUALS(sumOfSquares, 0.0);
+    TS_ASSERT_EQUALS(hessian[0], 35.0);
+    TS_ASSERT_EQUALS(hessian[1], 44.0);
+    TS_ASSERT_EQUALS(hessian[2], 44.0);
+    TS_ASSERT_EQUALS(hessian[3], 56.0);
+  }
+};
@@ -0,0 +1,53 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2020 ISIS Rutherford Appleton Laboratory UKRI,
+//   NScD Oak Ridge National Laboratory, European Spallation Source,
+//   Institut Laue - Langevin & CSNS, Institute of High Energy Physics, CAS
+// SPDX - License - Identifier: GPL - 3.0 +
+#pragma once
+
+#include "MantidDataHandling/DllConfig.h"
+#include "MantidKernel/Task.h"
+
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace Mantid {
+namespace Kernel {
+class ThreadScheduler;
+}
+namespace DataHandling {
+
+/** BankSliceQueue : runs the tasks processing the slices of a bank for one
+  range of pixel IDs one at a time, in the order the slices were read.
+
+  Events are appended to the event lists, so processing the slices in the
+  order of the file keeps the lists sorted by pulse time. A thread scheduler
+  does not guarantee the order of the tasks it is given, so the queue only
+  schedules one task at a time, which runs the queued slices in turn until
+  there are none left.
+*/
+class MANTID_DATAHANDLING_DLL BankSliceQueue
+    : public std::enable_shared_from_this<BankSliceQueue> {
+public:
+  explicit BankSliceQueue(Kernel::ThreadScheduler &scheduler);
+
+  void push(std::shared_ptr<Kernel::Task> task);
+  bool pushAndRun(std::shared_ptr<Kernel::Task> task);
+
+private:
+  void runQueued();
+
+  /// Scheduler running the queued tasks
+  Kernel::ThreadScheduler &m_scheduler;
+  /// Protects the queue and the running flag
+  std::mutex m_mutex;
+  /// Tasks waiting to be run, in order
+  std::deque<std::shared_ptr<Kernel::Task>> m_tasks;
+  /// Is a thread running the queued tasks?
+  bool m_running;
+};
+
+} // namespace DataHandling
+} // namespace Mantid
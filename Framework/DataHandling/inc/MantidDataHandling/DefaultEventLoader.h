@@ -10,6 +10,8 @@
 #include "MantidDataHandling/DllConfig.h"
 #include "MantidDataHandling/EventWorkspaceCollection.h"
 
+#include <atomic>
+
 class BankPulseTimes;
 
 namespace Mantid {
@@ -76,6 +78,25 @@ public:
   /// One entry of pulse times for each preprocessor
   std::vector<std::shared_ptr<BankPulseTimes>> m_bankPulseTimes;
 
+  size_t eventsPerSlice(const size_t numEvents) const;
+
+  /// Maximum number of events read from the file but not yet processed
+  size_t maxEventsInFlight;
+  /// Number of events read from the file but not yet processed
+  std::atomic<size_t> eventsInFlight{0};
+  /// Time spent reading events from the file, in microseconds
+  std::atomic<int64_t> readTime{0};
+  /// Time spent turning the events read into event lists, in microseconds
+  std::atomic<int64_t> processTime{0};
+  /// Number of slices of events read from the file
+  std::atomic<size_t> numSlices{0};
+  /// Number of slices not read, or only partly, as none of their events
+  /// were wanted
+  std::atomic<size_t> numSlicesSkipped{0};
+  /// Number of slices processed by the reading task itself, because too many
+  /// events were already waiting to be processed
+  std::atomic<size_t> numSlicesProcessedByReader{0};
+
 private:
   DefaultEventLoader(LoadEventNexus *alg, EventWorkspaceCollection &ws,
                      bool haveWeights, bool event_id_is_spec,
@@ -87,6 +108,7 @@ private:
   /// Map detector IDs to event lists.
   template <class T>
   void makeMapToEventLists(std::vector<std::vector<T>> &vectors);
+  void logPipelineStatistics() const;
 };
 
 /** Generate a look-up table where the index = the pixel ID of an event
@@ -0,0 +1,68 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2020 ISIS Rutherford Appleton Laboratory UKRI,
+//   NScD Oak Ridge National Laboratory, European Spallation Source,
+//   Institut Laue - Langevin & CSNS, Institute of High Energy Physics, CAS
+// SPDX - License - Identifier: GPL - 3.0 +
+#pragma once
+
+#include "MantidDataHandling/DllConfig.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Mantid {
+namespace DataHandling {
+
+/** EventIdRangeIndex : the smallest and largest event ID in each block of
+  consecutive events of an NXevent_data bank.
+
+  LoadBankFromDiskTask records the ranges of the event IDs it reads. The
+  index is kept in a cache for the rest of the session, keyed by the file, its
+  modification time and the bank, so that when the same file is loaded again
+  for only some spectra the blocks holding none of them are not read at all.
+
+  Blocks that have not been seen in full have an unknown range, and are
+  assumed to hold any ID.
+
+  Only a range of IDs is summarised, so this only saves reads when the events
+  of a bank are sorted or grouped by ID. Events are usually recorded in time
+  order with the IDs of the whole bank interleaved, and then almost every
+  block spans nearly all of them. A set of wanted IDs, such as the spectra
+  left after masking, is reduced to its smallest and largest ID.
+*/
+class MANTID_DATAHANDLING_DLL EventIdRangeIndex {
+public:
+  /// Number of events summarised by one entry
+  static constexpr size_t EVENTS_PER_BLOCK = 1 << 16;
+
+  explicit EventIdRangeIndex(const size_t numEvents);
+
+  size_t numEvents() const;
+  void addEvents(const size_t start, const uint32_t *ids, const size_t count);
+  void merge(const EventIdRangeIndex &other);
+  std::pair<size_t, size_t> narrow(const size_t start, const size_t stop,
+                                   const uint32_t minId,
+                                   const uint32_t maxId) const;
+
+  static std::string cacheKey(const std::string &filename,
+                              const std::string &entryName,
+                              const std::string &bankName);
+  static std::shared_ptr<const EventIdRangeIndex>
+  findInCache(const std::string &key);
+  static void storeInCache(const std::string &key,
+                           std::shared_ptr<const EventIdRangeIndex> index);
+  static void clearCache();
+
+private:
+  /// Number of events in the bank
+  size_t m_numEvents;
+  /// Smallest and largest ID of each block; first > second if unknown
+  std::vector<std::pair<uint32_t, uint32_t>> m_ranges;
+};
+
+} // namespace DataHandling
+} // namespace Mantid
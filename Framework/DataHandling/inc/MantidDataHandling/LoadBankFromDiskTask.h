@@ -13,10 +13,13 @@
 
 #include <nexus/NeXusFile.hpp>
 
+#include <exception>
+
 class BankPulseTimes;
 
 namespace Mantid {
 namespace DataHandling {
+class BankSliceQueue;
 class DefaultEventLoader;
 
 /** This task does the disk IO from loading the NXS file, and so will be on a
@@ -45,6 +48,12 @@ private:
   std::unique_ptr<std::vector<uint32_t>> loadEventId(::NeXus::File &file);
   std::unique_ptr<std::vector<float>> loadTof(::NeXus::File &file);
   std::unique_ptr<std::vector<float>> loadEventWeights(::NeXus::File &file);
+  void processSlice(std::unique_ptr<std::vector<uint32_t>> event_id,
+                    std::unique_ptr<std::vector<float>> event_time_of_flight,
+                    std::unique_ptr<std::vector<float>> event_weight,
+                    const std::shared_ptr<std::vector<uint64_t>> &event_index,
+                    const bool sliced);
+  std::pair<uint32_t, uint32_t> wantedIdRange() const;
   int64_t recalculateDataSize(const int64_t &size);
 
   /// Algorithm being run
@@ -67,6 +76,8 @@ private:
   std::vector<int64_t> m_loadStart;
   /// How much to load in the file
   std::vector<int64_t> m_loadSize;
+  /// Number of events in the bank in the file
+  size_t m_numBankEvents;
   /// Minimum pixel ID in this data
   uint32_t m_min_id;
   /// Maximum pixel ID in this data
@@ -75,6 +86,16 @@ private:
   bool m_have_weight;
   /// Frame period numbers
   const std::vector<int> m_framePeriodNumbers;
+  /// Slices of this bank waiting to be processed for the lower pixel IDs
+  std::shared_ptr<BankSliceQueue> m_lowIdSlices;
+  /// Slices of this bank waiting to be processed for the higher pixel IDs
+  std::shared_ptr<BankSliceQueue> m_highIdSlices;
+  /// Last pixel ID of the lower half when processing is split
+  uint32_t m_splitId;
+  /// Is the next slice the first one read from this bank?
+  bool m_firstSlice;
+  /// Error thrown while processing a slice in this task
+  std::exception_ptr m_processingError;
 }; // END-DEF-CLASS LoadBankFromDiskTask
 
 } // namespace DataHandling
@@ -0,0 +1,83 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2020 ISIS Rutherford Appleton Laboratory UKRI,
+//   NScD Oak Ridge National Laboratory, European Spallation Source,
+//   Institut Laue - Langevin & CSNS, Institute of High Energy Physics, CAS
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidDataHandling/BankSliceQueue.h"
+#include "MantidKernel/FunctionTask.h"
+#include "MantidKernel/ThreadScheduler.h"
+
+namespace Mantid {
+namespace DataHandling {
+
+using Kernel::Task;
+
+/** Constructor
+ * @param scheduler :: the scheduler that runs the queued tasks
+ */
+BankSliceQueue::BankSliceQueue(Kernel::ThreadScheduler &scheduler)
+    : m_scheduler(scheduler), m_running(false) {}
+
+/** Queue a task after the ones already queued. If no thread is running the
+ * queue, a task running it is given to the scheduler.
+ * @param task :: the task to run
+ */
+void BankSliceQueue::push(std::shared_ptr<Task> task) {
+  const double cost = task->cost();
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tasks.emplace_back(std::move(task));
+    if (m_running)
+      return;
+    m_running = true;
+  }
+  auto queue = shared_from_this();
+  m_scheduler.push(std::make_shared<Kernel::FunctionTask>(
+      [queue]() { queue->runQueued(); }, cost));
+}
+
+/** Queue a task after the ones already queued and, if no thread is running
+ * the queue, run it in this thread until it is empty. Otherwise the thread
+ * running the queue runs the task.
+ * @param task :: the task to run
+ * @return true if the queue was run in this thread
+ */
+bool BankSliceQueue::pushAndRun(std::shared_ptr<Task> task) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tasks.emplace_back(std::move(task));
+    if (m_running)
+      return false;
+    m_running = true;
+  }
+  runQueued();
+  return true;
+}
+
+/// Run the queued tasks in order until there are none left
+void BankSliceQueue::runQueued() {
+  while (true) {
+    std::shared_ptr<Task> task;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_tasks.empty()) {
+        m_running = false;
+        return;
+      }
+      task = std::move(m_tasks.front());
+      m_tasks.pop_front();
+    }
+    try {
+      task->run();
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_tasks.clear();
+      m_running = false;
+      throw;
+    }
+  }
+}
+
+} // namespace DataHandling
+} // namespace Mantid
@@ -16,6 +16,17 @@ using namespace Mantid::Kernel;
 namespace Mantid {
 namespace DataHandling {
 
+namespace {
+/// Banks are read in about this many slices so reading overlaps processing
+constexpr size_t SLICES_PER_BANK = 4;
+/// Smallest slice of a bank read in one go
+constexpr size_t MIN_EVENTS_PER_SLICE = 1 << 20;
+/// Largest slice of a bank read in one go
+constexpr size_t MAX_EVENTS_PER_SLICE = 1 << 24;
+/// Number of slices per thread that may wait to be processed
+constexpr size_t SLICES_IN_FLIGHT_PER_THREAD = 2;
+} // namespace
+
 void DefaultEventLoader::load(LoadEventNexus *alg, EventWorkspaceCollection &ws,
                               bool haveWeights, bool event_id_is_spec,
                               std::vector<std::string> bankNames,
@@ -35,9 +46,15 @@ void DefaultEventLoader::load(LoadEventNexus *alg, EventWorkspaceCollection &ws,
   auto diskIOMutex = std::make_shared<std::mutex>();
 
   // set up progress bar for the rest of the (multi-threaded) process
-  size_t numProg = bankNames.size() * (1 + 3); // 1 = disktask, 3 = proc task
-  if (loader.splitProcessing)
-    numProg += bankNames.size() * 3; // 3 = second proc task
+  size_t numProg = bankNames.size(); // 1 = disktask
+  for (size_t i = bankRange.first; i < bankRange.second; i++) {
+    const size_t numEvents = std::max<size_t>(bankNumEvents[i], 1);
+    const size_t sliceSize = loader.eventsPerSlice(numEvents);
+    const size_t slices = (numEvents + sliceSize - 1) / sliceSize;
+    numProg += slices * 3; // 3 = proc task
+    if (loader.splitProcessing)
+      numProg += slices * 3; // 3 = second proc task
+  }
   auto prog = std::make_unique<API::Progress>(loader.alg, 0.3, 1.0, numProg);
 
   for (size_t i = bankRange.first; i < bankRange.second; i++) {
@@ -49,6 +66,7 @@ void DefaultEventLoader::load(LoadEventNexus *alg, EventWorkspaceCollection &ws,
   // Start and end all threads
   pool.joinAll();
   diskIOMutex.reset();
+  loader.logPipelineStatistics();
 }
 
 DefaultEventLoader::DefaultEventLoader(LoadEventNexus *alg,
@@ -82,6 +100,41 @@ DefaultEventLoader::DefaultEventLoader(LoadEventNexus *alg,
   // split banks up if the number of cores is more than twice the number of
   // banks
   splitProcessing = bool(numBanks * 2 < ThreadPool::getNumPhysicalCores());
+
+  // Events read but not processed yet are held in memory, so limit them to a
+  // few slices for each thread
+  maxEventsInFlight =
+      std::max<size_t>(ThreadPool::getNumPhysicalCores(), 1) *
+      SLICES_IN_FLIGHT_PER_THREAD * MIN_EVENTS_PER_SLICE;
+}
+
+/** The number of events of a bank read from the file in one go. Processing
+ * the first slices of a bank into event lists overlaps with reading the
+ * next ones.
+ * @param numEvents :: the number of events to load from the bank
+ * @return the number of events in a slice
+ */
+size_t DefaultEventLoader::eventsPerSlice(const size_t numEvents) const {
+  // Compressing the events changes the type of the event lists, so further
+  // events cannot be added to them: all events of a bank are needed at once.
+  if (alg->compressTolerance >= 0)
+    return std::max<size_t>(numEvents, 1);
+  const size_t sliceSize =
+      std::max(numEvents / SLICES_PER_BANK, MIN_EVENTS_PER_SLICE);
+  return std::min(sliceSize, MAX_EVENTS_PER_SLICE);
+}
+
+/// Report how long was spent reading and processing the events
+void DefaultEventLoader::logPipelineStatistics() const {
+  alg->getLogger().debug()
+      << "Read " << numSlices << " slices of events in "
+      << static_cast<double>(readTime) * 1e-6 << " s; processing them took "
+      << static_cast<double>(processTime) * 1e-6 << " s over all threads. "
+      << numSlicesSkipped
+      << " slices were skipped as none of their events were wanted. "
+      << numSlicesProcessedByReader
+      << " slices were processed by the reading thread as too many events "
+         "were waiting to be processed.\n";
 }
 
 std::pair<size_t, size_t>
@@ -0,0 +1,154 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2020 ISIS Rutherford Appleton Laboratory UKRI,
+//   NScD Oak Ridge National Laboratory, European Spallation Source,
+//   Institut Laue - Langevin & CSNS, Institute of High Energy Physics, CAS
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidDataHandling/EventIdRangeIndex.h"
+
+#include <Poco/File.h>
+#include <Poco/Timestamp.h>
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+
+namespace Mantid {
+namespace DataHandling {
+
+namespace {
+/// The cache is emptied if it holds more banks than this
+constexpr size_t MAX_CACHED_BANKS = 4096;
+/// Range of a block whose IDs are not known
+const std::pair<uint32_t, uint32_t>
+    UNKNOWN_RANGE(std::numeric_limits<uint32_t>::max(), 0);
+
+std::mutex cacheMutex;
+std::unordered_map<std::string, std::shared_ptr<const EventIdRangeIndex>>
+    cache;
+} // namespace
+
+/** Constructor, with the ranges of all blocks unknown
+ * @param numEvents :: the number of events in the bank
+ */
+EventIdRangeIndex::EventIdRangeIndex(const size_t numEvents)
+    : m_numEvents(numEvents),
+      m_ranges((numEvents + EVENTS_PER_BLOCK - 1) / EVENTS_PER_BLOCK,
+               UNKNOWN_RANGE) {}
+
+/// Return the number of events in the bank
+size_t EventIdRangeIndex::numEvents() const { return m_numEvents; }
+
+/** Record the range of the IDs of the blocks fully covered by some events
+ * @param start :: index of the first event in the bank
+ * @param ids :: the IDs of the events
+ * @param count :: the number of events
+ */
+void EventIdRangeIndex::addEvents(const size_t start, const uint32_t *ids,
+                                  const size_t count) {
+  const size_t stop = std::min(start + count, m_numEvents);
+  size_t block = (start + EVENTS_PER_BLOCK - 1) / EVENTS_PER_BLOCK;
+  for (; block < m_ranges.size(); ++block) {
+    const size_t blockStart = block * EVENTS_PER_BLOCK;
+    const size_t blockStop =
+        std::min(blockStart + EVENTS_PER_BLOCK, m_numEvents);
+    if (blockStop > stop)
+      break;
+    const auto range = std::minmax_element(ids + (blockStart - start),
+                                           ids + (blockStop - start));
+    m_ranges[block] = {*range.first, *range.second};
+  }
+}
+
+/** Add the ranges known to another index of the same bank
+ * @param other :: the other index
+ */
+void EventIdRangeIndex::merge(const EventIdRangeIndex &other) {
+  if (other.m_numEvents != m_numEvents)
+    return;
+  for (size_t block = 0; block < m_ranges.size(); ++block)
+    if (m_ranges[block] == UNKNOWN_RANGE)
+      m_ranges[block] = other.m_ranges[block];
+}
+
+/** Narrow a range of events down to the blocks that may hold IDs in the
+ * range [minId, maxId]. Only blocks at either end are left out: a block in
+ * the middle is read even if it holds none of the IDs.
+ * @param start :: index of the first event of the range
+ * @param stop :: index after the last event of the range
+ * @param minId :: the smallest ID wanted
+ * @param maxId :: the largest ID wanted
+ * @return the narrowed range of events; empty if none may be wanted
+ */
+std::pair<size_t, size_t>
+EventIdRangeIndex::narrow(const size_t start, const size_t stop,
+                          const uint32_t minId, const uint32_t maxId) const {
+  const auto mayHold = [&](const size_t block) {
+    if (block >= m_ranges.size())
+      return true;
+    const auto &range = m_ranges[block];
+    return range == UNKNOWN_RANGE ||
+           (range.first <= maxId && range.second >= minId);
+  };
+  if (start >= stop)
+    return {stop, stop};
+  size_t first = start / EVENTS_PER_BLOCK;
+  size_t last = (stop - 1) / EVENTS_PER_BLOCK;
+  while (first <= last && !mayHold(first))
+    ++first;
+  if (first > last)
+    return {stop, stop};
+  while (!mayHold(last))
+    --last;
+  return {std::max(start, first * EVENTS_PER_BLOCK),
+          std::min(stop, (last + 1) * EVENTS_PER_BLOCK)};
+}
+
+/** The key identifying a bank in the cache. It includes the modification
+ * time and size of the file, so a rewritten file is not matched.
+ * @param filename :: the full path of the file
+ * @param entryName :: the top level entry
+ * @param bankName :: the name of the NXevent_data group
+ * @return the key
+ */
+std::string EventIdRangeIndex::cacheKey(const std::string &filename,
+                                        const std::string &entryName,
+                                        const std::string &bankName) {
+  Poco::File file(filename);
+  return filename + ':' +
+         std::to_string(file.getLastModified().epochMicroseconds()) + ':' +
+         std::to_string(file.getSize()) + ':' + entryName + '/' + bankName;
+}
+
+/** Look up the index of a bank
+ * @param key :: the key made by cacheKey()
+ * @return the index; NULL if the bank has not been read before
+ */
+std::shared_ptr<const EventIdRangeIndex>
+EventIdRangeIndex::findInCache(const std::string &key) {
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  const auto found = cache.find(key);
+  return found == cache.end() ? nullptr : found->second;
+}
+
+/** Keep the index of a bank for later loads of the same file
+ * @param key :: the key made by cacheKey()
+ * @param index :: the index
+ */
+void EventIdRangeIndex::storeInCache(
+    const std::string &key, std::shared_ptr<const EventIdRangeIndex> index) {
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  if (cache.size() >= MAX_CACHED_BANKS)
+    cache.clear();
+  cache[key] = std::move(index);
+}
+
+/// Forget the indices of all banks
+void EventIdRangeIndex::clearCache() {
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  cache.clear();
+}
+
+} // namespace DataHandling
+} // namespace Mantid
@@ -114,9 +114,14 @@ void EventWorkspaceCollection::setNPeriods(
   }
 }
 
+/** Reserve room for more events in a spectrum of every period workspace
+ * @param wi :: the workspace index of the spectrum
+ * @param size :: the number of events to add on top of those already held
+ */
 void EventWorkspaceCollection::reserveEventListAt(size_t wi, size_t size) {
   for (auto &ws : m_WsVec) {
-    ws->getSpectrum(wi).reserve(size);
+    auto &events = ws->getSpectrum(wi);
+    events.reserve(events.getNumberEvents() + size);
   }
 }
 
@@ -6,9 +6,12 @@
 // SPDX - License - Identifier: GPL - 3.0 +
 #include "MantidDataHandling/LoadBankFromDiskTask.h"
 #include "MantidDataHandling/BankPulseTimes.h"
+#include "MantidDataHandling/BankSliceQueue.h"
 #include "MantidDataHandling/DefaultEventLoader.h"
+#include "MantidDataHandling/EventIdRangeIndex.h"
 #include "MantidDataHandling/LoadEventNexus.h"
 #include "MantidDataHandling/ProcessBankData.h"
+#include "MantidKernel/Timer.h"
 #include "MantidKernel/Unit.h"
 #include <algorithm>
 
@@ -37,8 +40,11 @@ LoadBankFromDiskTask::LoadBankFromDiskTask(
     const std::vector<int> &framePeriodNumbers)
     : m_loader(loader), entry_name(entry_name), entry_type(entry_type),
       prog(prog), scheduler(scheduler), m_loadError(false),
-      m_oldNexusFileNames(oldNeXusFileNames), m_have_weight(false),
-      m_framePeriodNumbers(framePeriodNumbers) {
+      m_oldNexusFileNames(oldNeXusFileNames), m_numBankEvents(0),
+      m_have_weight(false), m_framePeriodNumbers(framePeriodNumbers),
+      m_lowIdSlices(std::make_shared<BankSliceQueue>(scheduler)),
+      m_highIdSlices(std::make_shared<BankSliceQueue>(scheduler)),
+      m_splitId(std::numeric_limits<uint32_t>::max()), m_firstSlice(true) {
   setMutex(ioMutex);
   m_cost = static_cast<double>(numEvents);
   m_min_id = std::numeric_limits<uint32_t>::max();
@@ -82,17 +88,56 @@ void LoadBankFromDiskTask::loadPulseTimes(::NeXus::File &file) {
 
 /** Load the event_index field
  * (a list of size of # of pulses giving the index in the event list for that
-    pulse)
+    pulse). When filtering by time only the entries of the pulses in the time
+    window are read; the entries before and after it are filled in so the
+    list stays sorted and the other pulses have no events. The pulse times
+    must have been loaded.
  * @param file :: File handle for the NeXus file
  */
 std::vector<uint64_t>
 LoadBankFromDiskTask::loadEventIndex(::NeXus::File &file) {
+  file.openData("event_index");
+  const auto dims = file.getInfo().dims;
+  file.closeData();
+  const size_t numEntries = dims.empty() ? 0 : static_cast<size_t>(dims[0]);
+
+  // The window of pulses in the time filter, with the same bounds as used by
+  // prepareEventId(): the entry after the last pulse gives the stop event
+  const size_t numPulses = std::min(numEntries, thisBankPulseTimes->numPulses);
+  const auto pulseTimes = thisBankPulseTimes->pulseTimes;
+  const bool pulseTimesSorted =
+      std::is_sorted(pulseTimes, pulseTimes + numPulses);
+  size_t firstPulse = 0;
+  while (firstPulse < numPulses &&
+         pulseTimes[firstPulse] < m_loader.alg->filter_time_start)
+    ++firstPulse;
+  size_t stopPulse = firstPulse;
+  while (stopPulse < numPulses &&
+         pulseTimes[stopPulse] <= m_loader.alg->filter_time_stop)
+    ++stopPulse;
+  const size_t windowEnd = std::min(stopPulse + 1, numEntries);
+
   // Get the event_index (a list of size of # of pulses giving the index in
   // the event list for that pulse) as a uint64 vector.
   // The Nexus standard does not specify if this is to be 32-bit or 64-bit
   // integers, so we use the NeXusIOHelper to do the conversion on the fly.
-  auto event_index =
-      NeXus::NeXusIOHelper::readNexusVector<uint64_t>(file, "event_index");
+  std::vector<uint64_t> event_index;
+  if (numEntries <= 1 || m_loader.chunk != EMPTY_INT() || !pulseTimesSorted ||
+      firstPulse == numPulses || (firstPulse == 0 && windowEnd == numEntries)) {
+    event_index =
+        NeXus::NeXusIOHelper::readNexusVector<uint64_t>(file, "event_index");
+  } else {
+    const auto window = NeXus::NeXusIOHelper::readNexusSlab<uint64_t>(
+        file, "event_index", {static_cast<int64_t>(firstPulse)},
+        {static_cast<int64_t>(windowEnd - firstPulse)});
+    event_index.reserve(numEntries);
+    event_index.assign(firstPulse, window.front());
+    event_index.insert(event_index.end(), window.cbegin(), window.cend());
+    event_index.resize(numEntries, window.back());
+    m_loader.alg->getLogger().debug()
+        << entry_name << ": read event_index of pulses " << firstPulse
+        << " to " << windowEnd << " of " << numEntries << "\n";
+  }
 
   // Look for the sign that the bank is empty
   if (event_index.size() == 1) {
@@ -130,6 +175,7 @@ void LoadBankFromDiskTask::prepareEventId(
   // account
   int64_t dim0 = recalculateDataSize(id_info.dims[0]);
   stop_event = dim0;
+  m_numBankEvents = static_cast<size_t>(dim0);
 
   // Handle the time filtering by changing the start/end offsets.
   for (size_t i = 0; i < thisBankPulseTimes->numPulses; i++) {
@@ -173,18 +219,24 @@ void LoadBankFromDiskTask::prepareEventId(
   // Make sure it is within range
   if (stop_event > dim0)
     stop_event = dim0;
+  file.closeData();
 
   m_loader.alg->getLogger().debug()
       << entry_name << ": start_event " << start_event << " stop_event "
       << stop_event << "\n";
 }
 
-/** Load the event_id field, which has been opened
+/** Load the event_id field for the slice of events being read
  * @param file An NeXus::File object opened at the correct group
- * @returns A new array containing the event Ids for this bank
+ * @returns A new array containing the event Ids for this slice
  */
 std::unique_ptr<std::vector<uint32_t>>
 LoadBankFromDiskTask::loadEventId(::NeXus::File &file) {
+  if (m_oldNexusFileNames)
+    file.openData("event_pixel_id");
+  else
+    file.openData("event_id");
+
   // This is the data size
   ::NeXus::Info id_info = file.getInfo();
   int64_t dim0 = recalculateDataSize(id_info.dims[0]);
@@ -222,12 +274,8 @@ LoadBankFromDiskTask::loadEventId(::NeXus::File &file) {
     m_max_id =
         *(std::max_element(event_id->data(), event_id->data() + m_loadSize[0]));
 
-    if (m_min_id > static_cast<uint32_t>(m_loader.eventid_max)) {
-      // All the detector IDs in the bank are higher than the highest 'known'
-      // (from the IDF)
-      // ID. Setting this will abort the loading of the bank.
-      m_loadError = true;
-    }
+    // If all the detector IDs are higher than the highest 'known' (from the
+    // IDF) ID, the range becomes empty below and the slice is skipped.
     // fixup the minimum pixel id in the case that it's lower than the lowest
     // 'known' id. We test this by checking that when we add the offset we
     // would not get a negative index into the vector. Note that m_min_id is
@@ -345,10 +393,7 @@ void LoadBankFromDiskTask::run() {
 
   prog->report(entry_name + ": load from disk");
 
-  // arrays to load into
-  std::unique_ptr<std::vector<uint32_t>> event_id;
-  std::unique_ptr<std::vector<float>> event_time_of_flight;
-  std::unique_ptr<std::vector<float>> event_weight;
+  // array to load into
   std::vector<uint64_t> event_index;
 
   // Open the file
@@ -359,13 +404,12 @@ void LoadBankFromDiskTask::run() {
     // Open the bankN_event group
     file.openGroup(entry_name, entry_type);
 
-    // Load the event_index field.
+    // Load the pulse times, then the part of the event_index field needed
+    // for them
+    this->loadPulseTimes(file);
     event_index = this->loadEventIndex(file);
 
     if (!m_loadError) {
-      // Load and validate the pulse times
-      this->loadPulseTimes(file);
-
       // The event_index should be the same length as the pulse times from DAS
       // logs.
       if (event_index.size() != thisBankPulseTimes->numPulses)
@@ -379,25 +423,88 @@ void LoadBankFromDiskTask::run() {
       int64_t stop_event = 0;
       this->prepareEventId(file, start_event, stop_event, event_index);
 
-      // These are the arguments to getSlab()
-      m_loadStart[0] = start_event;
-      m_loadSize[0] = stop_event - start_event;
-
-      if ((m_loadSize[0] > 0) && (m_loadStart[0] >= 0)) {
-        // Load pixel IDs
-        event_id = this->loadEventId(file);
-        if (m_loader.alg->getCancel()) {
-          m_loader.alg->getLogger().error()
-              << "Loading bank " << entry_name << " is cancelled.\n";
-          m_loadError = true; // To allow cancelling the algorithm
+      // Read the events in slices. Each slice is handed over to be processed
+      // as soon as it is read, while the next one is read.
+      const auto numEvents = stop_event - start_event;
+      const auto sliceSize = static_cast<int64_t>(
+          m_loader.eventsPerSlice(static_cast<size_t>(std::max(
+              numEvents, static_cast<int64_t>(0)))));
+      auto event_index_shrd =
+          std::make_shared<std::vector<uint64_t>>(std::move(event_index));
+
+      // Ranges of event IDs seen when this bank was read before, and now
+      const auto wantedIds = this->wantedIdRange();
+      const auto indexKey = EventIdRangeIndex::cacheKey(
+          m_loader.alg->m_filename, m_loader.alg->m_top_entry_name,
+          entry_name);
+      const auto knownIds = EventIdRangeIndex::findInCache(indexKey);
+      auto seenIds = std::make_shared<EventIdRangeIndex>(m_numBankEvents);
+
+      if ((numEvents > 0) && (start_event >= 0)) {
+        for (int64_t sliceStart = start_event;
+             sliceStart < stop_event && !m_loadError;
+             sliceStart += sliceSize) {
+          // Leave out the blocks known to hold none of the wanted IDs
+          std::pair<size_t, size_t> toRead(
+              sliceStart, std::min(sliceStart + sliceSize, stop_event));
+          if (knownIds)
+            toRead = knownIds->narrow(toRead.first, toRead.second,
+                                      wantedIds.first, wantedIds.second);
+          if (toRead.first == toRead.second) {
+            ++m_loader.numSlicesSkipped;
+            continue;
+          }
+
+          // These are the arguments to getSlab()
+          m_loadStart[0] = static_cast<int64_t>(toRead.first);
+          m_loadSize[0] = static_cast<int64_t>(toRead.second - toRead.first);
+          Kernel::Timer readTimer;
+
+          // Load pixel IDs
+          std::unique_ptr<std::vector<uint32_t>> event_id =
+              this->loadEventId(file);
+          if (m_loader.alg->getCancel()) {
+            m_loader.alg->getLogger().error()
+                << "Loading bank " << entry_name << " is cancelled.\n";
+            m_loadError = true; // To allow cancelling the algorithm
+          }
+          if (!m_loadError)
+            seenIds->addEvents(toRead.first, event_id->data(),
+                               event_id->size());
+
+          // The rest is not needed if none of the events can be loaded
+          if (!m_loadError && std::max(m_min_id, wantedIds.first) >
+                                  std::min(m_max_id, wantedIds.second)) {
+            ++m_loader.numSlicesSkipped;
+            m_loader.readTime +=
+                static_cast<int64_t>(readTimer.elapsed_no_reset() * 1e6);
+            continue;
+          }
+
+          // And TOF.
+          std::unique_ptr<std::vector<float>> event_time_of_flight;
+          std::unique_ptr<std::vector<float>> event_weight;
+          if (!m_loadError) {
+            event_time_of_flight = this->loadTof(file);
+            if (m_have_weight) {
+              event_weight = this->loadEventWeights(file);
+            }
+          }
+          m_loader.readTime +=
+              static_cast<int64_t>(readTimer.elapsed_no_reset() * 1e6);
+
+          if (!m_loadError)
+            this->processSlice(std::move(event_id),
+                               std::move(event_time_of_flight),
+                               std::move(event_weight), event_index_shrd,
+                               sliceSize < numEvents);
         }
 
-        // And TOF.
+        // Keep what was learnt about the event IDs for the next load
         if (!m_loadError) {
-          event_time_of_flight = this->loadTof(file);
-          if (m_have_weight) {
-            event_weight = this->loadEventWeights(file);
-          }
+          if (knownIds)
+            seenIds->merge(*knownIds);
+          EventIdRangeIndex::storeInCache(indexKey, std::move(seenIds));
         }
       } // Size is at least 1
       else {
@@ -405,8 +512,8 @@ void LoadBankFromDiskTask::run() {
         m_loader.alg->getLogger().error()
             << "Loading bank " << entry_name
             << " is stopped due to either zero/negative loading size ("
-            << m_loadStart[0] << ") or negative load start index ("
-            << m_loadStart[0] << ")\n";
+            << numEvents << ") or negative load start index ("
+            << start_event << ")\n";
         m_loadError = true;
       }
 
@@ -428,11 +535,27 @@ void LoadBankFromDiskTask::run() {
   file.closeGroup();
   file.close();
 
-  // Abort if anything failed
-  if (m_loadError) {
-    return;
-  }
+  // Pass on any failure of processing done in this task
+  if (m_processingError)
+    std::rethrow_exception(m_processingError);
+}
 
+/** Hand a slice of events that has been read over to be processed into the
+ * event lists. The processing is scheduled on the thread pool, unless too
+ * many events are already waiting to be processed: the slice is then
+ * processed straight away, which holds up further reading.
+ * @param event_id :: the pixel IDs of the slice
+ * @param event_time_of_flight :: the times-of-flight of the slice
+ * @param event_weight :: the weights of the slice, if any
+ * @param event_index :: the index of the first event of each pulse
+ * @param sliced :: true if the bank is read in more than one slice
+ */
+void LoadBankFromDiskTask::processSlice(
+    std::unique_ptr<std::vector<uint32_t>> event_id,
+    std::unique_ptr<std::vector<float>> event_time_of_flight,
+    std::unique_ptr<std::vector<float>> event_weight,
+    const std::shared_ptr<std::vector<uint64_t>> &event_index,
+    const bool sliced) {
   const auto bank_size = m_max_id - m_min_id;
   const auto minSpectraToLoad = static_cast<uint32_t>(m_loader.alg->m_specMin);
   const auto maxSpectraToLoad = static_cast<uint32_t>(m_loader.alg->m_specMax);
@@ -461,39 +584,107 @@ void LoadBankFromDiskTask::run() {
     return;
   }
 
-  // schedule the job to generate the event lists
-  auto mid_id = m_max_id;
-  if (m_loader.splitProcessing && m_max_id > (m_min_id + (bank_size / 4)))
-    // only split if told to and the section to load is at least 1/4 the size
-    // of the whole bank
-    mid_id = (m_max_id + m_min_id) / 2;
+  // Choose where to split the processing from the first slice, so that each
+  // pixel is always filled by the same one of the two halves
+  if (m_firstSlice) {
+    m_firstSlice = false;
+    if (m_loader.splitProcessing && m_max_id > (m_min_id + (bank_size / 4)))
+      // only split if told to and the section to load is at least 1/4 the
+      // size of the whole bank
+      m_splitId = (m_max_id + m_min_id) / 2;
+  }
 
   // No error? Launch a new task to process that data.
   auto numEvents = static_cast<size_t>(m_loadSize[0]);
   auto startAt = static_cast<size_t>(m_loadStart[0]);
 
+  // The events are held until every task processing them is done with them
+  const size_t numTasks =
+      (m_min_id <= m_splitId ? 1 : 0) + (m_max_id > m_splitId ? 1 : 0);
+  const size_t eventsHeld = numEvents * numTasks;
+  auto &loader = m_loader;
+  loader.eventsInFlight += eventsHeld;
+  ++loader.numSlices;
+
   // convert things to shared_arrays to share between tasks
-  std::shared_ptr<std::vector<uint32_t>> event_id_shrd(event_id.release());
+  std::shared_ptr<std::vector<uint32_t>> event_id_shrd(
+      event_id.release(),
+      [&loader, eventsHeld](std::vector<uint32_t> *ids) {
+        loader.eventsInFlight -= eventsHeld;
+        delete ids;
+      });
   std::shared_ptr<std::vector<float>> event_time_of_flight_shrd(
       event_time_of_flight.release());
   std::shared_ptr<std::vector<float>> event_weight_shrd(event_weight.release());
-  auto event_index_shrd =
-      std::make_shared<std::vector<uint64_t>>(std::move(event_index));
-
-  std::shared_ptr<Task> newTask1 = std::make_shared<ProcessBankData>(
-      m_loader, entry_name, prog, event_id_shrd, event_time_of_flight_shrd,
-      numEvents, startAt, event_index_shrd, thisBankPulseTimes, m_have_weight,
-      event_weight_shrd, m_min_id, mid_id);
-  scheduler.push(newTask1);
-  if (m_loader.splitProcessing && (mid_id < m_max_id)) {
-    std::shared_ptr<Task> newTask2 = std::make_shared<ProcessBankData>(
-        m_loader, entry_name, prog, event_id_shrd, event_time_of_flight_shrd,
-        numEvents, startAt, event_index_shrd, thisBankPulseTimes, m_have_weight,
-        event_weight_shrd, (mid_id + 1), m_max_id);
-    scheduler.push(newTask2);
+
+  // The slices of a bank are processed in the order they were read, so that
+  // the events of each pixel stay sorted by pulse time
+  std::vector<std::pair<std::shared_ptr<Task>, BankSliceQueue *>> tasks;
+  if (m_min_id <= m_splitId) {
+    tasks.emplace_back(
+        std::make_shared<ProcessBankData>(
+            m_loader, entry_name, prog, event_id_shrd,
+            event_time_of_flight_shrd, numEvents, startAt, event_index,
+            thisBankPulseTimes, m_have_weight, event_weight_shrd, m_min_id,
+            std::min(m_max_id, m_splitId)),
+        m_lowIdSlices.get());
+  }
+  if (m_max_id > m_splitId) {
+    tasks.emplace_back(
+        std::make_shared<ProcessBankData>(
+            m_loader, entry_name, prog, event_id_shrd,
+            event_time_of_flight_shrd, numEvents, startAt, event_index,
+            thisBankPulseTimes, m_have_weight, event_weight_shrd,
+            std::max(m_min_id, m_splitId + 1), m_max_id),
+        m_highIdSlices.get());
+  }
+  event_id_shrd.reset();
+
+  if (!sliced) {
+    for (auto &task : tasks)
+      scheduler.push(task.first);
+    return;
+  }
+
+  // Process the slice here if other slices already use up the budget, unless
+  // another thread is already processing the earlier slices
+  const bool processHere = loader.eventsInFlight > loader.maxEventsInFlight &&
+                           loader.eventsInFlight > eventsHeld;
+  for (auto &task : tasks) {
+    if (!processHere) {
+      task.second->push(task.first);
+      continue;
+    }
+    try {
+      if (task.second->pushAndRun(task.first))
+        ++loader.numSlicesProcessedByReader;
+    } catch (...) {
+      m_processingError = std::current_exception();
+      m_loadError = true;
+      return;
+    }
   }
 }
 
+/** The range of event IDs that can be loaded: those known to the instrument
+ * and within the range of spectra requested.
+ * @return the smallest and the largest ID wanted
+ */
+std::pair<uint32_t, uint32_t> LoadBankFromDiskTask::wantedIdRange() const {
+  uint32_t minId = 0;
+  if (m_loader.pixelID_to_wi_offset < 0)
+    minId = static_cast<uint32_t>(-m_loader.pixelID_to_wi_offset);
+  auto maxId = static_cast<uint32_t>(m_loader.eventid_max);
+  const auto minSpectraToLoad = static_cast<uint32_t>(m_loader.alg->m_specMin);
+  const auto maxSpectraToLoad = static_cast<uint32_t>(m_loader.alg->m_specMax);
+  const auto emptyInt = static_cast<uint32_t>(EMPTY_INT());
+  if (minSpectraToLoad != emptyInt)
+    minId = std::max(minId, minSpectraToLoad);
+  if (maxSpectraToLoad != emptyInt)
+    maxId = std::min(maxId, maxSpectraToLoad);
+  return {minId, maxId};
+}
+
 /**
  * Interpret the value describing the number of events. If the number is
  * positive return it unchanged.
@@ -150,11 +150,26 @@ void LoadEventNexus::init() {
                   "Optional: To only include events before the provided stop "
                   "time, in seconds (relative to the start of the run).");
 
+  auto pulseIndexValidator = std::make_shared<BoundedValidator<int>>();
+  pulseIndexValidator->setLower(0);
+  declareProperty("FilterByPulseIndexStart", EMPTY_INT(), pulseIndexValidator,
+                  "Optional: To only include events from this pulse onwards. "
+                  "Pulses are counted from 0 at the start of the run. Only "
+                  "the part of each bank covering the requested pulses is "
+                  "read from the file.");
+
+  declareProperty("FilterByPulseIndexStop", EMPTY_INT(), pulseIndexValidator,
+                  "Optional: To only include events from pulses before this "
+                  "one. Can be combined with FilterByTimeStart/Stop, in which "
+                  "case both filters are applied.");
+
   std::string grp1 = "Filter Events";
   setPropertyGroup("FilterByTofMin", grp1);
   setPropertyGroup("FilterByTofMax", grp1);
   setPropertyGroup("FilterByTimeStart", grp1);
   setPropertyGroup("FilterByTimeStop", grp1);
+  setPropertyGroup("FilterByPulseIndexStart", grp1);
+  setPropertyGroup("FilterByPulseIndexStop", grp1);
 
   declareProperty(
       std::make_unique<ArrayProperty<string>>("BankName", Direction::Input),
@@ -926,6 +941,29 @@ void LoadEventNexus::loadEvents(API::Progress *const prog,
       is_time_filtered = true;
     }
 
+    // A range of pulses is turned into a range of pulse times, so the banks
+    // only read the events of those pulses
+    const int pulse_index_start = getProperty("FilterByPulseIndexStart");
+    const int pulse_index_stop = getProperty("FilterByPulseIndexStop");
+    const auto numPulses = m_allBanksPulseTimes->numPulses;
+    if (pulse_index_start != EMPTY_INT()) {
+      if (static_cast<size_t>(pulse_index_start) >= numPulses)
+        throw std::invalid_argument(
+            "FilterByPulseIndexStart is past the last pulse of the run.");
+      filter_time_start =
+          std::max(filter_time_start,
+                   m_allBanksPulseTimes->pulseTimes[pulse_index_start]);
+      is_time_filtered = true;
+    }
+    if (pulse_index_stop != EMPTY_INT() &&
+        static_cast<size_t>(pulse_index_stop) < numPulses) {
+      // The stop pulse itself is excluded
+      filter_time_stop = std::min(
+          filter_time_stop,
+          m_allBanksPulseTimes->pulseTimes[pulse_index_stop] - int64_t{1});
+      is_time_filtered = true;
+    }
+
     // Silly values?
     if (filter_time_stop < filter_time_start) {
       std::string msg = "Your ";
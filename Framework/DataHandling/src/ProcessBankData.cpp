@@ -68,6 +68,7 @@ getPulseIndex(const size_t event_index, const size_t last_pulse_index,
  * FIXME/TODO - split run() into readable methods
  */
 void ProcessBankData::run() { // override {
+  Kernel::Timer processTimer;
   // Local tof limits
   double my_shortest_tof =
       static_cast<double>(std::numeric_limits<uint32_t>::max()) * 0.1;
@@ -141,7 +142,7 @@ void ProcessBankData::run() { // override {
     const int periodIndex = logPeriodNumber - 1;
 
     const auto firstEventIndex = getFirstEventIndex(pulseIndex);
-    if (firstEventIndex > numEvents)
+    if (firstEventIndex >= numEvents)
       break;
 
     const auto lastEventIndex = getLastEventIndex(pulseIndex, NUM_PULSES);
@@ -262,6 +263,8 @@ void ProcessBankData::run() { // override {
     alg->bad_tofs += badTofs;
     alg->discarded_events += my_discarded_events;
   }
+  m_loader.processTime +=
+      static_cast<int64_t>(processTimer.elapsed_no_reset() * 1e6);
 
 #ifndef _WIN32
   alg->getLogger().debug() << "Time to process " << entry_name << " " << m_timer
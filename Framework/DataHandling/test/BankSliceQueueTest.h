@@ -0,0 +1,97 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2020 ISIS Rutherford Appleton Laboratory UKRI,
+//   NScD Oak Ridge National Laboratory, European Spallation Source,
+//   Institut Laue - Langevin & CSNS, Institute of High Energy Physics, CAS
+// SPDX - License - Identifier: GPL - 3.0 +
+#pragma once
+
+#include <cxxtest/TestSuite.h>
+
+#include "MantidDataHandling/BankSliceQueue.h"
+#include "MantidKernel/FunctionTask.h"
+#include "MantidKernel/ThreadPool.h"
+#include "MantidKernel/ThreadSchedulerMutexes.h"
+
+#include <algorithm>
+#include <atomic>
+
+using Mantid::DataHandling::BankSliceQueue;
+using namespace Mantid::Kernel;
+
+class BankSliceQueueTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static BankSliceQueueTest *createSuite() { return new BankSliceQueueTest(); }
+  static void destroySuite(BankSliceQueueTest *suite) { delete suite; }
+
+  void test_slices_are_processed_in_the_order_they_were_read() {
+    constexpr int64_t numSlices = 64;
+    constexpr int64_t pulsesPerSlice = 100;
+    std::vector<int64_t> pulseTimes;
+    std::atomic<int> running{0};
+    bool overlapped = false;
+
+    auto scheduler = new ThreadSchedulerMutexes;
+    ThreadPool pool(scheduler, 4);
+    auto queue = std::make_shared<BankSliceQueue>(*scheduler);
+    // Later slices cost more, so the scheduler would run them first
+    pool.schedule(std::make_shared<FunctionTask>([&]() {
+      for (int64_t slice = 0; slice < numSlices; ++slice) {
+        queue->push(std::make_shared<FunctionTask>(
+            [&, slice]() {
+              if (++running > 1)
+                overlapped = true;
+              for (int64_t pulse = 0; pulse < pulsesPerSlice; ++pulse)
+                pulseTimes.emplace_back(slice * pulsesPerSlice + pulse);
+              --running;
+            },
+            static_cast<double>(slice + 1)));
+      }
+    }));
+    pool.joinAll();
+
+    TS_ASSERT(!overlapped);
+    TS_ASSERT_EQUALS(pulseTimes.size(), numSlices * pulsesPerSlice);
+    TS_ASSERT(std::is_sorted(pulseTimes.cbegin(), pulseTimes.cend()));
+  }
+
+  void test_push_schedules_one_task_for_the_whole_queue() {
+    ThreadSchedulerFIFO scheduler;
+    auto queue = std::make_shared<BankSliceQueue>(scheduler);
+    std::vector<int> order;
+    for (int i = 0; i < 3; ++i)
+      queue->push(
+          std::make_shared<FunctionTask>([&order, i]() { order.push_back(i); }));
+    TS_ASSERT_EQUALS(scheduler.size(), 1);
+    TS_ASSERT(order.empty());
+
+    scheduler.pop(0)->run();
+    TS_ASSERT_EQUALS(order, std::vector<int>({0, 1, 2}));
+  }
+
+  void test_pushAndRun_runs_an_idle_queue_in_this_thread() {
+    ThreadSchedulerFIFO scheduler;
+    auto queue = std::make_shared<BankSliceQueue>(scheduler);
+    std::vector<int> order;
+    TS_ASSERT(queue->pushAndRun(
+        std::make_shared<FunctionTask>([&order]() { order.push_back(0); })));
+    TS_ASSERT_EQUALS(scheduler.size(), 0);
+    TS_ASSERT_EQUALS(order, std::vector<int>({0}));
+  }
+
+  void test_pushAndRun_leaves_the_task_to_the_scheduled_run() {
+    ThreadSchedulerFIFO scheduler;
+    auto queue = std::make_shared<BankSliceQueue>(scheduler);
+    std::vector<int> order;
+    queue->push(
+        std::make_shared<FunctionTask>([&order]() { order.push_back(0); }));
+    TS_ASSERT(!queue->pushAndRun(
+        std::make_shared<FunctionTask>([&order]() { order.push_back(1); })));
+    TS_ASSERT(order.empty());
+
+    scheduler.pop(0)->run();
+    TS_ASSERT_EQUALS(order, std::vector<int>({0, 1}));
+  }
+};
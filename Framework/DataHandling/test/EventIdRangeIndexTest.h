@@ -0,0 +1,101 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2020 ISIS Rutherford Appleton Laboratory UKRI,
+//   NScD Oak Ridge National Laboratory, European Spallation Source,
+//   Institut Laue - Langevin & CSNS, Institute of High Energy Physics, CAS
+// SPDX - License - Identifier: GPL - 3.0 +
+#pragma once
+
+#include <cxxtest/TestSuite.h>
+
+#include "MantidDataHandling/EventIdRangeIndex.h"
+
+using Mantid::DataHandling::EventIdRangeIndex;
+
+class EventIdRangeIndexTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static EventIdRangeIndexTest *createSuite() {
+    return new EventIdRangeIndexTest();
+  }
+  static void destroySuite(EventIdRangeIndexTest *suite) { delete suite; }
+
+  void test_unknown_blocks_are_not_narrowed() {
+    EventIdRangeIndex index(10 * BLOCK);
+    TS_ASSERT_EQUALS(index.numEvents(), 10 * BLOCK);
+    const auto range = index.narrow(5, 3 * BLOCK + 5, 100, 200);
+    TS_ASSERT_EQUALS(range.first, 5);
+    TS_ASSERT_EQUALS(range.second, 3 * BLOCK + 5);
+  }
+
+  void test_narrow_skips_blocks_without_wanted_ids() {
+    // Block i holds the IDs 1000 * i to 1000 * i + 999
+    const auto index = makeIndex(10);
+    auto range = index.narrow(0, 10 * BLOCK, 3500, 4500);
+    TS_ASSERT_EQUALS(range.first, 3 * BLOCK);
+    TS_ASSERT_EQUALS(range.second, 5 * BLOCK);
+    // The range is not widened
+    range = index.narrow(3 * BLOCK + 10, 4 * BLOCK + 10, 3500, 4500);
+    TS_ASSERT_EQUALS(range.first, 3 * BLOCK + 10);
+    TS_ASSERT_EQUALS(range.second, 4 * BLOCK + 10);
+    range = index.narrow(0, 10 * BLOCK, 20000, 30000);
+    TS_ASSERT_EQUALS(range.first, range.second);
+  }
+
+  void test_partly_seen_blocks_stay_unknown() {
+    EventIdRangeIndex index(4 * BLOCK);
+    std::vector<uint32_t> ids(2 * BLOCK, 7);
+    // Covers half of block 0, all of block 1 and half of block 2
+    index.addEvents(BLOCK / 2, ids.data(), ids.size());
+    const auto range = index.narrow(0, 4 * BLOCK, 100, 200);
+    TS_ASSERT_EQUALS(range.first, 0);
+    TS_ASSERT_EQUALS(range.second, 4 * BLOCK);
+    // Only block 1 is known not to hold the IDs
+    auto middle = index.narrow(BLOCK, 2 * BLOCK, 100, 200);
+    TS_ASSERT_EQUALS(middle.first, middle.second);
+  }
+
+  void test_short_last_block() {
+    EventIdRangeIndex index(BLOCK + 10);
+    std::vector<uint32_t> ids(BLOCK + 10, 7);
+    ids.back() = 150;
+    index.addEvents(0, ids.data(), ids.size());
+    const auto range = index.narrow(0, BLOCK + 10, 100, 200);
+    TS_ASSERT_EQUALS(range.first, BLOCK);
+    TS_ASSERT_EQUALS(range.second, BLOCK + 10);
+  }
+
+  void test_merge() {
+    EventIdRangeIndex first(2 * BLOCK);
+    EventIdRangeIndex second(2 * BLOCK);
+    std::vector<uint32_t> ids(BLOCK, 7);
+    first.addEvents(0, ids.data(), ids.size());
+    second.addEvents(BLOCK, ids.data(), ids.size());
+    first.merge(second);
+    const auto range = first.narrow(0, 2 * BLOCK, 100, 200);
+    TS_ASSERT_EQUALS(range.first, range.second);
+  }
+
+  void test_cache() {
+    EventIdRangeIndex::clearCache();
+    TS_ASSERT(!EventIdRangeIndex::findInCache("key"));
+    auto index = std::make_shared<EventIdRangeIndex>(makeIndex(2));
+    EventIdRangeIndex::storeInCache("key", index);
+    TS_ASSERT_EQUALS(EventIdRangeIndex::findInCache("key"), index);
+    EventIdRangeIndex::clearCache();
+    TS_ASSERT(!EventIdRangeIndex::findInCache("key"));
+  }
+
+private:
+  static constexpr size_t BLOCK = EventIdRangeIndex::EVENTS_PER_BLOCK;
+
+  EventIdRangeIndex makeIndex(const size_t numBlocks) {
+    EventIdRangeIndex index(numBlocks * BLOCK);
+    std::vector<uint32_t> ids(numBlocks * BLOCK);
+    for (size_t i = 0; i < ids.size(); ++i)
+      ids[i] = static_cast<uint32_t>(1000 * (i / BLOCK) + i % 1000);
+    index.addEvents(0, ids.data(), ids.size());
+    return index;
+  }
+};
@@ -23,6 +23,7 @@ using namespace Mantid::DataHandling;
 using namespace Mantid::DataObjects;
 using namespace Mantid::API;
 using namespace Mantid::Kernel;
+using Mantid::Types::Event::TofEvent;
 
 namespace {
 
@@ -173,4 +174,23 @@ public:
       TS_ASSERT_EQUALS(eventWS->sample().getThickness(), thickness);
     }
   }
+
+  void test_reserveEventListAt_adds_to_the_events_already_held() {
+    EventWorkspaceCollection collection;
+    auto periodLog =
+        std::make_unique<const TimeSeriesProperty<int>>("period_log");
+    collection.setNPeriods(2, periodLog);
+    collection.setIndexInfo(Indexing::IndexInfo({1, 2}));
+    auto &events = collection.getSpectrum(0, 0);
+    for (int i = 0; i < 5; ++i)
+      events += TofEvent(static_cast<double>(i));
+
+    collection.reserveEventListAt(0, 10);
+
+    TS_ASSERT_EQUALS(events.getNumberEvents(), 5);
+    TS_ASSERT_LESS_THAN_EQUALS(15 * sizeof(TofEvent) + sizeof(EventList),
+                               events.getMemorySize());
+    TS_ASSERT_LESS_THAN_EQUALS(10 * sizeof(TofEvent) + sizeof(EventList),
+                               collection.getSpectrum(0, 1).getMemorySize());
+  }
 };
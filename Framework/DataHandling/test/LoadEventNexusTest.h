@@ -909,6 +909,60 @@ public:
     do_test_filtering_start_and_end_filtered_loading(metadataonly);
   }
 
+  void test_pulse_index_filtered_loading() {
+    const std::string wsName = "test_pulse_filtering";
+    LoadEventNexus ld;
+    ld.initialize();
+    ld.setPropertyValue("OutputWorkspace", wsName);
+    ld.setPropertyValue("Filename", "CNCS_7860_event.nxs");
+    ld.setProperty("FilterByPulseIndexStart", 100);
+    ld.setProperty("FilterByPulseIndexStop", 1000);
+    TS_ASSERT(ld.execute());
+
+    auto outWs =
+        AnalysisDataService::Instance().retrieveWS<EventWorkspace>(wsName);
+    auto protonCharge = dynamic_cast<TimeSeriesProperty<double> *>(
+        outWs->run().getLogData("proton_charge"));
+    TS_ASSERT(protonCharge);
+    if (!protonCharge)
+      return;
+    // Only the logs of the pulses loaded are kept
+    TS_ASSERT_DELTA(protonCharge->size(), 900, 1);
+    const auto firstPulse = protonCharge->nthTime(0);
+    const auto lastPulse = protonCharge->nthTime(protonCharge->size() - 1);
+    TS_ASSERT_LESS_THAN(0, outWs->getNumberEvents());
+    for (size_t wi = 0; wi < outWs->getNumberHistograms(); wi += 100) {
+      for (const auto &event : outWs->getSpectrum(wi).getEvents()) {
+        TS_ASSERT(event.pulseTime() >= firstPulse);
+        TS_ASSERT(event.pulseTime() <= lastPulse);
+      }
+    }
+    AnalysisDataService::Instance().remove(wsName);
+  }
+
+  void test_pulse_index_stop_before_start_throws() {
+    LoadEventNexus ld;
+    ld.initialize();
+    ld.setRethrows(true);
+    ld.setPropertyValue("OutputWorkspace", "test_pulse_filtering");
+    ld.setPropertyValue("Filename", "CNCS_7860_event.nxs");
+    ld.setProperty("FilterByPulseIndexStart", 1000);
+    ld.setProperty("FilterByPulseIndexStop", 100);
+    TS_ASSERT_THROWS(ld.execute(), const std::invalid_argument &);
+  }
+
+  void test_chunk_and_spectrum_numbers_must_be_positive() {
+    LoadEventNexus ld;
+    ld.initialize();
+    for (const auto &name :
+         {"ChunkNumber", "TotalChunks", "SpectrumMin", "SpectrumMax"}) {
+      TS_ASSERT_THROWS(ld.setProperty(name, 0), const std::invalid_argument &);
+      TS_ASSERT_THROWS_NOTHING(ld.setProperty(name, 1));
+    }
+    // Pulses are counted from 0
+    TS_ASSERT_THROWS_NOTHING(ld.setProperty("FilterByPulseIndexStart", 0));
+  }
+
   void testSimulatedFile() {
     Mantid::API::FrameworkManager::Instance();
     LoadEventNexus ld;
@@ -412,6 +412,8 @@ private:
 
   void switchToWeightedEvents();
   void switchToWeightedEventsNoTime();
+  void mergeAppendedEvents(const size_t numSorted,
+                           const bool allowMerge = true);
   // should not be called externally
   void sortPulseTimeTOFDelta(const Types::Core::DateAndTime &start,
                              const double seconds) const;
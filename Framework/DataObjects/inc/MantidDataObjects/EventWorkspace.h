@@ -141,6 +141,8 @@ public:
 
   std::size_t MRUSize() const;
 
+  void setMRUMemoryBudget(const std::size_t memoryBudget) const;
+
   void clearMRU() const override;
 
   EventSortType getSortType() const;
@@ -7,16 +7,17 @@
 #pragma once
 
 #include "MantidHistogramData/HistogramE.h"
+#include "MantidHistogramData/HistogramX.h"
 #include "MantidHistogramData/HistogramY.h"
-#include "MantidKernel/Exception.h"
-#include "MantidKernel/MRUList.h"
 #include "MantidKernel/System.h"
 #include "MantidKernel/cow_ptr.h"
 
-#include "Poco/RWLock.h"
-
+#include <array>
+#include <atomic>
 #include <cstdint>
-#include <vector>
+#include <list>
+#include <mutex>
+#include <unordered_map>
 
 namespace Mantid {
 namespace DataObjects {
@@ -25,78 +26,91 @@ class EventList;
 
 //============================================================================
 //============================================================================
-/**
- * This little class holds data and an index marker that is used for uniqueness.
- * This is used in the MRUList.
- */
-template <class T> class TypeWithMarker {
-public:
-  /**
-   * Constructor.
-   * @param the_index :: unique index into the workspace of this data
-   */
-  TypeWithMarker(const uintptr_t the_index) : m_index(the_index) {}
-  TypeWithMarker(const TypeWithMarker &other) = delete;
-  TypeWithMarker &operator=(const TypeWithMarker &other) = delete;
-
-public:
-  /// Unique index value.
-  uintptr_t m_index;
-
-  /// Pointer to a vector of data
-  T m_data;
-
-  /// Function returns a unique index, used for hashing for MRU list
-  uintptr_t hashIndexFunction() const { return m_index; }
-
-  /// Set the unique index value.
-  void setIndex(const uintptr_t the_index) { m_index = the_index; }
-};
-
-//============================================================================
-//============================================================================
-/** This is a container for the MRU (most-recently-used) list
- * of generated histograms.
+/** This is a container for the MRU (most-recently-used) cache of histograms
+ * generated from the event lists of an EventWorkspace.
+ *
+ * The cache is shared by all threads and split into shards selected by the
+ * EventList address, each with its own lock and least-recently-used order,
+ * so threads histogramming different spectra rarely wait on each other and a
+ * histogram generated on one thread is found by all the others. The least
+ * recently used entries are evicted when the memory held exceeds a budget,
+ * set by the "eventworkspace.histogramcache.megabytes" configuration key by
+ * default.
+ *
+ * Each entry remembers the X (bin edges) it was generated with and is
+ * dropped on lookup if the EventList has been given different bin edges.
  */
 class DLLExport EventWorkspaceMRU {
 public:
+  using XType = Kernel::cow_ptr<HistogramData::HistogramX>;
   using YType = Kernel::cow_ptr<HistogramData::HistogramY>;
   using EType = Kernel::cow_ptr<HistogramData::HistogramE>;
-  using YWithMarker = TypeWithMarker<YType>;
-  using EWithMarker = TypeWithMarker<EType>;
-  // Typedef for a Most-Recently-Used list of Data objects.
-  using mru_listY = Kernel::MRUList<YWithMarker>;
-  using mru_listE = Kernel::MRUList<EWithMarker>;
 
-  ~EventWorkspaceMRU();
-
-  void ensureEnoughBuffersY(size_t thread_num) const;
-  void ensureEnoughBuffersE(size_t thread_num) const;
+  EventWorkspaceMRU();
+  explicit EventWorkspaceMRU(const size_t memoryBudget);
+  EventWorkspaceMRU(const EventWorkspaceMRU &) = delete;
+  EventWorkspaceMRU &operator=(const EventWorkspaceMRU &) = delete;
 
   void clear();
 
-  YType findY(size_t thread_num, const EventList *index);
-  EType findE(size_t thread_num, const EventList *index);
-  void insertY(size_t thread_num, YType data, const EventList *index);
-  void insertE(size_t thread_num, EType data, const EventList *index);
+  YType findY(const EventList *index, const XType &x);
+  EType findE(const EventList *index, const XType &x);
+  void insert(const EventList *index, const XType &x, YType y, EType e);
 
   void deleteIndex(const EventList *index);
 
-  /** Return how many entries in the Y MRU list are used.
-   * Only used in tests. It only returns the 0-th MRU list size.
-   * @return :: number of entries in the MRU list. */
-  size_t MRUSize() const;
+  void setMemoryBudget(const size_t memoryBudget);
+  size_t memoryBudget() const;
+  size_t memoryUsed() const;
 
-protected:
-  /// The most-recently-used list of dataY histograms
-  mutable std::vector<std::unique_ptr<mru_listY>> m_bufferedDataY;
+  /// Number of lookups that found a histogram
+  uint64_t hits() const { return m_hits.load(std::memory_order_relaxed); }
+  /// Number of lookups that had to generate the histogram again
+  uint64_t misses() const { return m_misses.load(std::memory_order_relaxed); }
 
-  /// The most-recently-used list of dataE histograms
-  mutable std::vector<std::unique_ptr<mru_listE>> m_bufferedDataE;
+  /** Return how many histograms are held in the cache.
+   * @return :: number of entries in the MRU cache. */
+  size_t MRUSize() const;
 
-  /// Mutex when adding entries in the MRU list
-  mutable Poco::RWLock m_changeMruListsMutexE;
-  mutable Poco::RWLock m_changeMruListsMutexY;
+private:
+  /// A cached histogram
+  struct Entry {
+    const EventList *index;
+    XType x;
+    YType y;
+    EType e;
+    size_t memory;
+    /// Value of the cache clock when last used
+    uint64_t lastUse;
+  };
+  /// One independently locked part of the cache
+  struct Shard {
+    std::mutex mutex;
+    /// Entries, most recently used first
+    std::list<Entry> entries;
+    std::unordered_map<const EventList *, std::list<Entry>::iterator> lookup;
+  };
+
+  Shard &shardFor(const EventList *index);
+  template <typename T>
+  T find(const EventList *index, const XType &x, T Entry::*member);
+  void erase(Shard &shard, std::list<Entry>::iterator entry);
+  void evictToBudget();
+
+  /// Number of shards, a power of two
+  static constexpr size_t NUM_SHARDS = 16;
+  std::array<Shard, NUM_SHARDS> m_shards;
+
+  /// Counts uses, to find the least recently used entry across all shards
+  std::atomic<uint64_t> m_clock{0};
+  /// Maximum memory held by the histograms, in bytes
+  std::atomic<size_t> m_memoryBudget;
+  /// Memory currently held by the histograms, in bytes
+  std::atomic<size_t> m_memoryUsed{0};
+  /// Number of entries in all the shards
+  std::atomic<size_t> m_size{0};
+  std::atomic<uint64_t> m_hits{0};
+  std::atomic<uint64_t> m_misses{0};
 };
 
 } // namespace DataObjects
@@ -151,6 +151,7 @@ public:
 
   // add range of events
   size_t addEvents(const std::vector<MDE> &events) override;
+  size_t addEvents(std::vector<MDE> &&events);
   // unhide MDBoxBase methods
   size_t addEventsUnsafe(const std::vector<MDE> &events) override;
 
@@ -151,9 +151,33 @@ TMDE(MDBox)::MDBox(const MDBox<MDE, nd> &other,
       this->setFileBacked();
   }
 }
-// unhide MDBoxBase method
+/** Add all of the events contained in a vector, with:
+ * - No bounds checking.
+ * - No thread-safety.
+ *
+ * @param events :: Vector of MDEvent
+ * @return always returns 0
+ */
 TMDE(size_t MDBox)::addEventsUnsafe(const std::vector<MDE> &events) {
-  return MDBoxBase<MDE, nd>::addEventsUnsafe(events);
+  // Copy all the events
+  this->data.insert(this->data.end(), events.cbegin(), events.cend());
+  return 0;
+}
+
+/** Add all events, taking over their storage if the box is empty. No bounds
+ * checking is made!
+ *
+ * @param events :: vector of events to be moved; left in an unspecified state
+ *
+ * @return always returns 0
+ */
+TMDE(size_t MDBox)::addEvents(std::vector<MDE> &&events) {
+  std::lock_guard<std::mutex> _lock(this->m_dataMutex);
+  if (this->data.empty())
+    this->data.swap(events);
+  else
+    this->data.insert(this->data.end(), events.cbegin(), events.cend());
+  return 0;
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -267,6 +291,8 @@ TMDE(std::vector<MDE> &MDBox)::getEvents() {
     return data;
   else {
     if (m_Saveable->wasSaved()) { // Load and concatenate the events if needed
+      this->m_BoxController->getFileIO()->recordAccess(
+          m_Saveable->isLoaded());
       m_Saveable
           ->load(); // this will set isLoaded to true if not already loaded;
     }
@@ -297,6 +323,8 @@ TMDE(const std::vector<MDE> &MDBox)::getConstEvents() const {
   else {
     if (m_Saveable->wasSaved()) {
       // Load and concatenate the events if needed
+      this->m_BoxController->getFileIO()->recordAccess(
+          m_Saveable->isLoaded());
       m_Saveable
           ->load(); // this will set isLoaded to true if not already loaded;
       // This access to data was const. Don't change the m_dataModified flag.
@@ -861,6 +889,22 @@ TMDE(size_t MDBox)::addEvents(const std::vector<MDE> &events) {
   return 0;
 }
 
+/** Add all events, taking over their storage if the box is empty. No bounds
+ * checking is made!
+ *
+ * @param events :: vector of events to be moved; left in an unspecified state
+ *
+ * @return always returns 0
+ */
+TMDE(size_t MDBox)::addEvents(std::vector<MDE> &&events) {
+  std::lock_guard<std::mutex> _lock(this->m_dataMutex);
+  if (this->data.empty())
+    this->data.swap(events);
+  else
+    this->data.insert(this->data.end(), events.cbegin(), events.cend());
+  return 0;
+}
+
 /**Make this box file-backed
  * @param fileLocation -- the starting position of this box data are/should be
  * located in the direct access file
@@ -8,6 +8,7 @@
 
 #include "MantidAPI/BoxController.h"
 #include "MantidDataObjects/MDBox.h"
+#include "MantidDataObjects/MDBoxMortonIndex.h"
 #include "MantidDataObjects/MDEventWorkspace.h"
 #include "MantidDataObjects/MDGridBox.h"
 #include "MantidKernel/Matrix.h"
@@ -43,6 +44,10 @@ public:
    * file */
   std::vector<uint64_t> &getEventIndex() { return m_BoxEventIndex; }
   const std::vector<int> &getBoxType() const { return m_BoxType; }
+  /**@return the boxes holding events in the order of their events on file */
+  std::vector<size_t> getBoxesInFileOrder() const;
+  /**@return the index of the boxes holding events by position in space */
+  MDBoxMortonIndex getMortonIndex() const;
 
   //---------------------------------------------------------------------------------------------------------------------
   /// convert MDWS box structure into flat structure used for saving/loading on
@@ -54,9 +59,8 @@ public:
                           API::BoxController_sptr &bc, bool FileBackEnd,
                           bool BoxStructureOnly = false);
 
-  /*** this function tries to set file positions of the boxes to
-        make data physically located close to each other to be as close as
-     possible on the HDD */
+  /*** this function sets the file positions of the boxes in Morton order, so
+     boxes close to each other in space are close to each other on the HDD */
   void setBoxesFilePositions(bool setFileBacked);
 
   /**Save flat box structure into a file, defined by the file name*/
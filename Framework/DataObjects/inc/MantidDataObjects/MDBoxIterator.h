@@ -102,6 +102,11 @@ private:
 
   void releaseEvents() const;
 
+  void prefetchAhead() const;
+
+  /// Number of boxes to load ahead of the current one when file-backed
+  static constexpr size_t PREFETCH_BOXES = 32;
+
   /// Current position in the vector of boxes
   size_t m_pos;
 
@@ -120,6 +125,9 @@ private:
   /// Pointer to the const events vector. Only initialized when needed.
   mutable const std::vector<MDE> *m_events;
 
+  /// Boxes before this position have been queued for prefetching
+  mutable size_t m_prefetchedTo;
+
   // Skipping policy, controlls recursive calls to next().
   SkippingPolicy_scptr m_skippingPolicy;
 };
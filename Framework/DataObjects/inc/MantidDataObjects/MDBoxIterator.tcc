@@ -4,11 +4,14 @@
 //   NScD Oak Ridge National Laboratory, European Spallation Source,
 //   Institut Laue - Langevin & CSNS, Institute of High Energy Physics, CAS
 // SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidAPI/BoxController.h"
 #include "MantidDataObjects/MDBoxBase.h"
 #include "MantidDataObjects/MDBoxIterator.h"
 #include "MantidGeometry/MDGeometry/MDImplicitFunction.h"
 #include "MantidKernel/System.h"
 
+#include <algorithm>
+
 namespace Mantid {
 namespace DataObjects {
 
@@ -29,6 +32,7 @@ TMDE(MDBoxIterator)::MDBoxIterator(
     API::IMDNode *topBox, size_t maxDepth, bool leafOnly,
     Mantid::Geometry::MDImplicitFunction *function)
     : m_pos(0), m_current(nullptr), m_currentMDBox(nullptr), m_events(nullptr),
+      m_prefetchedTo(0),
       m_skippingPolicy(new SkipMaskedBins(this)) {
   commonConstruct(topBox, maxDepth, leafOnly, function);
 }
@@ -52,6 +56,7 @@ TMDE(MDBoxIterator)::MDBoxIterator(
     SkippingPolicy *skippingPolicy,
     Mantid::Geometry::MDImplicitFunction *function)
     : m_pos(0), m_current(nullptr), m_currentMDBox(nullptr), m_events(nullptr),
+      m_prefetchedTo(0),
       m_skippingPolicy(skippingPolicy) {
   commonConstruct(topBox, maxDepth, leafOnly, function);
 }
@@ -104,6 +109,7 @@ TMDE(void MDBoxIterator)::commonConstruct(
 TMDE(MDBoxIterator)::MDBoxIterator(std::vector<API::IMDNode *> &boxes,
                                    size_t begin, size_t end)
     : m_pos(0), m_current(nullptr), m_currentMDBox(nullptr), m_events(nullptr),
+      m_prefetchedTo(0),
       m_skippingPolicy(new SkipMaskedBins(this))
 
 {
@@ -202,6 +208,7 @@ TMDE(void MDBoxIterator)::getEvents() const {
     if (!m_currentMDBox)
       m_currentMDBox = dynamic_cast<MDBox<MDE, nd> *>(m_current);
     if (m_currentMDBox) {
+      prefetchAhead();
       // Retrieve the event vector.
       m_events = &m_currentMDBox->getConstEvents();
     } else
@@ -210,6 +217,29 @@ TMDE(void MDBoxIterator)::getEvents() const {
   }
 }
 
+//----------------------------------------------------------------------------------------------
+/** For file-backed workspaces, queue the next boxes of the iteration to be
+ * loaded in the background, keeping up to 2 * PREFETCH_BOXES queued ahead of
+ * the current box.
+ */
+TMDE(void MDBoxIterator)::prefetchAhead() const {
+  if (m_prefetchedTo >= m_max || m_prefetchedTo > m_pos + PREFETCH_BOXES)
+    return;
+  API::BoxController *bc = m_current->getBoxController();
+  if (!bc || !bc->isFileBacked())
+    return;
+  const size_t begin = std::max(m_pos, m_prefetchedTo);
+  const size_t end = std::min(m_max, m_pos + 2 * PREFETCH_BOXES);
+  std::vector<Kernel::ISaveable *> toLoad;
+  toLoad.reserve(end - begin);
+  for (size_t i = begin; i < end; ++i) {
+    if (auto saveable = m_boxes[i]->getISaveable())
+      toLoad.emplace_back(saveable);
+  }
+  bc->getFileIO()->prefetch(toLoad);
+  m_prefetchedTo = end;
+}
+
 //----------------------------------------------------------------------------------------------
 /** After you're done with a given box, release the events list
  * (if it was retrieved)
@@ -0,0 +1,60 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2020 ISIS Rutherford Appleton Laboratory UKRI,
+//   NScD Oak Ridge National Laboratory, European Spallation Source,
+//   Institut Laue - Langevin & CSNS, Institute of High Energy Physics, CAS
+// SPDX - License - Identifier: GPL - 3.0 +
+#pragma once
+
+#include "MantidKernel/System.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Mantid {
+namespace DataObjects {
+
+/** MDBoxMortonIndex : index of the boxes holding events of a flattened MD box
+  tree (see MDBoxFlatTree), ordered by the Morton (Z-order) key of their lower
+  corner.
+
+  The space of the workspace is divided into 2^bitsPerDim cells along each
+  dimension and the cell numbers are interleaved into a 64-bit key, as in
+  MortonIndex/BitInterleaving.h.
+
+  Writing the events of the boxes in the order of this index keeps boxes that
+  are close in space close in the file.
+*/
+class DLLExport MDBoxMortonIndex {
+public:
+  /// A box holding events, with the key of its lower corner
+  struct Entry {
+    uint64_t lowKey;
+    uint64_t boxId;
+  };
+
+  MDBoxMortonIndex();
+  MDBoxMortonIndex(const size_t nDims, const std::vector<int> &boxType,
+                   const std::vector<double> &extents,
+                   const std::vector<uint64_t> &eventIndex);
+
+  /// The boxes holding events, in increasing order of key
+  const std::vector<Entry> &entries() const { return m_entries; }
+  /// The number of bits of each coordinate in a key
+  size_t bitsPerDim() const { return m_bitsPerDim; }
+
+  uint64_t key(const double *point) const;
+
+private:
+  /// Number of dimensions of the workspace
+  size_t m_nDims;
+  /// Number of bits of each coordinate in a key
+  size_t m_bitsPerDim;
+  /// Min/Max extents of the workspace in each dimension
+  std::vector<double> m_space;
+  /// The boxes holding events, in increasing order of key
+  std::vector<Entry> m_entries;
+};
+
+} // namespace DataObjects
+} // namespace Mantid
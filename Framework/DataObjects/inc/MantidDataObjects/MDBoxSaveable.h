@@ -9,6 +9,8 @@
 #include "MantidAPI/IMDNode.h"
 #include "MantidKernel/ISaveable.h"
 
+#include <mutex>
+
 namespace Mantid {
 namespace DataObjects {
 
@@ -50,6 +52,8 @@ public:
 
 private:
   API::IMDNode *const m_MDNode;
+  /// Stops the box being loaded twice when it is also being prefetched
+  std::mutex m_loadMutex;
 };
 } // namespace DataObjects
 } // namespace Mantid
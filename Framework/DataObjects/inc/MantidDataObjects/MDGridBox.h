@@ -138,6 +138,7 @@ public:
   //----------------------------------------------------------------------------------------------------------------------
   size_t addEvent(const MDE &event) override;
   size_t addEventUnsafe(const MDE &event) override;
+  size_t addEvents(const std::vector<MDE> &events) override;
 
   /*--------------->  EVENTS from event data
    * <-------------------------------------------------------------*/
@@ -224,6 +225,8 @@ public:
 private:
   /// Compute the index of the child box for the given event
   size_t calculateChildIndex(const MDE &event) const;
+  size_t addEventsByChild(const std::vector<MDE> &events,
+                          const bool checkBounds);
 
   /// Each dimension is split into this many equally-sized boxes
   size_t split[nd];
@@ -18,6 +18,7 @@
 #include "MantidKernel/WarningSuppressions.h"
 #include <boost/math/special_functions/round.hpp>
 #include <boost/optional.hpp>
+#include <algorithm>
 #include <ostream>
 
 // These pragmas ignores the warning in the ctor where "d<nd-1" for nd=1.
@@ -111,9 +112,8 @@ TMDE(MDGridBox)::MDGridBox(MDBox<MDE, nd> *box)
   // Prepare to distribute the events that were in the box before, this will
   // load missing events from HDD in file based ws if there are some.
   const std::vector<MDE> &events = box->getConstEvents();
-  // just add event to the existing internal box
-  for (const auto &evnt : events)
-    addEvent(evnt);
+  // each new box gets all of its events at once
+  addEventsByChild(events, false);
 
   // Copy the cached numbers from the incoming box. This is quick - don't need
   // to refresh cache
@@ -1665,6 +1665,24 @@ TMDE(void MDGridBox)::buildAndAddEventUnsafe(const signal_t Signal,
                                                 runIndex, detectorId));
 }
 
+//-----------------------------------------------------------------------------------------------
+/** Add several events to the grid box. The events are grouped by child box
+ * first, so that each child gets all of its events in one go: the storage of
+ * a MDBox grows once, and it is locked once.
+ *
+ * Thread-safe in the same way as addEvent().
+ *
+ * Note! nPoints, signal and error must be re-calculated using refreshCache()
+ * after all events have been added.
+ *
+ * @param events :: vector of events to add.
+ * @return the number of events that were rejected (because of being out of
+ *bounds)
+ * */
+TMDE(size_t MDGridBox)::addEvents(const std::vector<MDE> &events) {
+  return addEventsByChild(events, true);
+}
+
 //-----------------------------------------------------------------------------------------------
 /** Add a single MDLeanEvent to the grid box. If the boxes
  * contained within are also gridded, this will recursively push the event
@@ -1772,6 +1790,85 @@ TMDE(void MDGridBox)::clearFileBacked(bool loadDiskBackedData) {
   }
 }
 
+/** Distribute events to the child boxes. The events of each child are
+ * counted first, then copied once into a buffer of that size, keeping their
+ * order, and each child is given its buffer. An empty MDBox takes the buffer
+ * over without copying it again.
+ *
+ * As in addEvent(), the children do not check the bounds again: an event on
+ * the boundary of two children may be outside of the extents of the one its
+ * index falls in, because of rounding.
+ *
+ * @param events :: the events to add
+ * @param checkBounds :: if true, the events outside of this box are rejected.
+ *        If false, no check is made, as in addEvent().
+ * @return the number of events that were rejected
+ */
+TMDE(size_t MDGridBox)::addEventsByChild(const std::vector<MDE> &events,
+                                         const bool checkBounds) {
+  size_t numBad = 0;
+  // the children given events, in order of their first event, with the
+  // number of events of each; slot[cindex] is the position of a child there
+  const size_t noSlot = numBoxes;
+  std::vector<size_t> slot(numBoxes, noSlot);
+  std::vector<size_t> children, childCount;
+  // the slot of each event, noSlot if it is not added
+  std::vector<size_t> eventSlot(events.size(), noSlot);
+  for (size_t i = 0; i < events.size(); ++i) {
+    const MDE &event = events[i];
+    if (checkBounds) {
+      bool badEvent = false;
+      for (size_t d = 0; d < nd; d++) {
+        if (this->extents[d].outside(event.getCenter(d))) {
+          badEvent = true;
+          break;
+        }
+      }
+      if (badEvent) {
+        ++numBad;
+        continue;
+      }
+    }
+    size_t cindex = calculateChildIndex(event);
+    // We can erroneously get cindex == numBoxes for events which fall on the
+    // upper boundary of the last child box, so add these events to the last
+    // box
+    if (cindex == numBoxes)
+      cindex = numBoxes - 1;
+    if (cindex >= numBoxes)
+      continue;
+    if (slot[cindex] == noSlot) {
+      slot[cindex] = children.size();
+      children.emplace_back(cindex);
+      childCount.emplace_back(0);
+    }
+    eventSlot[i] = slot[cindex];
+    ++childCount[eventSlot[i]];
+  }
+
+  std::vector<std::vector<MDE>> childEvents(children.size());
+  for (size_t s = 0; s < children.size(); ++s)
+    childEvents[s].reserve(childCount[s]);
+  for (size_t i = 0; i < events.size(); ++i)
+    if (eventSlot[i] != noSlot)
+      childEvents[eventSlot[i]].emplace_back(events[i]);
+  std::vector<size_t>().swap(eventSlot);
+
+  for (size_t s = 0; s < children.size(); ++s) {
+    auto child = m_Children[children[s]];
+    if (child->isBox())
+      // MDBox::addEvents() makes no bounds check
+      static_cast<MDBox<MDE, nd> *>(child)->addEvents(
+          std::move(childEvents[s]));
+    else
+      numBad += static_cast<MDGridBox<MDE, nd> *>(child)->addEventsByChild(
+          childEvents[s], false);
+    // release the events of each child as soon as it has them
+    std::vector<MDE>().swap(childEvents[s]);
+  }
+  return numBad;
+}
+
 /**
  * @param event A reference to an event
  */
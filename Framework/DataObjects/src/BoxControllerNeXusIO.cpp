@@ -470,6 +470,8 @@ void BoxControllerNeXusIO::flushData() const {
 /** flush disk buffer data from memory and close underlying NeXus file*/
 void BoxControllerNeXusIO::closeFile() {
   if (m_File) {
+    // nothing may be read from the file once it is closed
+    this->stopPrefetch();
     // write all file-backed data still stack in the data buffer into the file.
     this->flushCache();
     // lock file
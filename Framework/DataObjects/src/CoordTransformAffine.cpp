@@ -283,6 +283,31 @@ void CoordTransformAffine::apply(const coord_t *inputVector,
   }
 }
 
+//----------------------------------------------------------------------------------------------
+/** Apply the coordinate transformation to several points. One output
+ * coordinate is computed for all points at a time, with the same arithmetic
+ * as apply(), so that the loop over points can be vectorised.
+ *
+ * @param inputVectors :: the input coordinates of each point, inD per point
+ * @param outVectors :: the output coordinates of each point, outD per point
+ * @param numPoints :: the number of points
+ */
+void CoordTransformAffine::applyBatch(const coord_t *inputVectors,
+                                      coord_t *outVectors,
+                                      const size_t numPoints) const {
+  for (size_t out = 0; out < outD; ++out) {
+    const coord_t *rawMatrixRow = m_rawMatrix[out];
+    const coord_t translation = rawMatrixRow[inD];
+    for (size_t i = 0; i < numPoints; ++i) {
+      const coord_t *inputVector = inputVectors + i * inD;
+      coord_t outVal = 0.0;
+      for (size_t in = 0; in < inD; ++in)
+        outVal += rawMatrixRow[in] * inputVector[in];
+      outVectors[i * outD + out] = outVal + translation;
+    }
+  }
+}
+
 //----------------------------------------------------------------------------------------------
 /** Serialize the coordinate transform
  *
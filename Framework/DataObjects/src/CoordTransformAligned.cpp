@@ -112,6 +112,27 @@ void CoordTransformAligned::apply(const coord_t *inputVector,
   }
 }
 
+//----------------------------------------------------------------------------------------------
+/** Apply the coordinate transformation to several points, one output
+ * dimension at a time so that the loop over points can be vectorised.
+ *
+ * @param inputVectors :: the input coordinates of each point, inD per point
+ * @param outVectors :: the output coordinates of each point, outD per point
+ * @param numPoints :: the number of points
+ */
+void CoordTransformAligned::applyBatch(const coord_t *inputVectors,
+                                       coord_t *outVectors,
+                                       const size_t numPoints) const {
+  for (size_t out = 0; out < outD; ++out) {
+    const size_t in = m_dimensionToBinFrom[out];
+    const coord_t origin = m_origin[out];
+    const coord_t scaling = m_scaling[out];
+    for (size_t i = 0; i < numPoints; ++i)
+      outVectors[i * outD + out] =
+          (inputVectors[i * inD + in] - origin) * scaling;
+  }
+}
+
 //----------------------------------------------------------------------------------------------
 /** Create an equivalent affine transformation matrix out of the
  * parameters of this axis-aligned transformation.
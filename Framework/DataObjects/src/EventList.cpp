@@ -8,10 +8,12 @@
 #include "MantidAPI/MatrixWorkspace.h"
 #include "MantidDataObjects/EventWorkspaceMRU.h"
 #include "MantidDataObjects/Histogram1D.h"
+#include "MantidKernel/BinEdgeFinder.h"
 #include "MantidKernel/DateAndTime.h"
 #include "MantidKernel/DateAndTimeHelpers.h"
 #include "MantidKernel/Exception.h"
 #include "MantidKernel/Logger.h"
+#include "MantidKernel/RadixSort.h"
 #include "MantidKernel/Unit.h"
 
 #ifdef _MSC_VER
@@ -147,6 +149,105 @@ struct comparePulseTimeTOFDelta {
   int64_t deltaNano;
 };
 
+namespace {
+/// Lists shorter than this are sorted with std::sort: the fixed cost of the
+/// radix sort passes is larger than the comparison sort for them.
+constexpr size_t MIN_EVENTS_FOR_RADIX_SORT = 1024;
+
+/// Radix sort key of the time-of-flight of an event
+template <class T> uint64_t tofKey(const T &event) {
+  return Kernel::RadixSort::sortableKey(event.tof());
+}
+
+/// Radix sort key of the pulse time of an event
+template <class T> uint64_t pulseTimeKey(const T &event) {
+  return Kernel::RadixSort::sortableKey(event.pulseTime().totalNanoseconds());
+}
+
+/** Sort events by time-of-flight
+ * @param events :: the events to sort
+ */
+template <class T> void sortEventsByTof(std::vector<T> &events) {
+  if (events.size() < MIN_EVENTS_FOR_RADIX_SORT)
+    std::sort(events.begin(), events.end());
+  else
+    Kernel::RadixSort::sort(events, tofKey<T>);
+}
+
+/** Sort events by pulse time
+ * @param events :: the events to sort
+ */
+template <class T> void sortEventsByPulseTime(std::vector<T> &events) {
+  if (events.size() < MIN_EVENTS_FOR_RADIX_SORT)
+    std::sort(events.begin(), events.end(), compareEventPulseTime);
+  else
+    Kernel::RadixSort::sort(events, pulseTimeKey<T>);
+}
+
+/** Sort events by pulse time, then time-of-flight
+ * @param events :: the events to sort
+ */
+template <class T> void sortEventsByPulseTimeTof(std::vector<T> &events) {
+  if (events.size() < MIN_EVENTS_FOR_RADIX_SORT) {
+    std::sort(events.begin(), events.end(), compareEventPulseTimeTOF);
+  } else {
+    // The radix sort is stable, so sorting by the minor key first leaves
+    // events with the same pulse time in TOF order.
+    Kernel::RadixSort::sort(events, tofKey<T>);
+    Kernel::RadixSort::sort(events, pulseTimeKey<T>);
+  }
+}
+
+/** Keep a sorted list sorted after a run of events was appended to it. If the
+ * appended run is itself in the list's sort order the two sorted runs are
+ * merged in linear time, so the next consumer does not pay for a full sort;
+ * otherwise the list becomes UNSORTED.
+ * @param events :: the events, of which the first numSorted are in order
+ * @param numSorted :: number of events in the list before the append
+ * @param order :: sort order of the list, updated to the order after the append
+ * @param allowMerge :: if false, the list only stays sorted if the run simply
+ *        continues it. Used for single events, where repeated merges would be
+ *        quadratic.
+ */
+template <class T>
+void mergeAppendedRun(std::vector<T> &events, const size_t numSorted,
+                      EventSortType &order, const bool allowMerge) {
+  if (numSorted == events.size())
+    return;
+  const auto runStart = events.begin() + numSorted;
+  const auto merge = [&](const auto &compare) {
+    if (!std::is_sorted(runStart, events.end(), compare)) {
+      order = UNSORTED;
+    } else if (numSorted > 0 && compare(*runStart, *(runStart - 1))) {
+      // The run does not simply continue the list
+      if (allowMerge)
+        std::inplace_merge(events.begin(), runStart, events.end(), compare);
+      else
+        order = UNSORTED;
+    }
+  };
+
+  switch (order) {
+  case TOF_SORT:
+    merge(std::less<T>());
+    break;
+  case PULSETIME_SORT:
+  case PULSETIMETOF_SORT:
+    if constexpr (std::is_same<T, WeightedEventNoTime>::value) {
+      order = UNSORTED;
+    } else {
+      merge(order == PULSETIME_SORT ? compareEventPulseTime
+                                    : compareEventPulseTimeTOF);
+    }
+    break;
+  default:
+    // Unsorted, or sorted with parameters that are not known here
+    order = UNSORTED;
+    break;
+  }
+}
+} // namespace
+
 /// Constructor (empty)
 // EventWorkspace is always histogram data and so is thus EventList
 EventList::EventList()
@@ -365,7 +466,8 @@ EventList &EventList::operator+=(const TofEvent &event) {
     break;
   }
 
-  this->order = UNSORTED;
+  // Still sorted if the event was appended in order
+  this->mergeAppendedEvents(this->getNumberEvents() - 1, false);
   return *this;
 }
 
@@ -377,6 +479,7 @@ EventList &EventList::operator+=(const TofEvent &event) {
  * @return reference to this
  * */
 EventList &EventList::operator+=(const std::vector<TofEvent> &more_events) {
+  const size_t numSorted = this->getNumberEvents();
   switch (this->eventType) {
   case TOF:
     // Simply push the events
@@ -404,7 +507,7 @@ EventList &EventList::operator+=(const std::vector<TofEvent> &more_events) {
     break;
   }
 
-  this->order = UNSORTED;
+  this->mergeAppendedEvents(numSorted);
   return *this;
 }
 
@@ -419,7 +522,8 @@ EventList &EventList::operator+=(const std::vector<TofEvent> &more_events) {
 EventList &EventList::operator+=(const WeightedEvent &event) {
   this->switchTo(WEIGHTED);
   this->weightedEvents.emplace_back(event);
-  this->order = UNSORTED;
+  // Still sorted if the event was appended in order
+  this->mergeAppendedEvents(this->weightedEvents.size() - 1, false);
   return *this;
 }
 
@@ -433,6 +537,7 @@ EventList &EventList::operator+=(const WeightedEvent &event) {
  * */
 EventList &EventList::
 operator+=(const std::vector<WeightedEvent> &more_events) {
+  const size_t numSorted = this->getNumberEvents();
   switch (this->eventType) {
   case TOF:
     // Need to switch to weighted
@@ -456,7 +561,7 @@ operator+=(const std::vector<WeightedEvent> &more_events) {
     break;
   }
 
-  this->order = UNSORTED;
+  this->mergeAppendedEvents(numSorted);
   return *this;
 }
 
@@ -470,6 +575,7 @@ operator+=(const std::vector<WeightedEvent> &more_events) {
  * */
 EventList &EventList::
 operator+=(const std::vector<WeightedEventNoTime> &more_events) {
+  const size_t numSorted = this->getNumberEvents();
   switch (this->eventType) {
   case TOF:
   case WEIGHTED:
@@ -484,7 +590,7 @@ operator+=(const std::vector<WeightedEventNoTime> &more_events) {
     break;
   }
 
-  this->order = UNSORTED;
+  this->mergeAppendedEvents(numSorted);
   return *this;
 }
 
@@ -493,6 +599,7 @@ operator+=(const std::vector<WeightedEventNoTime> &more_events) {
  * The event lists are concatenated, and a union of the sets of detector ID's is
  *done.
  * Switching of event types may occur if the two are different.
+ * If both lists are sorted the same way they are merged and stay sorted.
  *
  * @param more_events :: Another EventList.
  * @return reference to this
@@ -513,14 +620,36 @@ EventList &EventList::operator+=(const EventList &more_events) {
     break;
   }
 
-  // No guaranteed order
-  this->order = UNSORTED;
   // Do a union between the detector IDs of both lists
   addDetectorIDs(more_events.getDetectorIDs());
 
   return *this;
 }
 
+// --------------------------------------------------------------------------
+/** Update the sort order after events were appended to the end of the list.
+ * A list that was sorted stays sorted if the appended events are in the same
+ * order: the two sorted runs are merged in linear time instead of leaving a
+ * full resort to the next consumer.
+ * @param numSorted :: number of events in the list before the append
+ * @param allowMerge :: if false, the list only stays sorted if the appended
+ *        events continue it without a merge
+ */
+void EventList::mergeAppendedEvents(const size_t numSorted,
+                                    const bool allowMerge) {
+  switch (eventType) {
+  case TOF:
+    mergeAppendedRun(events, numSorted, order, allowMerge);
+    break;
+  case WEIGHTED:
+    mergeAppendedRun(weightedEvents, numSorted, order, allowMerge);
+    break;
+  case WEIGHTED_NOTIME:
+    mergeAppendedRun(weightedEventsNoTime, numSorted, order, allowMerge);
+    break;
+  }
+}
+
 // --------------------------------------------------------------------------
 /** SUBTRACT another EventList from this event list.
  * The event lists are concatenated, but the weights of the incoming
@@ -992,7 +1121,7 @@ void EventList::setSortOrder(const EventSortType order) const {
 }
 
 // --------------------------------------------------------------------------
-/** Sort events by TOF in one thread */
+/** Sort events by TOF in one thread. Long lists use a radix sort. */
 void EventList::sortTof() const {
   if (this->order == TOF_SORT)
     return; // nothing to do
@@ -1005,14 +1134,13 @@ void EventList::sortTof() const {
 
   switch (eventType) {
   case TOF:
-    tbb::parallel_sort(events.begin(), events.end());
+    sortEventsByTof(events);
     break;
   case WEIGHTED:
-    tbb::parallel_sort(weightedEvents.begin(), weightedEvents.end());
+    sortEventsByTof(weightedEvents);
     break;
   case WEIGHTED_NOTIME:
-    tbb::parallel_sort(weightedEventsNoTime.begin(),
-                       weightedEventsNoTime.end());
+    sortEventsByTof(weightedEventsNoTime);
     break;
   }
   // Save the order to avoid unnecessary re-sorting.
@@ -1077,11 +1205,10 @@ void EventList::sortPulseTime() const {
   // Perform sort.
   switch (eventType) {
   case TOF:
-    tbb::parallel_sort(events.begin(), events.end(), compareEventPulseTime);
+    sortEventsByPulseTime(events);
     break;
   case WEIGHTED:
-    tbb::parallel_sort(weightedEvents.begin(), weightedEvents.end(),
-                       compareEventPulseTime);
+    sortEventsByPulseTime(weightedEvents);
     break;
   case WEIGHTED_NOTIME:
     // Do nothing; there is no time to sort
@@ -1107,11 +1234,10 @@ void EventList::sortPulseTimeTOF() const {
 
   switch (eventType) {
   case TOF:
-    tbb::parallel_sort(events.begin(), events.end(), compareEventPulseTimeTOF);
+    sortEventsByPulseTimeTof(events);
     break;
   case WEIGHTED:
-    tbb::parallel_sort(weightedEvents.begin(), weightedEvents.end(),
-                       compareEventPulseTimeTOF);
+    sortEventsByPulseTimeTof(weightedEvents);
     break;
   case WEIGHTED_NOTIME:
     // Do nothing; there is no time to sort
@@ -1377,57 +1503,48 @@ const HistogramData::HistogramE &EventList::e() const {
   return *sharedE();
 }
 Kernel::cow_ptr<HistogramData::HistogramY> EventList::sharedY() const {
-  // This is the thread number from which this function was called.
-  int thread = PARALLEL_THREAD_NUMBER;
-
   Kernel::cow_ptr<HistogramData::HistogramY> yData(nullptr);
+  const auto xData = sharedX();
 
-  // Is the data in the mrulist?
-  if (mru) {
-    mru->ensureEnoughBuffersY(thread);
-    yData = mru->findY(thread, this);
-  }
+  // Is the data in the MRU?
+  if (mru)
+    yData = mru->findY(this, xData);
 
   if (!yData) {
     MantidVec Y;
     MantidVec E;
-    this->generateHistogram(readX(), Y, E);
+    this->generateHistogram(xData->rawData(), Y, E);
 
     // Create the MRU object
     yData = Kernel::make_cow<HistogramData::HistogramY>(std::move(Y));
 
     // Lets save it in the MRU
-    if (mru) {
-      mru->insertY(thread, yData, this);
-      auto eData = Kernel::make_cow<HistogramData::HistogramE>(std::move(E));
-      mru->ensureEnoughBuffersE(thread);
-      mru->insertE(thread, eData, this);
-    }
+    if (mru)
+      mru->insert(this, xData, yData,
+                  Kernel::make_cow<HistogramData::HistogramE>(std::move(E)));
   }
   return yData;
 }
 Kernel::cow_ptr<HistogramData::HistogramE> EventList::sharedE() const {
-  // This is the thread number from which this function was called.
-  int thread = PARALLEL_THREAD_NUMBER;
-
   Kernel::cow_ptr<HistogramData::HistogramE> eData(nullptr);
+  const auto xData = sharedX();
 
-  // Is the data in the mrulist?
-  if (mru) {
-    mru->ensureEnoughBuffersE(thread);
-    eData = mru->findE(thread, this);
-  }
+  // Is the data in the MRU?
+  if (mru)
+    eData = mru->findE(this, xData);
 
   if (!eData) {
-    // Now use that to get E -- Y values are generated from another function
-    MantidVec Y_ignored;
+    // Y comes for free with E, so cache both
+    MantidVec Y;
     MantidVec E;
-    this->generateHistogram(readX(), Y_ignored, E);
+    this->generateHistogram(xData->rawData(), Y, E);
     eData = Kernel::make_cow<HistogramData::HistogramE>(std::move(E));
 
     // Lets save it in the MRU
     if (mru)
-      mru->insertE(thread, eData, this);
+      mru->insert(this, xData,
+                  Kernel::make_cow<HistogramData::HistogramY>(std::move(Y)),
+                  eData);
   }
   return eData;
 }
@@ -1854,23 +1971,6 @@ void EventList::compressFatEvents(
   destination->clearUnused();
 }
 
-// --------------------------------------------------------------------------
-/** Utility function:
- * Returns the iterator into events of the first TofEvent with
- * tof() > seek_tof
- * Will return events.end() if nothing is found!
- *
- * @param events :: event vector in which to look.
- * @param seek_tof :: tof to find (typically the first bin X[0])
- * @return iterator where the first event matching it is.
- */
-template <class T>
-typename std::vector<T>::const_iterator static findFirstEvent(
-    const std::vector<T> &events, T seek_tof) {
-  return std::find_if_not(events.cbegin(), events.cend(),
-                          [seek_tof](const T &x) { return x < seek_tof; });
-}
-
 // --------------------------------------------------------------------------
 /** Utility function:
  * Returns the iterator into events of the first TofEvent with
@@ -1982,55 +2082,25 @@ void EventList::histogramForWeightsHelper(const std::vector<T> &events,
     std::fill(E.begin(), E.end(), 0.0);
   }
 
-  //---------------------- Histogram without weights
+  //---------------------- Histogram with weights
   //---------------------------------
 
   // Do we even have any events to do?
   if (!events.empty()) {
-    // Iterate through all events (sorted by tof)
-    auto itev = findFirstEvent(events, T(X[0]));
-    auto itev_end = events.cend();
-    // The above can still take you to end() if no events above X[0], so check
-    // again.
-    if (itev == itev_end)
-      return;
-
-    // Find the first bin
-    size_t bin = 0;
-    // The tof is greater the first bin boundary, so we need to find the first
-    // bin
-    double tof = itev->tof();
-    while (bin < x_size - 1) {
-      // Within range?
-      if ((tof >= X[bin]) && (tof < X[bin + 1])) {
+    // The events are sorted by tof, so only those between the first and last
+    // bin edges need to be visited.
+    auto itev = std::lower_bound(events.cbegin(), events.cend(), X.front());
+    const auto itev_end = std::lower_bound(itev, events.cend(), X.back());
+    const Kernel::BinEdgeFinder binFinder(X);
+    const size_t numBins = binFinder.numberOfBins();
+    for (; itev != itev_end; ++itev) {
+      const size_t bin = binFinder.bin(itev->tof());
+      if (bin < numBins) {
         // Add up the weight (convert to double before adding, to preserve
         // precision)
         Y[bin] += double(itev->m_weight);
         E[bin] += double(itev->m_errorSquared); // square of error
-        break;
       }
-      ++bin;
-    }
-    // Go to the next event, we've already binned this first one.
-    ++itev;
-
-    // Keep going through all the events
-    while ((itev != itev_end) && (bin < x_size - 1)) {
-      tof = itev->tof();
-      while (bin < x_size - 1) {
-        // Within range? Since both events and X are sorted, they are going to
-        // have
-        // tof >= X[bin] because the previous event was.
-        if (tof < X[bin + 1]) {
-          // Add up the weight (convert to double before adding, to preserve
-          // precision)
-          Y[bin] += double(itev->m_weight);
-          E[bin] += double(itev->m_errorSquared); // square of error
-          break;
-        }
-        ++bin;
-      }
-      ++itev;
     }
   } // end if (there are any events to histogram)
 
@@ -2354,20 +2424,18 @@ void EventList::generateCountsHistogram(const MantidVec &X,
 
   // Do we even have any events to do?
   if (!this->events.empty()) {
-    // Iterate through all events (sorted by tof) placing them in the correct
-    // bin.
-    auto itev = findFirstEvent(this->events, TofEvent(X[0]));
-    // Go through all the events,
-    for (auto itx = X.cbegin(); itev != events.end(); ++itev) {
-      double tof = itev->tof();
-      itx = std::find_if(itx, X.cend(),
-                         [tof](const double x) { return tof < x; });
-      if (itx == X.cend()) {
-        break;
-      }
-      auto bin =
-          std::max(std::distance(X.cbegin(), itx) - 1, std::ptrdiff_t{0});
-      ++Y[bin];
+    // The events are sorted by tof, so only those between the first and last
+    // bin edges need to be visited.
+    auto itev =
+        std::lower_bound(this->events.cbegin(), this->events.cend(), X.front());
+    const auto itev_end =
+        std::lower_bound(itev, this->events.cend(), X.back());
+    const Kernel::BinEdgeFinder binFinder(X);
+    const size_t numBins = binFinder.numberOfBins();
+    for (; itev != itev_end; ++itev) {
+      const size_t bin = binFinder.bin(itev->tof());
+      if (bin < numBins)
+        ++Y[bin];
     }
   } // end if (there are any events to histogram)
 }
@@ -25,6 +25,7 @@
 #include "MantidKernel/TimeSeriesProperty.h"
 
 #include "tbb/parallel_for.h"
+#include <algorithm>
 #include <limits>
 #include <numeric>
 
@@ -454,13 +455,21 @@ void EventWorkspace::switchEventType(const Mantid::API::EventType type) {
 /// @returns If the data is a histogram - always true for an eventWorkspace
 bool EventWorkspace::isHistogramData() const { return true; }
 
-/** Return how many entries in the Y MRU list are used.
- * Only used in tests. It only returns the 0-th MRU list size.
- * @return :: number of entries in the MRU list.
+/** Return how many histograms are held in the MRU.
+ * Only used in tests.
+ * @return :: number of entries in the MRU.
  */
 size_t EventWorkspace::MRUSize() const { return mru->MRUSize(); }
 
-/** Clears the MRU lists */
+/** Set the maximum memory held by the MRU of generated histograms. The
+ * default comes from the "eventworkspace.histogramcache.megabytes" setting.
+ * @param memoryBudget :: the budget in bytes. 0 disables the MRU.
+ */
+void EventWorkspace::setMRUMemoryBudget(const std::size_t memoryBudget) const {
+  mru->setMemoryBudget(memoryBudget);
+}
+
+/** Clears the MRU */
 void EventWorkspace::clearMRU() const { mru->clear(); }
 
 /// Returns the amount of memory used in bytes
@@ -628,13 +637,14 @@ class EventSortingTask {
 public:
   /// ctor
   EventSortingTask(const EventWorkspace *WS, EventSortType sortType,
+                   const std::vector<size_t> &order,
                    Mantid::API::Progress *prog)
-      : m_sortType(sortType), m_WS(WS), prog(prog) {}
+      : m_sortType(sortType), m_WS(WS), m_order(order), prog(prog) {}
 
   // Execute the sort as specified.
   void operator()(const tbb::blocked_range<size_t> &range) const {
-    for (size_t wi = range.begin(); wi < range.end(); ++wi) {
-      m_WS->getSpectrum(wi).sort(m_sortType);
+    for (size_t i = range.begin(); i < range.end(); ++i) {
+      m_WS->getSpectrum(m_order[i]).sort(m_sortType);
     }
     // Report progress
     if (prog)
@@ -646,6 +656,8 @@ private:
   EventSortType m_sortType;
   /// EventWorkspace on which to sort
   const EventWorkspace *m_WS;
+  /// Workspace indices in the order in which they are sorted
+  const std::vector<size_t> &m_order;
   /// Optional Progress dialog.
   Mantid::API::Progress *prog;
 };
@@ -678,8 +690,14 @@ void EventWorkspace::sortAll(EventSortType sortType,
     return;
   }
 
-  // Create the thread pool, and optimize by doing the longest sorts first.
-  EventSortingTask task(this, sortType, prog);
+  // Optimize by doing the longest sorts first, so that a few large lists
+  // are not left running on their own at the end.
+  std::vector<size_t> order(data.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+    return data[a]->getNumberEvents() > data[b]->getNumberEvents();
+  });
+  EventSortingTask task(this, sortType, order, prog);
   tbb::parallel_for(tbb::blocked_range<size_t>(0, data.size()), task);
 }
 
@@ -5,146 +5,95 @@
 //   Institut Laue - Langevin & CSNS, Institute of High Energy Physics, CAS
 // SPDX - License - Identifier: GPL - 3.0 +
 #include "MantidDataObjects/EventWorkspaceMRU.h"
-#include "MantidKernel/System.h"
+#include "MantidKernel/ConfigService.h"
+
+#include <limits>
 
 namespace Mantid {
 namespace DataObjects {
 
-EventWorkspaceMRU::~EventWorkspaceMRU() {
-  // Make sure you free up the memory in the MRUs
-  {
-    Poco::ScopedWriteRWLock _lock(m_changeMruListsMutexY);
-    for (auto &data : m_bufferedDataY) {
-      if (data) {
-        data->clear();
-      }
-    }
-  }
-  Poco::ScopedWriteRWLock _lock2(m_changeMruListsMutexE);
-  for (auto &data : m_bufferedDataE) {
-    if (data) {
-      data->clear();
-    }
-  }
-}
+namespace {
+/// Budget used if none is set in the configuration, in megabytes
+constexpr int DEFAULT_MEMORY_BUDGET_MB = 100;
 
-//---------------------------------------------------------------------------
-/** This function makes sure that there are enough data
- * buffers (MRU's) for E for the number of threads requested.
- * @param thread_num :: thread number that wants a MRU buffer
- */
-void EventWorkspaceMRU::ensureEnoughBuffersE(size_t thread_num) const {
-  Poco::ScopedWriteRWLock _lock(m_changeMruListsMutexE);
-  if (m_bufferedDataE.size() <= thread_num) {
-    m_bufferedDataE.resize(thread_num + 1);
-    for (auto &data : m_bufferedDataE) {
-      if (!data)
-        data = std::make_unique<mru_listE>(
-            50); // Create a MRU list with this many entries.
-    }
-  }
+/// Read the memory budget of the cache from the configuration
+size_t configuredMemoryBudget() {
+  auto megabytes = Kernel::ConfigService::Instance().getValue<int>(
+      "eventworkspace.histogramcache.megabytes");
+  const int budget = megabytes.get_value_or(DEFAULT_MEMORY_BUDGET_MB);
+  return budget > 0 ? static_cast<size_t>(budget) * 1024 * 1024 : 0;
 }
-//---------------------------------------------------------------------------
-/** This function makes sure that there are enough data
- * buffers (MRU's) for Y for the number of threads requested.
- * @param thread_num :: thread number that wants a MRU buffer
+} // namespace
+
+/// Constructor, with the memory budget from the configuration
+EventWorkspaceMRU::EventWorkspaceMRU()
+    : m_memoryBudget(configuredMemoryBudget()) {}
+
+/** Constructor
+ * @param memoryBudget :: maximum memory held by the histograms, in bytes
  */
-void EventWorkspaceMRU::ensureEnoughBuffersY(size_t thread_num) const {
-  Poco::ScopedWriteRWLock _lock(m_changeMruListsMutexY);
-  if (m_bufferedDataY.size() <= thread_num) {
-    m_bufferedDataY.resize(thread_num + 1);
-    for (auto &data : m_bufferedDataY) {
-      if (!data)
-        data = std::make_unique<mru_listY>(
-            50); // Create a MRU list with this many entries.
-    }
-  }
-}
+EventWorkspaceMRU::EventWorkspaceMRU(const size_t memoryBudget)
+    : m_memoryBudget(memoryBudget) {}
 
 //---------------------------------------------------------------------------
-/// Clear all the data in the MRU buffers
+/// Clear all the data in the MRU cache
 void EventWorkspaceMRU::clear() {
-  {
-    // Make sure you free up the memory in the MRUs
-    Poco::ScopedWriteRWLock _lock(m_changeMruListsMutexY);
-    for (auto &data : m_bufferedDataY) {
-      if (data) {
-        data->clear();
-      }
-    }
-  }
-
-  Poco::ScopedWriteRWLock _lock(m_changeMruListsMutexE);
-  for (auto &data : m_bufferedDataE) {
-    if (data) {
-      data->clear();
-    }
+  for (auto &shard : m_shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    while (!shard.entries.empty())
+      erase(shard, shard.entries.begin());
   }
 }
 
 //---------------------------------------------------------------------------
 /** Find a Y histogram in the MRU
  *
- * @param thread_num :: number of the thread in which this is run
- * @param index :: index of the data to return
- * @return pointer to the TypeWithMarker that has the data; NULL if not found.
+ * @param index :: the EventList the histogram was generated from
+ * @param x :: the bin edges the EventList currently has
+ * @return the Y histogram; NULL if not found.
  */
-Kernel::cow_ptr<HistogramData::HistogramY>
-EventWorkspaceMRU::findY(size_t thread_num, const EventList *index) {
-  Poco::ScopedReadRWLock _lock(m_changeMruListsMutexY);
-  auto result = m_bufferedDataY[thread_num]->find(
-      reinterpret_cast<std::uintptr_t>(index));
-  if (result)
-    return result->m_data;
-  return YType(nullptr);
+EventWorkspaceMRU::YType EventWorkspaceMRU::findY(const EventList *index,
+                                                  const XType &x) {
+  return find(index, x, &Entry::y);
 }
 
-/** Find a Y histogram in the MRU
+/** Find an E histogram in the MRU
  *
- * @param thread_num :: number of the thread in which this is run
- * @param index :: index of the data to return
- * @return pointer to the TypeWithMarker that has the data; NULL if not found.
+ * @param index :: the EventList the histogram was generated from
+ * @param x :: the bin edges the EventList currently has
+ * @return the E histogram; NULL if not found.
  */
-Kernel::cow_ptr<HistogramData::HistogramE>
-EventWorkspaceMRU::findE(size_t thread_num, const EventList *index) {
-  Poco::ScopedReadRWLock _lock(m_changeMruListsMutexE);
-  auto result = m_bufferedDataE[thread_num]->find(
-      reinterpret_cast<std::uintptr_t>(index));
-  if (result)
-    return result->m_data;
-  return EType(nullptr);
+EventWorkspaceMRU::EType EventWorkspaceMRU::findE(const EventList *index,
+                                                  const XType &x) {
+  return find(index, x, &Entry::e);
 }
 
-/** Insert a new histogram into the MRU
+/** Insert a new histogram into the MRU, replacing any older one for the
+ * same EventList. Least recently used histograms are dropped if this takes
+ * the cache over its memory budget.
  *
- * @param thread_num :: thread being accessed
- * @param data :: the new data
- * @param index :: index of the data to insert
+ * @param index :: the EventList the histogram was generated from
+ * @param x :: the bin edges the histogram was generated with
+ * @param y :: the counts
+ * @param e :: the errors
  */
-void EventWorkspaceMRU::insertY(size_t thread_num, YType data,
-                                const EventList *index) {
-  Poco::ScopedReadRWLock _lock(m_changeMruListsMutexY);
-  auto yWithMarker = std::make_shared<TypeWithMarker<YType>>(
-      reinterpret_cast<std::uintptr_t>(index));
-  yWithMarker->m_data = std::move(data);
-  m_bufferedDataY[thread_num]->insert(yWithMarker);
-  // the memory is cleared automatically due to being a smart_ptr
-}
-
-/** Insert a new histogram into the MRU
- *
- * @param thread_num :: thread being accessed
- * @param data :: the new data
- * @param index :: index of the data to insert
- */
-void EventWorkspaceMRU::insertE(size_t thread_num, EType data,
-                                const EventList *index) {
-  Poco::ScopedReadRWLock _lock(m_changeMruListsMutexE);
-  auto eWithMarker = std::make_shared<TypeWithMarker<EType>>(
-      reinterpret_cast<std::uintptr_t>(index));
-  eWithMarker->m_data = std::move(data);
-  auto oldData = m_bufferedDataE[thread_num]->insert(eWithMarker);
-  // And clear up the memory of the old one, if it is dropping out.
+void EventWorkspaceMRU::insert(const EventList *index, const XType &x, YType y,
+                               EType e) {
+  const size_t memory = (y.get() ? y->size() : 0) * sizeof(double) +
+                        (e.get() ? e->size() : 0) * sizeof(double);
+  auto &shard = shardFor(index);
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto existing = shard.lookup.find(index);
+    if (existing != shard.lookup.end())
+      erase(shard, existing->second);
+    shard.entries.push_front(
+        {index, x, std::move(y), std::move(e), memory, ++m_clock});
+    shard.lookup.emplace(index, shard.entries.begin());
+    m_memoryUsed += memory;
+    ++m_size;
+  }
+  evictToBudget();
 }
 
 /** Delete any entries in the MRU at the given index
@@ -152,27 +101,103 @@ void EventWorkspaceMRU::insertE(size_t thread_num, EType data,
  * @param index :: index to delete.
  */
 void EventWorkspaceMRU::deleteIndex(const EventList *index) {
-  {
-    Poco::ScopedReadRWLock _lock1(m_changeMruListsMutexE);
-    for (auto &data : m_bufferedDataE) {
-      if (data) {
-        data->deleteIndex(reinterpret_cast<std::uintptr_t>(index));
-      }
-    }
-  }
-  Poco::ScopedReadRWLock _lock2(m_changeMruListsMutexY);
-  for (auto &data : m_bufferedDataY) {
-    if (data) {
-      data->deleteIndex(reinterpret_cast<std::uintptr_t>(index));
+  auto &shard = shardFor(index);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto existing = shard.lookup.find(index);
+  if (existing != shard.lookup.end())
+    erase(shard, existing->second);
+}
+
+/** Set the maximum memory held by the histograms. Histograms are dropped
+ * straight away if the cache holds more.
+ * @param memoryBudget :: the new budget, in bytes. 0 disables the cache.
+ */
+void EventWorkspaceMRU::setMemoryBudget(const size_t memoryBudget) {
+  m_memoryBudget = memoryBudget;
+  evictToBudget();
+}
+
+/// Return the maximum memory held by the histograms, in bytes
+size_t EventWorkspaceMRU::memoryBudget() const { return m_memoryBudget; }
+
+/// Return the memory currently held by the histograms, in bytes
+size_t EventWorkspaceMRU::memoryUsed() const { return m_memoryUsed; }
+
+size_t EventWorkspaceMRU::MRUSize() const { return m_size; }
+
+/** Select the shard that holds the histograms of an EventList
+ * @param index :: the EventList
+ * @return the shard
+ */
+EventWorkspaceMRU::Shard &
+EventWorkspaceMRU::shardFor(const EventList *index) {
+  // The low bits of an address are the same for all allocations
+  auto hash = reinterpret_cast<std::uintptr_t>(index);
+  hash ^= hash >> 12;
+  hash ^= hash >> 6;
+  return m_shards[hash & (NUM_SHARDS - 1)];
+}
+
+/** Look up part of a cached histogram. An entry generated with different bin
+ * edges than the EventList now has is dropped.
+ * @param index :: the EventList the histogram was generated from
+ * @param x :: the bin edges the EventList currently has
+ * @param member :: the part of the entry to return
+ * @return the cached data; NULL if not found.
+ */
+template <typename T>
+T EventWorkspaceMRU::find(const EventList *index, const XType &x,
+                          T Entry::*member) {
+  auto &shard = shardFor(index);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto existing = shard.lookup.find(index);
+  if (existing != shard.lookup.end()) {
+    auto entry = existing->second;
+    if (entry->x == x) {
+      // Move to the front as the most recently used
+      entry->lastUse = ++m_clock;
+      shard.entries.splice(shard.entries.begin(), shard.entries, entry);
+      m_hits.fetch_add(1, std::memory_order_relaxed);
+      return (*entry).*member;
     }
+    // The bin edges have changed since the histogram was generated
+    erase(shard, entry);
   }
+  m_misses.fetch_add(1, std::memory_order_relaxed);
+  return T(nullptr);
 }
 
-size_t EventWorkspaceMRU::MRUSize() const {
-  if (m_bufferedDataY.empty()) {
-    return 0;
-  } else {
-    return this->m_bufferedDataY.front()->size();
+/** Remove an entry from a shard. The shard must be locked.
+ * @param shard :: the shard holding the entry
+ * @param entry :: the entry to remove
+ */
+void EventWorkspaceMRU::erase(Shard &shard, std::list<Entry>::iterator entry) {
+  m_memoryUsed -= entry->memory;
+  --m_size;
+  shard.lookup.erase(entry->index);
+  shard.entries.erase(entry);
+}
+
+/** Drop the least recently used entries, across all shards, until the
+ * memory held is within the budget. Only one shard is locked at a time.
+ */
+void EventWorkspaceMRU::evictToBudget() {
+  while (m_memoryUsed > m_memoryBudget) {
+    Shard *oldest = nullptr;
+    uint64_t oldestUse = std::numeric_limits<uint64_t>::max();
+    for (auto &shard : m_shards) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      if (!shard.entries.empty() && shard.entries.back().lastUse < oldestUse) {
+        oldest = &shard;
+        oldestUse = shard.entries.back().lastUse;
+      }
+    }
+    if (!oldest)
+      return;
+    std::lock_guard<std::mutex> lock(oldest->mutex);
+    // Another thread may have emptied the shard in the meantime
+    if (!oldest->entries.empty())
+      erase(*oldest, std::prev(oldest->entries.end()));
   }
 }
 
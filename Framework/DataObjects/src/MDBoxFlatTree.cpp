@@ -14,6 +14,7 @@
 #include "MantidKernel/Strings.h"
 #include <Poco/File.h>
 
+#include <algorithm>
 #include <utility>
 
 using file_holder_type = std::unique_ptr<::NeXus::File>;
@@ -134,9 +135,9 @@ void MDBoxFlatTree::initFlatStructure(const API::IMDEventWorkspace_sptr &pws,
     }
   }
 }
-/*** this function tries to set file positions of the boxes to
-     make data physically located close to each other to be as close as possible
-   on the HDD
+/*** this function sets the file positions of the boxes, in the Morton order
+     of their lower corners (see MDBoxMortonIndex), so that boxes close to each
+     other in space are physically close to each other on the HDD.
      @param setFileBacked  -- initiate the boxes to be fileBacked. The boxes
    assumed not to be saved before.
 */
@@ -146,24 +147,59 @@ void MDBoxFlatTree::setBoxesFilePositions(bool setFileBacked) {
   // this would be right for binary access but questionable for Nexus --TODO:
   // needs testing
   // Done in INIT--> need check if ID and index in the tree are always the same.
-  // Kernel::ISaveable::sortObjByFilePos(m_Boxes);
-  // calculate the box positions in the resulting file and save it on place
-  uint64_t eventsStart = 0;
+  std::vector<uint64_t> boxSizes(m_BoxEventIndex.size(), 0);
   for (auto mdBox : m_Boxes) {
     size_t ID = mdBox->getID();
-
     // avoid grid boxes;
-    if (m_BoxType[ID] == 2)
-      continue;
+    if (m_BoxType[ID] != 2)
+      boxSizes[ID * 2 + 1] = mdBox->getTotalDataSize();
+  }
 
-    size_t nEvents = mdBox->getTotalDataSize();
+  // calculate the box positions in the resulting file and save it on place
+  uint64_t eventsStart = 0;
+  const MDBoxMortonIndex index(m_nDim, m_BoxType, m_Extents, boxSizes);
+  for (const auto &entry : index.entries()) {
+    const size_t ID = entry.boxId;
+    const uint64_t nEvents = boxSizes[ID * 2 + 1];
     m_BoxEventIndex[ID * 2] = eventsStart;
     m_BoxEventIndex[ID * 2 + 1] = nEvents;
     if (setFileBacked)
-      mdBox->setFileBacked(eventsStart, nEvents, false);
+      m_Boxes[ID]->setFileBacked(eventsStart, nEvents, false);
 
     eventsStart += nEvents;
   }
+  // the empty boxes are not in the index
+  for (auto mdBox : m_Boxes) {
+    size_t ID = mdBox->getID();
+    if (m_BoxType[ID] == 2 || boxSizes[ID * 2 + 1] > 0)
+      continue;
+    m_BoxEventIndex[ID * 2] = eventsStart;
+    m_BoxEventIndex[ID * 2 + 1] = 0;
+    if (setFileBacked)
+      mdBox->setFileBacked(eventsStart, 0, false);
+  }
+}
+
+/**@return the indices of the boxes holding events, ordered by the position of
+ * their events on file, so that reading or writing them in this order goes
+ * through the file once */
+std::vector<size_t> MDBoxFlatTree::getBoxesInFileOrder() const {
+  std::vector<size_t> boxes;
+  for (size_t i = 0; i < m_BoxType.size(); i++) {
+    if (m_BoxType[i] == 1 && m_BoxEventIndex[2 * i + 1] > 0)
+      boxes.emplace_back(i);
+  }
+  std::stable_sort(boxes.begin(), boxes.end(), [this](size_t a, size_t b) {
+    return m_BoxEventIndex[2 * a] < m_BoxEventIndex[2 * b];
+  });
+  return boxes;
+}
+
+/**@return the index of the boxes holding events, to find the boxes and the
+ * parts of the file covering a region of the workspace */
+MDBoxMortonIndex MDBoxFlatTree::getMortonIndex() const {
+  return MDBoxMortonIndex(static_cast<size_t>(m_nDim), m_BoxType, m_Extents,
+                          m_BoxEventIndex);
 }
 
 void MDBoxFlatTree::saveBoxStructure(const std::string &fileName) {
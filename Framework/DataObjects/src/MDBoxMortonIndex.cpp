@@ -0,0 +1,86 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2020 ISIS Rutherford Appleton Laboratory UKRI,
+//   NScD Oak Ridge National Laboratory, European Spallation Source,
+//   Institut Laue - Langevin & CSNS, Institute of High Energy Physics, CAS
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidDataObjects/MDBoxMortonIndex.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Mantid {
+namespace DataObjects {
+
+/// Constructor, no boxes
+MDBoxMortonIndex::MDBoxMortonIndex() : m_nDims(0), m_bitsPerDim(0) {}
+
+/** Constructor from the arrays of a flattened box tree. Box 0 is the top box,
+ * whose extents are the space of the workspace.
+ * @param nDims :: number of dimensions
+ * @param boxType :: type of each box: 1 for a box holding events
+ * @param extents :: min/max extents of each box in each dimension
+ * @param eventIndex :: file position and number of events of each box
+ * @throw std::invalid_argument if the arrays do not match
+ */
+MDBoxMortonIndex::MDBoxMortonIndex(const size_t nDims,
+                                   const std::vector<int> &boxType,
+                                   const std::vector<double> &extents,
+                                   const std::vector<uint64_t> &eventIndex)
+    : m_nDims(nDims), m_bitsPerDim(nDims > 0 ? std::min<size_t>(64 / nDims, 32)
+                                             : 0) {
+  const size_t numBoxes = boxType.size();
+  if (nDims == 0 || extents.size() != numBoxes * nDims * 2 ||
+      eventIndex.size() != numBoxes * 2)
+    throw std::invalid_argument(
+        "MDBoxMortonIndex: the box arrays do not match the number of boxes");
+  if (numBoxes == 0)
+    return;
+  m_space.assign(extents.cbegin(), extents.cbegin() + nDims * 2);
+
+  std::vector<double> lower(nDims);
+  std::vector<Entry> entries;
+  for (size_t i = 0; i < numBoxes; ++i) {
+    if (boxType[i] != 1 || eventIndex[2 * i + 1] == 0)
+      continue;
+    for (size_t d = 0; d < nDims; ++d)
+      lower[d] = extents[(i * nDims + d) * 2];
+    entries.push_back({key(lower.data()), i});
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry &a, const Entry &b) {
+              return a.lowKey < b.lowKey ||
+                     (a.lowKey == b.lowKey && a.boxId < b.boxId);
+            });
+
+  m_entries = std::move(entries);
+}
+
+/** The Morton key of a point. Points outside of the workspace get the key of
+ * the nearest cell.
+ * @param point :: the coordinates, one per dimension
+ * @return the key
+ */
+uint64_t MDBoxMortonIndex::key(const double *point) const {
+  const uint64_t numCells = uint64_t(1) << m_bitsPerDim;
+  uint64_t result = 0;
+  for (size_t d = 0; d < m_nDims; ++d) {
+    const double min = m_space[2 * d];
+    const double width = m_space[2 * d + 1] - min;
+    const double position =
+        width > 0 ? (point[d] - min) / width * static_cast<double>(numCells)
+                  : 0.;
+    uint64_t cell = 0;
+    // Written so that NaN gives the first cell
+    if (position >= static_cast<double>(numCells))
+      cell = numCells - 1;
+    else if (position > 0)
+      cell = static_cast<uint64_t>(position);
+    for (size_t bit = 0; bit < m_bitsPerDim; ++bit)
+      result |= ((cell >> bit) & 1) << (bit * m_nDims + d);
+  }
+  return result;
+}
+
+} // namespace DataObjects
+} // namespace Mantid
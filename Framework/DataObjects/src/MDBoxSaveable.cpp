@@ -38,11 +38,13 @@ void MDBoxSaveable::save() const {
  * private function called from the DiskBuffer
  */
 void MDBoxSaveable::load() {
+  std::lock_guard<std::mutex> lock(m_loadMutex);
   // Is the data in memory right now (cached copy)?
   if (!m_isLoaded) {
     API::IBoxControllerIO *fileIO = m_MDNode->getBoxController()->getFileIO();
     m_MDNode->loadAndAddFrom(fileIO, this->getFilePosition(),
                              this->getFileSize());
+    fileIO->recordRead(this->getFileSize());
     this->setLoaded(true);
   }
 }
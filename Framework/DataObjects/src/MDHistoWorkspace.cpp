@@ -13,12 +13,14 @@
 #include "MantidGeometry/MDGeometry/MDDimensionExtents.h"
 #include "MantidGeometry/MDGeometry/MDGeometryXMLBuilder.h"
 #include "MantidGeometry/MDGeometry/MDHistoDimension.h"
+#include "MantidKernel/MultiThreaded.h"
 #include "MantidKernel/Utils.h"
 #include "MantidKernel/VMD.h"
 #include "MantidKernel/WarningSuppressions.h"
 
 #include <boost/optional.hpp>
 #include <boost/scoped_array.hpp>
+#include <algorithm>
 #include <cmath>
 #include <map>
 #include <memory>
@@ -27,6 +29,29 @@ using namespace Mantid::Kernel;
 using namespace Mantid::Geometry;
 using namespace Mantid::API;
 
+namespace {
+/// Number of bins in a tile of an elementwise operation
+constexpr size_t BINS_PER_TILE = 16384;
+
+/** Apply an elementwise operation to all of the bins, one tile of contiguous
+ * bins at a time. The tiles are shared between threads. The operation loops
+ * over the bins of a tile in the arrays, so that the loop is vectorised.
+ * @param length :: number of bins
+ * @param operation :: function taking the first and one-past-the-last bins
+ * of a tile
+ */
+template <typename Operation>
+void forEachTile(const size_t length, const Operation &operation) {
+  const auto numTiles =
+      static_cast<int64_t>((length + BINS_PER_TILE - 1) / BINS_PER_TILE);
+  PARALLEL_FOR_IF(numTiles > 1)
+  for (int64_t tile = 0; tile < numTiles; ++tile) {
+    const auto begin = static_cast<size_t>(tile) * BINS_PER_TILE;
+    operation(begin, std::min(length, begin + BINS_PER_TILE));
+  }
+}
+} // namespace
+
 namespace Mantid {
 namespace DataObjects {
 //----------------------------------------------------------------------------------------------
@@ -765,11 +790,13 @@ MDHistoWorkspace &MDHistoWorkspace::operator+=(const MDHistoWorkspace &b) {
  * */
 void MDHistoWorkspace::add(const MDHistoWorkspace &b) {
   checkWorkspaceSize(b, "add");
-  for (size_t i = 0; i < m_length; ++i) {
-    m_signals[i] += b.m_signals[i];
-    m_errorsSquared[i] += b.m_errorsSquared[i];
-    m_numEvents[i] += b.m_numEvents[i];
-  }
+  forEachTile(m_length, [this, &b](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      m_signals[i] += b.m_signals[i];
+      m_errorsSquared[i] += b.m_errorsSquared[i];
+      m_numEvents[i] += b.m_numEvents[i];
+    }
+  });
   m_nEventsContributed += b.m_nEventsContributed;
 }
 
@@ -781,10 +808,12 @@ void MDHistoWorkspace::add(const MDHistoWorkspace &b) {
  * */
 void MDHistoWorkspace::add(const signal_t signal, const signal_t error) {
   signal_t errorSquared = error * error;
-  for (size_t i = 0; i < m_length; ++i) {
-    m_signals[i] += signal;
-    m_errorsSquared[i] += errorSquared;
-  }
+  forEachTile(m_length, [this, signal, errorSquared](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      m_signals[i] += signal;
+      m_errorsSquared[i] += errorSquared;
+    }
+  });
 }
 
 //----------------------------------------------------------------------------------------------
@@ -804,11 +833,13 @@ MDHistoWorkspace &MDHistoWorkspace::operator-=(const MDHistoWorkspace &b) {
  * */
 void MDHistoWorkspace::subtract(const MDHistoWorkspace &b) {
   checkWorkspaceSize(b, "subtract");
-  for (size_t i = 0; i < m_length; ++i) {
-    m_signals[i] -= b.m_signals[i];
-    m_errorsSquared[i] += b.m_errorsSquared[i];
-    m_numEvents[i] += b.m_numEvents[i];
-  }
+  forEachTile(m_length, [this, &b](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      m_signals[i] -= b.m_signals[i];
+      m_errorsSquared[i] += b.m_errorsSquared[i];
+      m_numEvents[i] += b.m_numEvents[i];
+    }
+  });
   m_nEventsContributed += b.m_nEventsContributed;
 }
 
@@ -820,10 +851,12 @@ void MDHistoWorkspace::subtract(const MDHistoWorkspace &b) {
  * */
 void MDHistoWorkspace::subtract(const signal_t signal, const signal_t error) {
   signal_t errorSquared = error * error;
-  for (size_t i = 0; i < m_length; ++i) {
-    m_signals[i] -= signal;
-    m_errorsSquared[i] += errorSquared;
-  }
+  forEachTile(m_length, [this, signal, errorSquared](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      m_signals[i] -= signal;
+      m_errorsSquared[i] += errorSquared;
+    }
+  });
 }
 
 //----------------------------------------------------------------------------------------------
@@ -852,19 +885,21 @@ MDHistoWorkspace &MDHistoWorkspace::operator*=(const MDHistoWorkspace &b_ws) {
  * */
 void MDHistoWorkspace::multiply(const MDHistoWorkspace &b_ws) {
   checkWorkspaceSize(b_ws, "multiply");
-  for (size_t i = 0; i < m_length; ++i) {
-    signal_t a = m_signals[i];
-    signal_t da2 = m_errorsSquared[i];
+  forEachTile(m_length, [this, &b_ws](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      signal_t a = m_signals[i];
+      signal_t da2 = m_errorsSquared[i];
 
-    signal_t b = b_ws.m_signals[i];
-    signal_t db2 = b_ws.m_errorsSquared[i];
+      signal_t b = b_ws.m_signals[i];
+      signal_t db2 = b_ws.m_errorsSquared[i];
 
-    signal_t f = a * b;
-    signal_t df2 = da2 * b * b + db2 * a * a;
+      signal_t f = a * b;
+      signal_t df2 = da2 * b * b + db2 * a * a;
 
-    m_signals[i] = f;
-    m_errorsSquared[i] = df2;
-  }
+      m_signals[i] = f;
+      m_errorsSquared[i] = df2;
+    }
+  });
 }
 
 //----------------------------------------------------------------------------------------------
@@ -883,16 +918,18 @@ void MDHistoWorkspace::multiply(const signal_t signal, const signal_t error) {
   signal_t b = signal;
   signal_t db2 = error * error;
 
-  for (size_t i = 0; i < m_length; ++i) {
-    signal_t a = m_signals[i];
-    signal_t da2 = m_errorsSquared[i];
+  forEachTile(m_length, [this, b, db2](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      signal_t a = m_signals[i];
+      signal_t da2 = m_errorsSquared[i];
 
-    signal_t f = a * b;
-    signal_t df2 = da2 * b * b + db2 * a * a;
+      signal_t f = a * b;
+      signal_t df2 = da2 * b * b + db2 * a * a;
 
-    m_signals[i] = f;
-    m_errorsSquared[i] = df2;
-  }
+      m_signals[i] = f;
+      m_errorsSquared[i] = df2;
+    }
+  });
 }
 
 //----------------------------------------------------------------------------------------------
@@ -921,19 +958,21 @@ MDHistoWorkspace &MDHistoWorkspace::operator/=(const MDHistoWorkspace &b_ws) {
  **/
 void MDHistoWorkspace::divide(const MDHistoWorkspace &b_ws) {
   checkWorkspaceSize(b_ws, "divide");
-  for (size_t i = 0; i < m_length; ++i) {
-    signal_t a = m_signals[i];
-    signal_t da2 = m_errorsSquared[i];
+  forEachTile(m_length, [this, &b_ws](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      signal_t a = m_signals[i];
+      signal_t da2 = m_errorsSquared[i];
 
-    signal_t b = b_ws.m_signals[i];
-    signal_t db2 = b_ws.m_errorsSquared[i];
+      signal_t b = b_ws.m_signals[i];
+      signal_t db2 = b_ws.m_errorsSquared[i];
 
-    signal_t f = a / b;
-    signal_t df2 = da2 / (b * b) + db2 * f * f / (b * b);
+      signal_t f = a / b;
+      signal_t df2 = da2 / (b * b) + db2 * f * f / (b * b);
 
-    m_signals[i] = f;
-    m_errorsSquared[i] = df2;
-  }
+      m_signals[i] = f;
+      m_errorsSquared[i] = df2;
+    }
+  });
 }
 
 //----------------------------------------------------------------------------------------------
@@ -952,16 +991,18 @@ void MDHistoWorkspace::divide(const signal_t signal, const signal_t error) {
   signal_t b = signal;
   signal_t db2 = error * error;
   signal_t db2_relative = db2 / (b * b);
-  for (size_t i = 0; i < m_length; ++i) {
-    signal_t a = m_signals[i];
-    signal_t da2 = m_errorsSquared[i];
+  forEachTile(m_length, [this, b, db2_relative](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      signal_t a = m_signals[i];
+      signal_t da2 = m_errorsSquared[i];
 
-    signal_t f = a / b;
-    signal_t df2 = da2 / (b * b) + db2_relative * f * f;
+      signal_t f = a / b;
+      signal_t df2 = da2 / (b * b) + db2_relative * f * f;
 
-    m_signals[i] = f;
-    m_errorsSquared[i] = df2;
-  }
+      m_signals[i] = f;
+      m_errorsSquared[i] = df2;
+    }
+  });
 }
 
 //----------------------------------------------------------------------------------------------
@@ -971,17 +1012,19 @@ void MDHistoWorkspace::divide(const signal_t signal, const signal_t error) {
  * \f$ df^2 = a^2 / da^2 \f$
  */
 void MDHistoWorkspace::log(double filler) {
-  for (size_t i = 0; i < m_length; ++i) {
-    signal_t a = m_signals[i];
-    signal_t da2 = m_errorsSquared[i];
-    if (a <= 0) {
-      m_signals[i] = filler;
-      m_errorsSquared[i] = 0;
-    } else {
-      m_signals[i] = std::log(a);
-      m_errorsSquared[i] = da2 / (a * a);
+  forEachTile(m_length, [this, filler](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      signal_t a = m_signals[i];
+      signal_t da2 = m_errorsSquared[i];
+      if (a <= 0) {
+        m_signals[i] = filler;
+        m_errorsSquared[i] = 0;
+      } else {
+        m_signals[i] = std::log(a);
+        m_errorsSquared[i] = da2 / (a * a);
+      }
     }
-  }
+  });
 }
 
 //----------------------------------------------------------------------------------------------
@@ -991,17 +1034,20 @@ void MDHistoWorkspace::log(double filler) {
  * \f$ df^2 = (ln(10)^-2) * a^2 / da^2 \f$
  */
 void MDHistoWorkspace::log10(double filler) {
-  for (size_t i = 0; i < m_length; ++i) {
-    signal_t a = m_signals[i];
-    signal_t da2 = m_errorsSquared[i];
-    if (a <= 0) {
-      m_signals[i] = filler;
-      m_errorsSquared[i] = 0;
-    } else {
-      m_signals[i] = std::log10(a);
-      m_errorsSquared[i] = 0.1886117 * da2 / (a * a); // 0.1886117  = ln(10)^-2
+  forEachTile(m_length, [this, filler](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      signal_t a = m_signals[i];
+      signal_t da2 = m_errorsSquared[i];
+      if (a <= 0) {
+        m_signals[i] = filler;
+        m_errorsSquared[i] = 0;
+      } else {
+        m_signals[i] = std::log10(a);
+        // 0.1886117  = ln(10)^-2
+        m_errorsSquared[i] = 0.1886117 * da2 / (a * a);
+      }
     }
-  }
+  });
 }
 
 //----------------------------------------------------------------------------------------------
@@ -1011,12 +1057,14 @@ void MDHistoWorkspace::log10(double filler) {
  * \f$ df^2 = f^2 * da^2 \f$
  */
 void MDHistoWorkspace::exp() {
-  for (size_t i = 0; i < m_length; ++i) {
-    signal_t f = std::exp(m_signals[i]);
-    signal_t da2 = m_errorsSquared[i];
-    m_signals[i] = f;
-    m_errorsSquared[i] = f * f * da2;
-  }
+  forEachTile(m_length, [this](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      signal_t f = std::exp(m_signals[i]);
+      signal_t da2 = m_errorsSquared[i];
+      m_signals[i] = f;
+      m_errorsSquared[i] = f * f * da2;
+    }
+  });
 }
 
 //----------------------------------------------------------------------------------------------
@@ -1028,13 +1076,16 @@ void MDHistoWorkspace::exp() {
  */
 void MDHistoWorkspace::power(double exponent) {
   double exponent_squared = exponent * exponent;
-  for (size_t i = 0; i < m_length; ++i) {
-    signal_t a = m_signals[i];
-    signal_t f = std::pow(a, exponent);
-    signal_t da2 = m_errorsSquared[i];
-    m_signals[i] = f;
-    m_errorsSquared[i] = f * f * exponent_squared * da2 / (a * a);
-  }
+  forEachTile(m_length, [this, exponent, exponent_squared](size_t begin,
+                                                           size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      signal_t a = m_signals[i];
+      signal_t f = std::pow(a, exponent);
+      signal_t da2 = m_errorsSquared[i];
+      m_signals[i] = f;
+      m_errorsSquared[i] = f * f * exponent_squared * da2 / (a * a);
+    }
+  });
 }
 
 //==============================================================================================
@@ -125,6 +125,27 @@ public:
                                ct.applyVMD(VMD(1.0, 2.0, 3.0)));
   }
 
+  void test_applyBatch_matches_apply() {
+    CoordTransformAffine ct(3, 2);
+    Matrix<coord_t> mat(3, 4);
+    coord_t values[3][4] = {
+        {0.5, -1.25, 3, 2}, {0.1, 0.7, -0.3, -5}, {0, 0, 0, 1}};
+    for (size_t i = 0; i < 3; ++i)
+      for (size_t j = 0; j < 4; ++j)
+        mat[i][j] = values[i][j];
+    ct.setMatrix(mat);
+
+    coord_t input[9] = {1, 2, 3, -4.5, 0.25, 7, 1e3, -2e-3, 0};
+    coord_t output[6];
+    ct.applyBatch(input, output, 3);
+    for (size_t i = 0; i < 3; ++i) {
+      coord_t expected[2];
+      ct.apply(input + i * 3, expected);
+      for (size_t d = 0; d < 2; ++d)
+        TS_ASSERT_EQUALS(output[i * 2 + d], expected[d]);
+    }
+  }
+
   /** Test rotation in isolation */
   void test_rotation() {
     using Mantid::Kernel::V3D;
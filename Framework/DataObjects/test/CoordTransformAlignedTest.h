@@ -76,6 +76,23 @@ public:
     TS_ASSERT_DELTA(output[2], 3.0, 1e-6);
   }
 
+  void test_applyBatch_matches_apply() {
+    size_t dimToBinFrom[3] = {3, 1, 0};
+    coord_t origin[3] = {5, 10, 15};
+    coord_t scaling[3] = {1, 2, 3};
+    CoordTransformAligned ct(4, 3, dimToBinFrom, origin, scaling);
+
+    coord_t input[12] = {16, 11, 0, 6, 1.5, 2.5, 3.5, 4.5, -7, 0, 9, 100};
+    coord_t output[9];
+    ct.applyBatch(input, output, 3);
+    for (size_t i = 0; i < 3; ++i) {
+      coord_t expected[3];
+      ct.apply(input + i * 4, expected);
+      for (size_t d = 0; d < 3; ++d)
+        TS_ASSERT_EQUALS(output[i * 3 + d], expected[d]);
+    }
+  }
+
   /// Clone the transform, check that it still works
   void test_clone() {
     size_t dimToBinFrom[3] = {3, 1, 0};
@@ -13,11 +13,13 @@
 #include "MantidKernel/CPUTimer.h"
 #include "MantidKernel/Timer.h"
 #include "MantidKernel/Unit.h"
+#include "MantidKernel/VectorHelper.h"
 
 #include <cxxtest/TestSuite.h>
 
 #include <boost/scoped_ptr.hpp>
 #include <cmath>
+#include <random>
 
 using namespace Mantid;
 using namespace Mantid::API;
@@ -262,6 +264,44 @@ public:
     TS_ASSERT_EQUALS(rel[5].tof(), 50);
   }
 
+  void test_PlusOperator_merges_sorted_lists() {
+    EventList el1(std::vector<TofEvent>{{1.0, 10}, {5.0, 20}, {9.0, 30}});
+    EventList el2(std::vector<TofEvent>{{2.0, 5}, {6.0, 25}, {20.0, 40}});
+    el1.sortTof();
+    el2.sortTof();
+    el1 += el2;
+    TS_ASSERT_EQUALS(el1.getSortType(), TOF_SORT);
+    const std::vector<double> expected{1.0, 2.0, 5.0, 6.0, 9.0, 20.0};
+    TS_ASSERT_EQUALS(el1.getTofs(), expected);
+
+    // A run in a different order leaves the list unsorted
+    el1 += std::vector<TofEvent>{{3.0, 1}, {0.5, 2}};
+    TS_ASSERT_EQUALS(el1.getSortType(), UNSORTED);
+  }
+
+  void test_PlusOperator_merges_pulse_time_sorted_weighted_lists() {
+    EventList el1(std::vector<TofEvent>{{1.0, 10}, {5.0, 20}, {9.0, 30}});
+    el1.switchTo(WEIGHTED);
+    el1.sortPulseTimeTOF();
+    el1 += std::vector<WeightedEvent>{WeightedEvent(3.0, 20, 2.0, 4.0),
+                                      WeightedEvent(1.0, 35, 1.0, 1.0)};
+    TS_ASSERT_EQUALS(el1.getSortType(), PULSETIMETOF_SORT);
+    const auto &events = el1.getWeightedEvents();
+    TS_ASSERT_EQUALS(events.size(), 5);
+    const std::vector<double> expected{1.0, 3.0, 5.0, 9.0, 1.0};
+    TS_ASSERT_EQUALS(el1.getTofs(), expected);
+    TS_ASSERT_EQUALS(events[1].weight(), 2.0);
+  }
+
+  void test_PlusOperator_single_event_keeps_order_only_if_in_order() {
+    EventList el1(std::vector<TofEvent>{{1.0, 10}, {5.0, 20}});
+    el1.sortTof();
+    el1 += TofEvent(7.0, 0);
+    TS_ASSERT_EQUALS(el1.getSortType(), TOF_SORT);
+    el1 += TofEvent(2.0, 0);
+    TS_ASSERT_EQUALS(el1.getSortType(), UNSORTED);
+  }
+
   void test_DetectorIDs() {
     EventList el1;
     el1.addDetectorID(14);
@@ -794,6 +834,34 @@ public:
     }
   }
 
+  /// Long lists are radix sorted; check against std::sort
+  void test_sort_long_list_matches_std_sort() {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> tofDist(-100.0, 20000.0);
+    std::uniform_int_distribution<int64_t> pulseDist(0, 50);
+    std::vector<TofEvent> events;
+    for (size_t i = 0; i < 5000; ++i)
+      events.emplace_back(tofDist(gen), DateAndTime(pulseDist(gen)));
+
+    EventList tofSorted(events);
+    tofSorted.sortTof();
+    auto expected = events;
+    std::sort(expected.begin(), expected.end());
+    TS_ASSERT_EQUALS(tofSorted.getEvents(), expected);
+
+    EventList pulseTofSorted(events);
+    pulseTofSorted.switchTo(WEIGHTED);
+    pulseTofSorted.sortPulseTimeTOF();
+    const auto &sorted = pulseTofSorted.getWeightedEvents();
+    TS_ASSERT_EQUALS(sorted.size(), events.size());
+    for (size_t i = 1; i < sorted.size(); ++i) {
+      TS_ASSERT_LESS_THAN_EQUALS(sorted[i - 1].pulseTime(),
+                                 sorted[i].pulseTime());
+      if (sorted[i - 1].pulseTime() == sorted[i].pulseTime())
+        TS_ASSERT_LESS_THAN_EQUALS(sorted[i - 1].tof(), sorted[i].tof());
+    }
+  }
+
   //-----------------------------------------------------------------------------------------------
   void test_reverse_allTypes() {
     // Go through each possible EventType as the input
@@ -1237,6 +1305,28 @@ public:
     TS_ASSERT_EQUALS(this->el.ptrX()->size(), NUMBINS + 1);
   }
 
+  void test_histogram_log_and_arbitrary_bins_match_brute_force() {
+    MantidVec logX;
+    VectorHelper::createAxisFromRebinParams({10.0, -0.01, 2e7}, logX);
+    const MantidVec arbitraryX{0.0, 5.0, 1e3, 1.5e3, 2e5, 9e6, 2e7};
+    for (const auto eventType : {TOF, WEIGHTED}) {
+      const EventList el3(this->fake_data(eventType));
+      const auto tofs = el3.getTofs();
+      for (const auto &X : {logX, arbitraryX}) {
+        MantidVec Y, E;
+        el3.generateHistogram(X, Y, E);
+        MantidVec expected(X.size() - 1, 0.0);
+        for (const auto tof : tofs) {
+          for (size_t i = 0; i + 1 < X.size(); ++i) {
+            if (tof >= X[i] && tof < X[i + 1])
+              ++expected[i];
+          }
+        }
+        TS_ASSERT_EQUALS(Y, expected);
+      }
+    }
+  }
+
   //  void test_histogram_static_function()
   //  {
   //    std::vector<WeightedEvent> events;
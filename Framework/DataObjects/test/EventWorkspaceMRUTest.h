@@ -10,9 +10,12 @@
 #include "MantidKernel/Timer.h"
 #include <cxxtest/TestSuite.h>
 
+#include "MantidDataObjects/EventList.h"
 #include "MantidDataObjects/EventWorkspaceMRU.h"
 
 using namespace Mantid::DataObjects;
+using namespace Mantid::HistogramData;
+using Mantid::Kernel::make_cow;
 
 class EventWorkspaceMRUTest : public CxxTest::TestSuite {
 public:
@@ -21,4 +24,80 @@ public:
     TS_ASSERT_THROWS_NOTHING(mru.MRUSize());
     TS_ASSERT_EQUALS(mru.MRUSize(), 0);
   }
+
+  void test_find_after_insert() {
+    EventWorkspaceMRU mru(1024 * 1024);
+    EventList el;
+    const auto x = make_cow<HistogramX>(3, 0.0);
+    TS_ASSERT(!mru.findY(&el, x));
+    mru.insert(&el, x, make_cow<HistogramY>(2, 1.0),
+               make_cow<HistogramE>(2, 2.0));
+    TS_ASSERT_EQUALS(mru.MRUSize(), 1);
+    TS_ASSERT_EQUALS(mru.memoryUsed(), 4 * sizeof(double));
+    const auto y = mru.findY(&el, x);
+    const auto e = mru.findE(&el, x);
+    TS_ASSERT(y);
+    TS_ASSERT(e);
+    TS_ASSERT_EQUALS((*y)[1], 1.0);
+    TS_ASSERT_EQUALS((*e)[1], 2.0);
+    TS_ASSERT_EQUALS(mru.hits(), 2);
+    TS_ASSERT_EQUALS(mru.misses(), 1);
+
+    mru.deleteIndex(&el);
+    TS_ASSERT_EQUALS(mru.MRUSize(), 0);
+    TS_ASSERT_EQUALS(mru.memoryUsed(), 0);
+  }
+
+  void test_entry_for_other_bin_edges_is_dropped() {
+    EventWorkspaceMRU mru(1024 * 1024);
+    EventList el;
+    const auto x = make_cow<HistogramX>(3, 0.0);
+    mru.insert(&el, x, make_cow<HistogramY>(2, 1.0),
+               make_cow<HistogramE>(2, 1.0));
+    // Same values, but not the same bin edges object
+    const auto otherX = make_cow<HistogramX>(3, 0.0);
+    TS_ASSERT(!mru.findY(&el, otherX));
+    TS_ASSERT_EQUALS(mru.MRUSize(), 0);
+  }
+
+  void test_least_recently_used_is_evicted_over_budget() {
+    const size_t entryMemory = 2 * 10 * sizeof(double);
+    EventWorkspaceMRU mru(3 * entryMemory);
+    std::vector<EventList> lists(5);
+    const auto x = make_cow<HistogramX>(11, 0.0);
+    for (size_t i = 0; i < 3; ++i)
+      insert(mru, lists[i], x);
+    // Use the first so the second is now the oldest
+    TS_ASSERT(mru.findY(&lists[0], x));
+    insert(mru, lists[3], x);
+    TS_ASSERT_EQUALS(mru.MRUSize(), 3);
+    TS_ASSERT(mru.findY(&lists[0], x));
+    TS_ASSERT(!mru.findY(&lists[1], x));
+    TS_ASSERT(mru.findY(&lists[2], x));
+    TS_ASSERT(mru.findY(&lists[3], x));
+
+    mru.setMemoryBudget(entryMemory);
+    TS_ASSERT_EQUALS(mru.MRUSize(), 1);
+    TS_ASSERT_EQUALS(mru.memoryUsed(), entryMemory);
+
+    mru.clear();
+    TS_ASSERT_EQUALS(mru.MRUSize(), 0);
+    TS_ASSERT_EQUALS(mru.memoryUsed(), 0);
+  }
+
+  void test_zero_budget_disables_cache() {
+    EventWorkspaceMRU mru(0);
+    EventList el;
+    const auto x = make_cow<HistogramX>(11, 0.0);
+    insert(mru, el, x);
+    TS_ASSERT_EQUALS(mru.MRUSize(), 0);
+    TS_ASSERT(!mru.findY(&el, x));
+  }
+
+private:
+  void insert(EventWorkspaceMRU &mru, const EventList &el,
+              const EventWorkspaceMRU::XType &x) {
+    mru.insert(&el, x, make_cow<HistogramY>(10, 1.0),
+               make_cow<HistogramE>(10, 1.0));
+  }
 };
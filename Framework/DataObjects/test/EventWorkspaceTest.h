@@ -67,6 +67,11 @@ public:
     BIN_DELTA = 1000;
   }
 
+  /// Memory held by the MRU for one histogram (Y and E)
+  size_t histogramMemory() const {
+    return 2 * static_cast<size_t>(NUMBINS - 1) * sizeof(double);
+  }
+
   /** Create event workspace with:
    * 500 pixels
    * 1000 histogrammed bins.
@@ -322,6 +327,8 @@ public:
     // Try caching and most-recently-used MRU list.
     EventWorkspace_const_sptr ew2 =
         std::dynamic_pointer_cast<const EventWorkspace>(ew);
+    // Room for 50 histograms
+    ew2->setMRUMemoryBudget(50 * histogramMemory());
 
     // Are the returned arrays the right size?
     MantidVec data1 = ew2->dataY(1);
@@ -531,6 +538,8 @@ public:
     // Try caching and most-recently-used MRU list.
     EventWorkspace_const_sptr ew2 =
         std::dynamic_pointer_cast<const EventWorkspace>(ew);
+    // Room for 50 histograms
+    ew2->setMRUMemoryBudget(50 * histogramMemory());
 
     // OK, we grab data0 from the MRU.
     const auto &inSpec = ew2->getSpectrum(0);
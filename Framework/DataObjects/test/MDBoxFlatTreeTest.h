@@ -107,6 +107,30 @@ public:
       testFile.remove();
   }
 
+  void testBoxesFilePositionsFollowMortonOrder() {
+    MDBoxFlatTree BoxTree;
+    BoxTree.initFlatStructure(spEw3, "aFile");
+    BoxTree.setBoxesFilePositions(false);
+
+    const auto &eventIndex = BoxTree.getEventIndex();
+    const auto index = BoxTree.getMortonIndex();
+    const auto &entries = index.entries();
+    TS_ASSERT(!entries.empty());
+    // The events of the boxes follow each other on file in Morton order
+    uint64_t position = 0;
+    for (const auto &entry : entries) {
+      TS_ASSERT_EQUALS(eventIndex[2 * entry.boxId], position);
+      position += eventIndex[2 * entry.boxId + 1];
+    }
+    TS_ASSERT_EQUALS(position, spEw3->getNPoints());
+
+    const auto boxesInFileOrder = BoxTree.getBoxesInFileOrder();
+    TS_ASSERT_EQUALS(boxesInFileOrder.size(), entries.size());
+    for (size_t i = 1; i < boxesInFileOrder.size(); ++i)
+      TS_ASSERT_LESS_THAN(eventIndex[2 * boxesInFileOrder[i - 1]],
+                          eventIndex[2 * boxesInFileOrder[i]]);
+  }
+
 private:
   Mantid::API::IMDEventWorkspace_sptr spEw3;
 };
@@ -0,0 +1,79 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2020 ISIS Rutherford Appleton Laboratory UKRI,
+//   NScD Oak Ridge National Laboratory, European Spallation Source,
+//   Institut Laue - Langevin & CSNS, Institute of High Energy Physics, CAS
+// SPDX - License - Identifier: GPL - 3.0 +
+#pragma once
+
+#include "MantidDataObjects/MDBoxMortonIndex.h"
+
+#include <cxxtest/TestSuite.h>
+
+#include <limits>
+
+using Mantid::DataObjects::MDBoxMortonIndex;
+
+class MDBoxMortonIndexTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static MDBoxMortonIndexTest *createSuite() {
+    return new MDBoxMortonIndexTest();
+  }
+  static void destroySuite(MDBoxMortonIndexTest *suite) { delete suite; }
+
+  MDBoxMortonIndexTest() {
+    // A 4x4 grid of unit boxes below the top box, in row major order. Box
+    // 1 + x + 4 * y holds 10 events, except box 6 which is empty.
+    m_boxType.assign(17, 1);
+    m_boxType[0] = 2;
+    m_extents = {0., 4., 0., 4.};
+    m_eventIndex = {0, 0};
+    for (size_t y = 0; y < 4; ++y) {
+      for (size_t x = 0; x < 4; ++x) {
+        m_extents.insert(m_extents.end(), {double(x), double(x + 1), double(y),
+                                           double(y + 1)});
+        m_eventIndex.insert(m_eventIndex.end(), {0, 10});
+      }
+    }
+    m_eventIndex[2 * 6 + 1] = 0;
+  }
+
+  void test_arrays_must_match() {
+    m_boxType.pop_back();
+    TS_ASSERT_THROWS(MDBoxMortonIndex(2, m_boxType, m_extents, m_eventIndex),
+                     const std::invalid_argument &);
+  }
+
+  void test_boxes_are_in_Morton_order() {
+    const MDBoxMortonIndex index(2, m_boxType, m_extents, m_eventIndex);
+    TS_ASSERT_EQUALS(index.bitsPerDim(), 32);
+    const auto &entries = index.entries();
+    // Neither the grid box nor the empty box are in the index
+    TS_ASSERT_EQUALS(entries.size(), 15);
+    const std::vector<uint64_t> expected{1, 2, 5, 3, 4, 7, 8, 9,
+                                         10, 13, 14, 11, 12, 15, 16};
+    std::vector<uint64_t> boxes;
+    for (size_t i = 0; i < entries.size(); ++i) {
+      if (i > 0)
+        TS_ASSERT_LESS_THAN_EQUALS(entries[i - 1].lowKey, entries[i].lowKey);
+      boxes.emplace_back(entries[i].boxId);
+    }
+    TS_ASSERT_EQUALS(boxes, expected);
+  }
+
+  void test_key_of_points_outside_of_the_workspace() {
+    const MDBoxMortonIndex index(2, m_boxType, m_extents, m_eventIndex);
+    const double below[2] = {-1., -5.};
+    const double origin[2] = {0., 0.};
+    const double above[2] = {4., 10.};
+    TS_ASSERT_EQUALS(index.key(below), index.key(origin));
+    TS_ASSERT_EQUALS(index.key(above), std::numeric_limits<uint64_t>::max());
+  }
+
+private:
+  std::vector<int> m_boxType;
+  std::vector<double> m_extents;
+  std::vector<uint64_t> m_eventIndex;
+};
@@ -172,6 +172,26 @@ public:
     TS_ASSERT_DELTA(b.getErrorSquared(), 3.4 * 3, 1e-5);
   }
 
+  /** Move a vector of events into an empty box, then into a filled one */
+  void test_addEvents_by_moving() {
+    BoxController_sptr sc(new BoxController(2));
+    MDBox<MDLeanEvent<2>, 2> b(sc.get());
+    std::vector<MDLeanEvent<2>> vec(3, MDLeanEvent<2>(1.2, 3.4));
+    const auto *storage = vec.data();
+    b.addEvents(std::move(vec));
+    // The box takes over the storage of the events
+    TS_ASSERT_EQUALS(b.getEvents().data(), storage);
+
+    std::vector<MDLeanEvent<2>> more(2, MDLeanEvent<2>(2.0, 1.0));
+    b.addEvents(std::move(more));
+    b.refreshCache();
+
+    TS_ASSERT_EQUALS(b.getNPoints(), 5)
+    TS_ASSERT_DELTA(b.getEvents()[1].getSignal(), 1.2, 1e-5)
+    TS_ASSERT_DELTA(b.getEvents()[4].getSignal(), 2.0, 1e-5)
+    TS_ASSERT_DELTA(b.getSignal(), 1.2 * 3 + 2.0 * 2, 1e-5);
+  }
+
   /** Add a vector of events */
   void test_BuildAndAddLeanEvents() {
     BoxController_sptr sc(new BoxController(2));
@@ -896,6 +896,86 @@ public:
     delete bcc;
   }
 
+  //-------------------------------------------------------------------------------------
+  /** Adding a vector of events puts each event in the same box, and in the
+   * same order, as adding the events one by one */
+  void test_addEvents_matches_addEvent() {
+    auto single = MDEventsTestHelper::makeMDGridBox<2>();
+    auto bulk = MDEventsTestHelper::makeMDGridBox<2>();
+    // Go through a child that is a grid box too
+    single->splitContents(12);
+    bulk->splitContents(12);
+
+    std::mt19937 gen(12345);
+    std::uniform_real_distribution<double> position(0., 10.);
+    std::vector<MDLeanEvent<2>> events;
+    for (size_t i = 0; i < 2000; i++) {
+      coord_t centers[2] = {static_cast<coord_t>(position(gen)),
+                            static_cast<coord_t>(position(gen))};
+      events.emplace_back(static_cast<float>(i), 1.0f, centers);
+    }
+    for (const auto &event : events)
+      single->addEvent(event);
+    TS_ASSERT_EQUALS(bulk->addEvents(events), 0);
+
+    std::vector<API::IMDNode *> singleBoxes, bulkBoxes;
+    single->getBoxes(singleBoxes, 1000, true);
+    bulk->getBoxes(bulkBoxes, 1000, true);
+    TS_ASSERT_EQUALS(singleBoxes.size(), 199);
+    TS_ASSERT_EQUALS(singleBoxes.size(), bulkBoxes.size());
+    for (size_t i = 0; i < singleBoxes.size(); i++) {
+      auto singleBox = dynamic_cast<MDBox<MDLeanEvent<2>, 2> *>(singleBoxes[i]);
+      auto bulkBox = dynamic_cast<MDBox<MDLeanEvent<2>, 2> *>(bulkBoxes[i]);
+      TS_ASSERT_EQUALS(singleBox->getID(), bulkBox->getID());
+      const auto &singleEvents = singleBox->getConstEvents();
+      const auto &bulkEvents = bulkBox->getConstEvents();
+      TS_ASSERT_EQUALS(singleEvents.size(), bulkEvents.size());
+      for (size_t j = 0; j < std::min(singleEvents.size(), bulkEvents.size());
+           j++)
+        TS_ASSERT_EQUALS(singleEvents[j].getSignal(),
+                         bulkEvents[j].getSignal());
+    }
+
+    for (auto box : {single, bulk}) {
+      BoxController *const bc = box->getBoxController();
+      delete box;
+      delete bc;
+    }
+  }
+
+  //-------------------------------------------------------------------------------------
+  /** Events on the boundary between two children can be outside of the
+   * extents of the child their index falls in, because of rounding. They are
+   * kept, as addEvent() does, when that child is a grid box. */
+  void test_addEvents_on_child_boundaries_are_kept() {
+    auto single = MDEventsTestHelper::makeMDGridBox<2>(10, 10, 0.0f, 1.0f);
+    auto bulk = MDEventsTestHelper::makeMDGridBox<2>(10, 10, 0.0f, 1.0f);
+    // the children that 0.7 and 0.9 fall in
+    for (auto box : {single, bulk}) {
+      box->splitContents(66);
+      box->splitContents(88);
+    }
+
+    std::vector<MDLeanEvent<2>> events;
+    for (const coord_t x : {0.7f, 0.9f}) {
+      coord_t centers[2] = {x, x};
+      events.emplace_back(1.0f, 1.0f, centers);
+    }
+    for (const auto &event : events)
+      single->addEvent(event);
+    TS_ASSERT_EQUALS(bulk->addEvents(events), 0);
+
+    for (auto box : {single, bulk}) {
+      box->refreshCache(nullptr);
+      TS_ASSERT_EQUALS(box->getNPoints(), 2);
+      TS_ASSERT_EQUALS(box->getChild(66)->getNPoints(), 1);
+      TS_ASSERT_EQUALS(box->getChild(88)->getNPoints(), 1);
+      BoxController *const bc = box->getBoxController();
+      delete box;
+      delete bc;
+    }
+  }
+
   ////-------------------------------------------------------------------------------------
   ///** Tests add_events with limits into the vectorthat bad events are thrown
   /// out when using addEvents.
@@ -849,6 +849,25 @@ public:
     checkWorkspace(a, 6.0, 36. * (.5 + 1. / 3.), 2.0);
   }
 
+  //--------------------------------------------------------------------------------------
+  /** 40^3 bins are split into several tiles that are processed in parallel */
+  void test_plus_ws_spanning_several_tiles() {
+    MDHistoWorkspace_sptr a = MDEventsTestHelper::makeFakeMDHistoWorkspace(
+        0.0, 3, 40, 10.0, 1.0 /*errorSquared*/);
+    MDHistoWorkspace_sptr b = MDEventsTestHelper::makeFakeMDHistoWorkspace(
+        3.0, 3, 40, 10.0, 2.0 /*errorSquared*/);
+    for (size_t i = 0; i < a->getNPoints(); i++)
+      a->setSignalAt(i, double(i));
+    *a += *b;
+    size_t numWrong = 0;
+    for (size_t i = 0; i < a->getNPoints(); i++) {
+      if (std::abs(a->getSignalAt(i) - (double(i) + 3.0)) > 1e-5 ||
+          std::abs(a->getErrorAt(i) - std::sqrt(3.0)) > 1e-5)
+        numWrong++;
+    }
+    TS_ASSERT_EQUALS(numWrong, 0);
+  }
+
   //--------------------------------------------------------------------------------------
   void test_times_scalar() {
     MDHistoWorkspace_sptr a = MDEventsTestHelper::makeFakeMDHistoWorkspace(
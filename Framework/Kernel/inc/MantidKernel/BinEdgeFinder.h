@@ -0,0 +1,111 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2020 ISIS Rutherford Appleton Laboratory UKRI,
+//   NScD Oak Ridge National Laboratory, European Spallation Source,
+//   Institut Laue - Langevin & CSNS, Institute of High Energy Physics, CAS
+// SPDX - License - Identifier: GPL - 3.0 +
+#pragma once
+
+#include "MantidKernel/DllConfig.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace Mantid {
+namespace Kernel {
+
+/**
+ * BinEdgeFinder returns the index of the bin holding a value, given the bin
+ * edges of a histogram. It is the counterpart of BinFinder for when only the
+ * edges, and not the rebin parameters, are known.
+ *
+ * On construction the edges are inspected. If they are evenly spaced
+ * (linear binning) or evenly spaced in log(x) (logarithmic binning) the bin
+ * index is computed directly from the value, which is O(1) per value instead
+ * of the O(log n) binary search needed for arbitrary edges. The computed index
+ * is always checked against the real edges, so the result is identical to a
+ * binary search: bins are closed at their lower edge and open at their upper
+ * edge, and values outside of [X[0], X[n]) are not in any bin.
+ *
+ * The final bin may be narrower or wider than the others, as produced by
+ * Rebin when the range is not a whole number of steps.
+ *
+ * The finder keeps a reference to the edges, which must outlive it.
+ */
+class MANTID_KERNEL_DLL BinEdgeFinder {
+public:
+  /// How the bin index is found
+  enum class Mode { Linear, Logarithmic, Arbitrary };
+
+  BinEdgeFinder(const std::vector<double> &edges);
+
+  /// Return the binning mode detected from the edges
+  Mode mode() const { return m_mode; }
+  /// Return the number of bins, which is also the index returned for values
+  /// outside of the histogram
+  std::size_t numberOfBins() const { return m_numBins; }
+
+  inline std::size_t bin(const double x) const;
+
+  void bins(const double *x, const std::size_t n, std::size_t *indices) const;
+
+private:
+  inline std::size_t correct(std::size_t index, const double x) const;
+
+  /// The bin edges
+  const std::vector<double> &m_edges;
+  /// The binning mode
+  Mode m_mode;
+  /// The number of bins
+  std::size_t m_numBins;
+  /// First edge, or log of the first edge for logarithmic binning
+  double m_origin;
+  /// Inverse of the bin width, or of the log bin width
+  double m_inverseStep;
+};
+
+/** Find the bin index for a value.
+ * @param x :: value to histogram
+ * @return the index of the bin containing x, or numberOfBins() if x is outside
+ * of the histogram (or NaN).
+ */
+inline std::size_t BinEdgeFinder::bin(const double x) const {
+  // Written so that NaN is rejected too
+  if (!(x >= m_edges.front() && x < m_edges.back()))
+    return m_numBins;
+  switch (m_mode) {
+  case Mode::Linear:
+    return correct(static_cast<std::size_t>((x - m_origin) * m_inverseStep),
+                   x);
+  case Mode::Logarithmic:
+    return correct(
+        static_cast<std::size_t>((std::log(x) - m_origin) * m_inverseStep), x);
+  case Mode::Arbitrary:
+    break;
+  }
+  return static_cast<std::size_t>(
+      std::upper_bound(m_edges.cbegin(), m_edges.cend(), x) -
+      m_edges.cbegin() - 1);
+}
+
+/** Move an estimated bin index onto the bin that really contains x.
+ * Rounding means the estimate can be one bin out near an edge.
+ * @param index :: estimated bin index
+ * @param x :: value being histogrammed, known to be inside the histogram
+ * @return the index of the bin containing x
+ */
+inline std::size_t BinEdgeFinder::correct(std::size_t index,
+                                          const double x) const {
+  if (index >= m_numBins)
+    index = m_numBins - 1;
+  while (x < m_edges[index])
+    --index;
+  while (x >= m_edges[index + 1])
+    ++index;
+  return index;
+}
+
+} // namespace Kernel
+} // namespace Mantid
@@ -15,11 +15,15 @@
 #include <boost/multi_index/sequenced_index.hpp>
 #include <boost/multi_index_container.hpp>
 #endif
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
 #include <limits>
 #include <list>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace Mantid {
@@ -37,6 +41,11 @@ class ISaveable;
   It also stores a list of "free" blocks in the output file,
   to allow new blocks to fill them later.
 
+  Objects that are about to be used can be loaded ahead of time by a
+  background thread, see prefetch(). Loaded objects join the to-write buffer
+  on the next call to toWrite() or flushCache(), so they are only ever written
+  out or dropped from memory by the threads using the buffer.
+
   @date 2011-12-30
 */
 class DLLExport DiskBuffer {
@@ -61,12 +70,37 @@ public:
   DiskBuffer(uint64_t m_writeBufferSize);
   DiskBuffer(const DiskBuffer &) = delete;
   DiskBuffer &operator=(const DiskBuffer &) = delete;
-  virtual ~DiskBuffer() = default;
+  virtual ~DiskBuffer();
 
   void toWrite(ISaveable *item);
   void flushCache();
   void objectDeleted(ISaveable *item);
 
+  // Prefetching
+  void prefetch(const std::vector<ISaveable *> &items);
+  void waitForPrefetch();
+  void stopPrefetch();
+
+  // Access statistics
+  /** Count an access to the data of a saved object
+   * @param wasLoaded :: true if the data were already in memory */
+  void recordAccess(const bool wasLoaded) {
+    if (wasLoaded)
+      ++m_numHits;
+    else
+      ++m_numMisses;
+  }
+  /** Count data read from the file
+   * @param size :: amount read, in the units of the file positions */
+  void recordRead(const uint64_t size) { m_dataRead += size; }
+  /// @return the number of accesses that found the data in memory
+  uint64_t getNumHits() const { return m_numHits; }
+  /// @return the number of accesses that had to wait for the data to be read
+  uint64_t getNumMisses() const { return m_numMisses; }
+  /// @return the amount of data read, in the units of the file positions
+  uint64_t getDataRead() const { return m_dataRead; }
+  void resetStatistics();
+
   // Free space map methods
   void freeBlock(uint64_t const pos, uint64_t const size);
   void defragFreeBlocks();
@@ -117,6 +151,9 @@ public:
 
 protected:
   inline void writeOldObjects();
+  void addToBuffer(ISaveable *item);
+  void addPrefetchedToBuffer();
+  void prefetchLoop();
 
   // ----------------------- To-write buffer
   // --------------------------------------
@@ -151,6 +188,30 @@ protected:
   /// Length of the file. This is where new blocks that don't fit get placed.
   mutable uint64_t m_fileLength;
 
+  // ----------------------- Prefetching --------------------------------------
+  /// Objects waiting to be loaded by the prefetch thread, in order
+  std::deque<ISaveable *> m_prefetchQueue;
+  /// Objects loaded by the prefetch thread, not yet in the to-write buffer
+  std::vector<ISaveable *> m_prefetched;
+  /// Object being loaded by the prefetch thread
+  ISaveable *m_prefetchCurrent;
+  /// Set to make the prefetch thread exit
+  bool m_stopPrefetch;
+  /// Mutex for the prefetch queue and lists
+  std::mutex m_prefetchMutex;
+  /// Signals changes of the prefetch queue
+  std::condition_variable m_prefetchCondition;
+  /// Thread loading the prefetched objects, started on first use
+  std::thread m_prefetchThread;
+
+  // ----------------------- Statistics ---------------------------------------
+  /// Number of accesses that found the data in memory
+  std::atomic<uint64_t> m_numHits;
+  /// Number of accesses that had to wait for the data to be read
+  std::atomic<uint64_t> m_numMisses;
+  /// Amount of data read from the file
+  std::atomic<uint64_t> m_dataRead;
+
 private:
 };
 
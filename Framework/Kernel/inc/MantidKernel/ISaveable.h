@@ -7,6 +7,7 @@
 #pragma once
 
 #include "MantidKernel/System.h"
+#include <atomic>
 #include <list>
 #include <mutex>
 #ifndef Q_MOC_RUN
@@ -131,8 +132,9 @@ protected:
   /// representation on it (though this representation may be incorrect as data
   /// changed in memory)
   mutable bool m_wasSaved;
-  /// this boolean indicates, if the data have its copy in memory
-  bool m_isLoaded;
+  /// this boolean indicates, if the data have its copy in memory. Atomic as
+  /// the object may be loaded by the prefetch thread of the DiskBuffer
+  std::atomic<bool> m_isLoaded;
 
 private:
   // the iterator which describes the position of this object in the DiskBuffer.
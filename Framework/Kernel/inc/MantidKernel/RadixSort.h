@@ -0,0 +1,101 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2020 ISIS Rutherford Appleton Laboratory UKRI,
+//   NScD Oak Ridge National Laboratory, European Spallation Source,
+//   Institut Laue - Langevin & CSNS, Institute of High Energy Physics, CAS
+// SPDX - License - Identifier: GPL - 3.0 +
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace Mantid {
+namespace Kernel {
+namespace RadixSort {
+
+/** Map a double onto an unsigned integer with the same ordering, so that it
+ * can be used as a radix sort key. Negative values have all of their bits
+ * flipped, positive values only the sign bit.
+ * @param value :: the value to convert
+ * @return a key that compares like value
+ */
+inline uint64_t sortableKey(const double value) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  const uint64_t signBit = uint64_t(1) << 63;
+  return (bits & signBit) ? ~bits : (bits | signBit);
+}
+
+/** Map a signed 64-bit integer onto an unsigned integer with the same
+ * ordering, so that it can be used as a radix sort key.
+ * @param value :: the value to convert
+ * @return a key that compares like value
+ */
+inline uint64_t sortableKey(const int64_t value) {
+  return static_cast<uint64_t>(value) ^ (uint64_t(1) << 63);
+}
+
+/** Stable least-significant-digit radix sort of a vector by a 64-bit key.
+ *
+ * The key is split into eight 8-bit digits. All digit histograms are built
+ * in a single pass over the data, and passes where every value has the same
+ * digit (e.g. the high bytes of pulse times within one run) are skipped, so
+ * the sort costs a few linear passes rather than O(n log n) comparisons.
+ * A buffer the size of the input is needed; if the sorted data ends up in it
+ * the vectors are swapped rather than copied back.
+ *
+ * As the sort is stable, sorting by a secondary key and then by a primary key
+ * orders by (primary, secondary).
+ *
+ * @param values :: the values to sort
+ * @param key :: callable returning the uint64_t key of a value
+ */
+template <typename T, typename KeyFunction>
+void sort(std::vector<T> &values, KeyFunction key) {
+  constexpr size_t numDigits = sizeof(uint64_t);
+  constexpr size_t numBuckets = 256;
+  const size_t n = values.size();
+  if (n < 2)
+    return;
+
+  std::vector<std::array<size_t, numBuckets>> counts(numDigits);
+  for (auto &digitCounts : counts)
+    digitCounts.fill(0);
+  for (const auto &value : values) {
+    uint64_t k = key(value);
+    for (size_t digit = 0; digit < numDigits; ++digit, k >>= 8)
+      ++counts[digit][k & 0xFF];
+  }
+
+  std::vector<T> buffer(n);
+  T *source = values.data();
+  T *destination = buffer.data();
+  for (size_t digit = 0; digit < numDigits; ++digit) {
+    auto &digitCounts = counts[digit];
+    // Nothing to reorder if every value falls in the same bucket
+    const uint64_t firstDigit = (key(source[0]) >> (8 * digit)) & 0xFF;
+    if (digitCounts[firstDigit] == n)
+      continue;
+    // Turn the counts into the start offset of each bucket
+    size_t offset = 0;
+    for (auto &count : digitCounts) {
+      const size_t bucketSize = count;
+      count = offset;
+      offset += bucketSize;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      const auto bucket = (key(source[i]) >> (8 * digit)) & 0xFF;
+      destination[digitCounts[bucket]++] = source[i];
+    }
+    std::swap(source, destination);
+  }
+  if (source != values.data())
+    values.swap(buffer);
+}
+
+} // namespace RadixSort
+} // namespace Kernel
+} // namespace Mantid
@@ -0,0 +1,133 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2020 ISIS Rutherford Appleton Laboratory UKRI,
+//   NScD Oak Ridge National Laboratory, European Spallation Source,
+//   Institut Laue - Langevin & CSNS, Institute of High Energy Physics, CAS
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidKernel/BinEdgeFinder.h"
+
+#include <stdexcept>
+
+namespace Mantid {
+namespace Kernel {
+
+namespace {
+/// Number of values whose bin is estimated in one go by BinEdgeFinder::bins
+constexpr std::size_t BLOCK_SIZE = 256;
+
+/** Check that the edges before the final one follow origin + i * step in the
+ * given coordinate to within a quarter of a step, so that a computed bin
+ * index is at most one bin out.
+ * @param edges :: the bin edges
+ * @param transform :: coordinate in which the spacing should be even
+ * @param origin :: transformed first edge
+ * @param step :: transformed bin width
+ * @return true if the spacing is even
+ */
+template <typename Transform>
+bool isEvenlySpaced(const std::vector<double> &edges, Transform transform,
+                    const double origin, const double step) {
+  if (!(step > 0.) || !std::isfinite(step))
+    return false;
+  const double tolerance = 0.25 * step;
+  for (std::size_t i = 1; i + 1 < edges.size(); ++i) {
+    const double expected = origin + static_cast<double>(i) * step;
+    if (std::fabs(transform(edges[i]) - expected) > tolerance)
+      return false;
+  }
+  return true;
+}
+} // namespace
+
+/** Constructor. Inspects the edges to choose how bins will be found.
+ * @param edges :: the bin edges, in ascending order. At least two are needed.
+ * @throw std::invalid_argument if there are fewer than two edges
+ */
+BinEdgeFinder::BinEdgeFinder(const std::vector<double> &edges)
+    : m_edges(edges), m_mode(Mode::Arbitrary), m_numBins(0), m_origin(0.),
+      m_inverseStep(0.) {
+  if (edges.size() < 2)
+    throw std::invalid_argument("BinEdgeFinder: at least two bin edges are "
+                                "needed to define a bin.");
+  m_numBins = edges.size() - 1;
+  if (!(edges.back() > edges.front()))
+    return;
+  // The final edge is not used to work out the step: Rebin can make the final
+  // bin up to 25% narrower or wider than the others.
+  const double front = edges.front();
+  const std::size_t steps = m_numBins > 1 ? m_numBins - 1 : 1;
+  const double lastRegular = m_numBins > 1 ? edges[m_numBins - 1] : edges[1];
+
+  const double linearStep = (lastRegular - front) / static_cast<double>(steps);
+  if (isEvenlySpaced(
+          edges, [](const double x) { return x; }, front, linearStep)) {
+    m_mode = Mode::Linear;
+    m_origin = front;
+    m_inverseStep = 1. / linearStep;
+    return;
+  }
+
+  if (front > 0.) {
+    const double logFront = std::log(front);
+    const double logStep =
+        (std::log(lastRegular) - logFront) / static_cast<double>(steps);
+    if (isEvenlySpaced(
+            edges, [](const double x) { return std::log(x); }, logFront,
+            logStep)) {
+      m_mode = Mode::Logarithmic;
+      m_origin = logFront;
+      m_inverseStep = 1. / logStep;
+    }
+  }
+}
+
+/** Find the bin index for many values at once. For linear and logarithmic
+ * binning the estimated indices of a block of values are computed in a
+ * branch-free loop that the compiler can vectorise, and are then corrected
+ * against the edges.
+ * @param x :: the values to histogram
+ * @param n :: the number of values
+ * @param indices :: output; the bin index of each value, or numberOfBins() if
+ * it is outside of the histogram. Must have space for n values.
+ */
+void BinEdgeFinder::bins(const double *x, const std::size_t n,
+                         std::size_t *indices) const {
+  if (m_mode == Mode::Arbitrary) {
+    for (std::size_t i = 0; i < n; ++i)
+      indices[i] = bin(x[i]);
+    return;
+  }
+
+  const double front = m_edges.front();
+  const double back = m_edges.back();
+  const double maxEstimate = static_cast<double>(m_numBins - 1);
+  double estimate[BLOCK_SIZE];
+  for (std::size_t start = 0; start < n; start += BLOCK_SIZE) {
+    const std::size_t count = std::min(BLOCK_SIZE, n - start);
+    const double *block = x + start;
+    if (m_mode == Mode::Linear) {
+      for (std::size_t i = 0; i < count; ++i)
+        estimate[i] = (block[i] - m_origin) * m_inverseStep;
+    } else {
+      // Values outside of the histogram are rejected below; use the front
+      // edge for them so that log() is always given a positive number.
+      for (std::size_t i = 0; i < count; ++i)
+        estimate[i] =
+            (std::log(std::max(block[i], front)) - m_origin) * m_inverseStep;
+    }
+    for (std::size_t i = 0; i < count; ++i)
+      estimate[i] = std::min(std::max(estimate[i], 0.), maxEstimate);
+
+    for (std::size_t i = 0; i < count; ++i) {
+      const double value = block[i];
+      if (value >= front && value < back)
+        indices[start + i] =
+            correct(static_cast<std::size_t>(estimate[i]), value);
+      else
+        indices[start + i] = m_numBins;
+    }
+  }
+}
+
+} // namespace Kernel
+} // namespace Mantid
@@ -6,6 +6,7 @@
 // SPDX - License - Identifier: GPL - 3.0 +
 #include "MantidKernel/DiskBuffer.h"
 #include "MantidKernel/ISaveable.h"
+#include <algorithm>
 #include <sstream>
 #include <utility>
 
@@ -19,7 +20,9 @@ namespace Kernel {
  */
 DiskBuffer::DiskBuffer()
     : m_writeBufferSize(50), m_writeBufferUsed(0), m_nObjectsToWrite(0),
-      m_free(), m_free_bySize(m_free.get<1>()), m_fileLength(0) {
+      m_free(), m_free_bySize(m_free.get<1>()), m_fileLength(0),
+      m_prefetchCurrent(nullptr), m_stopPrefetch(false), m_numHits(0),
+      m_numMisses(0), m_dataRead(0) {
   m_free.clear();
 }
 
@@ -33,10 +36,16 @@ DiskBuffer::DiskBuffer()
 DiskBuffer::DiskBuffer(uint64_t m_writeBufferSize)
     : m_writeBufferSize(m_writeBufferSize), m_writeBufferUsed(0),
       m_nObjectsToWrite(0), m_free(), m_free_bySize(m_free.get<1>()),
-      m_fileLength(0) {
+      m_fileLength(0), m_prefetchCurrent(nullptr), m_stopPrefetch(false),
+      m_numHits(0), m_numMisses(0), m_dataRead(0) {
   m_free.clear();
 }
 
+//----------------------------------------------------------------------------------------------
+/** Destructor. Stops the prefetch thread.
+ */
+DiskBuffer::~DiskBuffer() { stopPrefetch(); }
+
 //---------------------------------------------------------------------------------------------
 /** Call this method when an object is ready to be written
  * out to disk.
@@ -51,6 +60,21 @@ void DiskBuffer::toWrite(ISaveable *item) {
     return;
   //    if (!m_useWriteBuffer) return;
 
+  addPrefetchedToBuffer();
+  addToBuffer(item);
+
+  // Should we now write out the old data?
+  if (m_writeBufferUsed > m_writeBufferSize)
+    writeOldObjects();
+}
+
+//---------------------------------------------------------------------------------------------
+/** Put an object in the to-write buffer, or update its size if it is already
+ * there.
+ *
+ * @param item :: item that can be written to disk.
+ */
+void DiskBuffer::addToBuffer(ISaveable *item) {
   if (item->getBufPostion()) // already in the buffer and probably have changed
                              // its size in memory
   {
@@ -68,10 +92,22 @@ void DiskBuffer::toWrite(ISaveable *item) {
     m_writeBufferUsed += item->setBufferPosition(m_toWriteBuffer.begin());
     m_nObjectsToWrite++;
   }
+}
 
-  // Should we now write out the old data?
-  if (m_writeBufferUsed > m_writeBufferSize)
-    writeOldObjects();
+//---------------------------------------------------------------------------------------------
+/** Put the objects loaded by the prefetch thread in the to-write buffer, so
+ * that they can be dropped from memory again.
+ */
+void DiskBuffer::addPrefetchedToBuffer() {
+  std::vector<ISaveable *> prefetched;
+  {
+    std::lock_guard<std::mutex> lock(m_prefetchMutex);
+    if (m_prefetched.empty())
+      return;
+    prefetched.swap(m_prefetched);
+  }
+  for (auto item : prefetched)
+    addToBuffer(item);
 }
 
 //---------------------------------------------------------------------------------------------
@@ -85,6 +121,18 @@ void DiskBuffer::toWrite(ISaveable *item) {
 void DiskBuffer::objectDeleted(ISaveable *item) {
   if (item == nullptr)
     return;
+  {
+    // Forget any prefetch of the object, waiting for it if it is running
+    std::unique_lock<std::mutex> prefetchLock(m_prefetchMutex);
+    m_prefetchQueue.erase(
+        std::remove(m_prefetchQueue.begin(), m_prefetchQueue.end(), item),
+        m_prefetchQueue.end());
+    m_prefetchCondition.wait(
+        prefetchLock, [this, item] { return m_prefetchCurrent != item; });
+    m_prefetched.erase(
+        std::remove(m_prefetched.begin(), m_prefetched.end(), item),
+        m_prefetched.end());
+  }
   // have it ever been in the buffer?
   std::unique_lock<std::mutex> uniqueLock(m_mutex);
   auto opt2it = item->getBufPostion();
@@ -107,6 +155,10 @@ void DiskBuffer::objectDeleted(ISaveable *item) {
 //---------------------------------------------------------------------------------------------
 /** Method to write out the old objects that have been
  * stored in the "toWrite" buffer.
+ *
+ * The space on file of all of the objects is found first, then they are
+ * written out in order of file position, so that the file is written
+ * sequentially rather than at random.
  */
 void DiskBuffer::writeOldObjects() {
 
@@ -116,6 +168,14 @@ void DiskBuffer::writeOldObjects() {
   size_t objectsNotWritten(0);
   size_t memoryNotWritten(0);
 
+  /// An object to write, with where to write it
+  struct BlockToWrite {
+    uint64_t position;
+    uint64_t size;
+    ISaveable *object;
+  };
+  std::vector<BlockToWrite> toSave;
+
   // Iterate through the list
   auto it = m_toWriteBuffer.begin();
   auto it_end = m_toWriteBuffer.end();
@@ -126,41 +186,37 @@ void DiskBuffer::writeOldObjects() {
     obj = *it;
     if (!obj->isBusy()) {
       uint64_t NumObjEvents = obj->getTotalDataSize();
-      uint64_t fileIndexStart;
       if (!obj->wasSaved()) {
-        fileIndexStart = this->allocate(NumObjEvents);
-        // Write to the disk; this will call the object specific save function;
-        // Prevent simultaneous file access (e.g. write while loading)
-        obj->saveAt(fileIndexStart, NumObjEvents);
+        toSave.push_back({this->allocate(NumObjEvents), NumObjEvents, obj});
       } else {
         uint64_t NumFileEvents = obj->getFileSize();
         if (NumObjEvents != NumFileEvents) {
+          // Read the old contents now: once relocated, its old place in the
+          // file may be given to an object that is written before it
+          obj->load();
           // Event list changed size. The MRU can tell us where it best fits
           // now.
-          fileIndexStart = this->relocate(obj->getFilePosition(), NumFileEvents,
-                                          NumObjEvents);
-          // Write to the disk; this will call the object specific save
-          // function;
-          obj->saveAt(fileIndexStart, NumObjEvents);
+          const uint64_t fileIndexStart = this->relocate(
+              obj->getFilePosition(), NumFileEvents, NumObjEvents);
+          toSave.push_back({fileIndexStart, NumObjEvents, obj});
         } else // despite object size have not been changed, it can be modified
                // other way. In this case, the method which changed the data
                // should set dataChanged ID
         {
           if (obj->isDataChanged()) {
-            fileIndexStart = obj->getFilePosition();
-            // Write to the disk; this will call the object specific save
-            // function;
-            obj->saveAt(fileIndexStart, NumObjEvents);
+            const uint64_t fileIndexStart = obj->getFilePosition();
+            toSave.push_back({fileIndexStart, NumObjEvents, obj});
             // this is questionable operation, which adjust file size in case
             // when the file postions were allocated externaly
             if (fileIndexStart + NumObjEvents > m_fileLength)
               m_fileLength = fileIndexStart + NumObjEvents;
-          } else // just clean the object up -- it just occupies memory
+          } else { // just clean the object up -- it just occupies memory
             obj->clearDataFromMemory();
+            // tell the object that it has been removed from the buffer
+            obj->clearBufferState();
+          }
         }
       }
-      // tell the object that it has been removed from the buffer
-      obj->clearBufferState();
     } else // object busy
     {
       // The object is busy, can't write. Save it for later
@@ -174,6 +230,17 @@ void DiskBuffer::writeOldObjects() {
     }
   }
 
+  std::sort(toSave.begin(), toSave.end(),
+            [](const BlockToWrite &a, const BlockToWrite &b) {
+              return a.position < b.position;
+            });
+  for (const auto &block : toSave) {
+    // Write to the disk; this will call the object specific save function;
+    block.object->saveAt(block.position, block.size);
+    // tell the object that it has been removed from the buffer
+    block.object->clearBufferState();
+  }
+
   // use last object to clear NeXus buffer and actually write data to HDD
   if (obj) {
     // NXS needs to flush the writes to file by closing and re-opening the data
@@ -193,10 +260,105 @@ void DiskBuffer::writeOldObjects() {
 /** Flush out all the data in the memory; and writes out everything in the
  * to-write cache. */
 void DiskBuffer::flushCache() {
+  addPrefetchedToBuffer();
   // Now write everything out.
   writeOldObjects();
 }
 
+//---------------------------------------------------------------------------------------------
+/** Load objects in a background thread ahead of their use. The objects are
+ * loaded in the order given, after any still queued from earlier calls.
+ * Objects that were never saved or are already loaded are skipped.
+ *
+ * @param items :: the objects that will be used soon, in order of use
+ */
+void DiskBuffer::prefetch(const std::vector<ISaveable *> &items) {
+  std::lock_guard<std::mutex> lock(m_prefetchMutex);
+  bool added(false);
+  for (auto item : items) {
+    if (item && item->wasSaved() && !item->isLoaded()) {
+      m_prefetchQueue.emplace_back(item);
+      added = true;
+    }
+  }
+  if (!added)
+    return;
+  if (!m_prefetchThread.joinable()) {
+    m_stopPrefetch = false;
+    m_prefetchThread = std::thread(&DiskBuffer::prefetchLoop, this);
+  }
+  m_prefetchCondition.notify_all();
+}
+
+//---------------------------------------------------------------------------------------------
+/** Wait until the prefetch thread has loaded all of the queued objects.
+ */
+void DiskBuffer::waitForPrefetch() {
+  std::unique_lock<std::mutex> lock(m_prefetchMutex);
+  m_prefetchCondition.wait(lock, [this] {
+    return m_prefetchQueue.empty() && m_prefetchCurrent == nullptr;
+  });
+}
+
+//---------------------------------------------------------------------------------------------
+/** Drop the queued prefetches and stop the prefetch thread, waiting for the
+ * object being loaded. To be called before the file is closed. A later call
+ * to prefetch() starts the thread again.
+ */
+void DiskBuffer::stopPrefetch() {
+  {
+    std::lock_guard<std::mutex> lock(m_prefetchMutex);
+    m_prefetchQueue.clear();
+    m_stopPrefetch = true;
+  }
+  m_prefetchCondition.notify_all();
+  if (m_prefetchThread.joinable())
+    m_prefetchThread.join();
+}
+
+//---------------------------------------------------------------------------------------------
+/** Reset the counters of accesses and of data read.
+ */
+void DiskBuffer::resetStatistics() {
+  m_numHits = 0;
+  m_numMisses = 0;
+  m_dataRead = 0;
+}
+
+//---------------------------------------------------------------------------------------------
+/** Body of the prefetch thread: load the queued objects one at a time.
+ */
+void DiskBuffer::prefetchLoop() {
+  std::unique_lock<std::mutex> lock(m_prefetchMutex);
+  while (true) {
+    m_prefetchCondition.wait(lock, [this] {
+      return m_stopPrefetch || !m_prefetchQueue.empty();
+    });
+    if (m_stopPrefetch)
+      return;
+    ISaveable *item = m_prefetchQueue.front();
+    m_prefetchQueue.pop_front();
+    m_prefetchCurrent = item;
+    lock.unlock();
+
+    bool loaded(false);
+    try {
+      if (!item->isLoaded()) {
+        item->load();
+        loaded = true;
+      }
+    } catch (...) {
+      // The object is loaded again when it is used, which reports the error
+    }
+
+    lock.lock();
+    m_prefetchCurrent = nullptr;
+    if (loaded)
+      m_prefetched.emplace_back(item);
+    m_prefetchCondition.notify_all();
+  }
+}
+
 //---------------------------------------------------------------------------------------------
 /** This method is called by this->relocate when object that has shrunk
  * and so has left a bit of free space after itself on the file;
@@ -0,0 +1,135 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2020 ISIS Rutherford Appleton Laboratory UKRI,
+//   NScD Oak Ridge National Laboratory, European Spallation Source,
+//   Institut Laue - Langevin & CSNS, Institute of High Energy Physics, CAS
+// SPDX - License - Identifier: GPL - 3.0 +
+#pragma once
+
+#include "MantidKernel/BinEdgeFinder.h"
+#include "MantidKernel/VectorHelper.h"
+#include <cxxtest/TestSuite.h>
+
+#include <limits>
+#include <random>
+
+using namespace Mantid::Kernel;
+
+class BinEdgeFinderTest : public CxxTest::TestSuite {
+public:
+  void test_too_few_edges_throws() {
+    std::vector<double> edges{1.0};
+    TS_ASSERT_THROWS(BinEdgeFinder finder(edges),
+                     const std::invalid_argument &);
+  }
+
+  void test_linear_bins() {
+    std::vector<double> edges;
+    VectorHelper::createAxisFromRebinParams({0.0, 2.0, 100.0}, edges);
+    BinEdgeFinder finder(edges);
+    TS_ASSERT_EQUALS(finder.mode(), BinEdgeFinder::Mode::Linear);
+    TS_ASSERT_EQUALS(finder.numberOfBins(), 50);
+    TS_ASSERT_EQUALS(finder.bin(-0.1), 50);
+    TS_ASSERT_EQUALS(finder.bin(100.0), 50);
+    TS_ASSERT_EQUALS(finder.bin(0.0), 0);
+    TS_ASSERT_EQUALS(finder.bin(1.999), 0);
+    TS_ASSERT_EQUALS(finder.bin(2.0), 1);
+    TS_ASSERT_EQUALS(finder.bin(99.0), 49);
+  }
+
+  void test_linear_bins_with_short_final_bin() {
+    std::vector<double> edges;
+    VectorHelper::createAxisFromRebinParams({0.0, 2.0, 101.0}, edges);
+    BinEdgeFinder finder(edges);
+    TS_ASSERT_EQUALS(finder.mode(), BinEdgeFinder::Mode::Linear);
+    compareWithBinarySearch(edges, finder);
+  }
+
+  void test_logarithmic_bins() {
+    std::vector<double> edges;
+    VectorHelper::createAxisFromRebinParams({2.0, -1.0, 1024.0}, edges);
+    BinEdgeFinder finder(edges);
+    TS_ASSERT_EQUALS(finder.mode(), BinEdgeFinder::Mode::Logarithmic);
+    TS_ASSERT_EQUALS(finder.bin(1.8), finder.numberOfBins());
+    TS_ASSERT_EQUALS(finder.bin(2.0), 0);
+    TS_ASSERT_EQUALS(finder.bin(3.999), 0);
+    TS_ASSERT_EQUALS(finder.bin(4.0), 1);
+    TS_ASSERT_EQUALS(finder.bin(512.1), 8);
+    compareWithBinarySearch(edges, finder);
+  }
+
+  void test_arbitrary_bins() {
+    std::vector<double> edges{0.0, 1.0, 1.5, 7.0, 7.1, 20.0};
+    BinEdgeFinder finder(edges);
+    TS_ASSERT_EQUALS(finder.mode(), BinEdgeFinder::Mode::Arbitrary);
+    TS_ASSERT_EQUALS(finder.bin(1.2), 1);
+    TS_ASSERT_EQUALS(finder.bin(7.05), 3);
+    TS_ASSERT_EQUALS(finder.bin(20.0), 5);
+    compareWithBinarySearch(edges, finder);
+  }
+
+  void test_nan_is_outside_histogram() {
+    std::vector<double> edges{0.0, 1.0, 2.0};
+    BinEdgeFinder finder(edges);
+    TS_ASSERT_EQUALS(finder.bin(std::numeric_limits<double>::quiet_NaN()), 2);
+  }
+
+  void test_bins_matches_bin() {
+    std::vector<double> edges;
+    VectorHelper::createAxisFromRebinParams({10.0, -0.01, 20000.0}, edges);
+    BinEdgeFinder finder(edges);
+    std::vector<double> values(1000);
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(0.0, 25000.0);
+    std::generate(values.begin(), values.end(), [&]() { return dist(gen); });
+    std::vector<size_t> indices(values.size());
+    finder.bins(values.data(), values.size(), indices.data());
+    for (size_t i = 0; i < values.size(); ++i)
+      TS_ASSERT_EQUALS(indices[i], finder.bin(values[i]));
+  }
+
+private:
+  void compareWithBinarySearch(const std::vector<double> &edges,
+                               const BinEdgeFinder &finder) {
+    const double range = edges.back() - edges.front();
+    for (int i = -10; i <= 1010; ++i) {
+      const double x = edges.front() + range * static_cast<double>(i) / 1000.;
+      const auto it = std::upper_bound(edges.cbegin(), edges.cend(), x);
+      size_t expected = edges.size() - 1;
+      if (it != edges.cbegin() && it != edges.cend())
+        expected = static_cast<size_t>(std::distance(edges.cbegin(), it) - 1);
+      TS_ASSERT_EQUALS(finder.bin(x), expected);
+    }
+    // The edges themselves start a new bin
+    for (size_t i = 0; i + 1 < edges.size(); ++i)
+      TS_ASSERT_EQUALS(finder.bin(edges[i]), i);
+  }
+};
+
+class BinEdgeFinderTestPerformance : public CxxTest::TestSuite {
+public:
+  static BinEdgeFinderTestPerformance *createSuite() {
+    return new BinEdgeFinderTestPerformance();
+  }
+  static void destroySuite(BinEdgeFinderTestPerformance *suite) {
+    delete suite;
+  }
+
+  BinEdgeFinderTestPerformance() : m_values(10000000), m_indices(10000000) {
+    VectorHelper::createAxisFromRebinParams({0.0, 1.0, 100000.0}, m_edges);
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(0.0, 100000.0);
+    std::generate(m_values.begin(), m_values.end(),
+                  [&]() { return dist(gen); });
+  }
+
+  void test_linear_bins() {
+    BinEdgeFinder finder(m_edges);
+    finder.bins(m_values.data(), m_values.size(), m_indices.data());
+  }
+
+private:
+  std::vector<double> m_edges;
+  std::vector<double> m_values;
+  std::vector<size_t> m_indices;
+};
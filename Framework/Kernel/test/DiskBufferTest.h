@@ -673,6 +673,62 @@ public:
     delete blockD;
     // std::cout <<  ISaveableTesterWithFile::fakeFile << "!\n";
   }
+
+  //--------------------------------------------------------------------------------
+  /** Objects are loaded in the background and join the to-write buffer
+   * when it is next used */
+  void test_prefetch_loads_objects() {
+    DiskBuffer dbuf(100);
+    std::vector<ISaveable *> items;
+    for (size_t i = 0; i < 4; i++) {
+      data[i]->clearDataFromMemory();
+      items.emplace_back(data[i]);
+    }
+    // Objects never saved are not loaded
+    data[4]->setSaved(false);
+    items.emplace_back(data[4]);
+    dbuf.prefetch(items);
+    dbuf.waitForPrefetch();
+    for (size_t i = 0; i < 4; i++) {
+      TS_ASSERT(data[i]->isLoaded());
+      TS_ASSERT_EQUALS(data[i]->m_memory, 2);
+    }
+    TS_ASSERT_EQUALS(dbuf.getWriteBufferUsed(), 0);
+
+    dbuf.toWrite(data[5]);
+    TS_ASSERT_EQUALS(dbuf.getWriteBufferUsed(), 10);
+    // Nothing changed: the objects are dropped from memory without writing
+    dbuf.flushCache();
+    TS_ASSERT_EQUALS(dbuf.getWriteBufferUsed(), 0);
+    TS_ASSERT(!data[0]->isLoaded());
+    TS_ASSERT_EQUALS(SaveableTesterWithFile::fakeFile, "");
+  }
+
+  void test_objectDeleted_forgets_prefetch() {
+    DiskBuffer dbuf(100);
+    data[0]->clearDataFromMemory();
+    dbuf.prefetch({data[0]});
+    dbuf.objectDeleted(data[0]);
+    dbuf.waitForPrefetch();
+    dbuf.flushCache();
+    TS_ASSERT_EQUALS(dbuf.getWriteBufferUsed(), 0);
+    dbuf.stopPrefetch();
+  }
+
+  void test_statistics() {
+    DiskBuffer dbuf(100);
+    dbuf.recordAccess(true);
+    dbuf.recordAccess(true);
+    dbuf.recordAccess(false);
+    dbuf.recordRead(12);
+    TS_ASSERT_EQUALS(dbuf.getNumHits(), 2);
+    TS_ASSERT_EQUALS(dbuf.getNumMisses(), 1);
+    TS_ASSERT_EQUALS(dbuf.getDataRead(), 12);
+    dbuf.resetStatistics();
+    TS_ASSERT_EQUALS(dbuf.getNumHits(), 0);
+    TS_ASSERT_EQUALS(dbuf.getNumMisses(), 0);
+    TS_ASSERT_EQUALS(dbuf.getDataRead(), 0);
+  }
 };
 //====================================================================================
 // THIS TEST DOES NOT PROBABLY EXIST IN A WHILD ANY MORE; LEFT JUST IN CASE
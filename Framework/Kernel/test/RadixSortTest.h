@@ -0,0 +1,89 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2020 ISIS Rutherford Appleton Laboratory UKRI,
+//   NScD Oak Ridge National Laboratory, European Spallation Source,
+//   Institut Laue - Langevin & CSNS, Institute of High Energy Physics, CAS
+// SPDX - License - Identifier: GPL - 3.0 +
+#pragma once
+
+#include "MantidKernel/RadixSort.h"
+#include <cxxtest/TestSuite.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+
+using namespace Mantid::Kernel;
+
+class RadixSortTest : public CxxTest::TestSuite {
+public:
+  void test_sortableKey_double_preserves_order() {
+    const double inf = std::numeric_limits<double>::infinity();
+    const std::vector<double> values{-inf, -1.e10, -2.5, -0.0, 0.0,
+                                     1.e-300, 2.5, 1.e10, inf};
+    for (size_t i = 0; i + 1 < values.size(); ++i)
+      TS_ASSERT_LESS_THAN_EQUALS(RadixSort::sortableKey(values[i]),
+                                 RadixSort::sortableKey(values[i + 1]));
+  }
+
+  void test_sortableKey_int64_preserves_order() {
+    const std::vector<int64_t> values{std::numeric_limits<int64_t>::min(),
+                                      -1000, -1, 0, 1, 1000,
+                                      std::numeric_limits<int64_t>::max()};
+    for (size_t i = 0; i + 1 < values.size(); ++i)
+      TS_ASSERT_LESS_THAN(RadixSort::sortableKey(values[i]),
+                          RadixSort::sortableKey(values[i + 1]));
+  }
+
+  void test_sort_empty_and_single() {
+    std::vector<double> values;
+    TS_ASSERT_THROWS_NOTHING(RadixSort::sort(values, doubleKey));
+    values.emplace_back(3.0);
+    RadixSort::sort(values, doubleKey);
+    TS_ASSERT_EQUALS(values, std::vector<double>{3.0});
+  }
+
+  void test_sort_doubles_matches_std_sort() {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(-1.e5, 1.e5);
+    std::vector<double> values(5000);
+    std::generate(values.begin(), values.end(), [&]() { return dist(gen); });
+    auto expected = values;
+    std::sort(expected.begin(), expected.end());
+    RadixSort::sort(values, doubleKey);
+    TS_ASSERT_EQUALS(values, expected);
+  }
+
+  void test_sort_int64_matches_std_sort() {
+    std::mt19937_64 gen(42);
+    std::uniform_int_distribution<int64_t> dist(-1000000000000, 1000000000000);
+    std::vector<int64_t> values(5000);
+    std::generate(values.begin(), values.end(), [&]() { return dist(gen); });
+    auto expected = values;
+    std::sort(expected.begin(), expected.end());
+    RadixSort::sort(values, [](int64_t value) {
+      return RadixSort::sortableKey(value);
+    });
+    TS_ASSERT_EQUALS(values, expected);
+  }
+
+  void test_sort_is_stable() {
+    // Sort by the first member only; the second records the input position
+    std::vector<std::pair<int64_t, size_t>> values;
+    for (size_t i = 0; i < 1000; ++i)
+      values.emplace_back(static_cast<int64_t>(i % 7), i);
+    RadixSort::sort(values, [](const std::pair<int64_t, size_t> &value) {
+      return RadixSort::sortableKey(value.first);
+    });
+    for (size_t i = 0; i + 1 < values.size(); ++i) {
+      TS_ASSERT_LESS_THAN_EQUALS(values[i].first, values[i + 1].first);
+      if (values[i].first == values[i + 1].first)
+        TS_ASSERT_LESS_THAN(values[i].second, values[i + 1].second);
+    }
+  }
+
+private:
+  static uint64_t doubleKey(double value) {
+    return RadixSort::sortableKey(value);
+  }
+};
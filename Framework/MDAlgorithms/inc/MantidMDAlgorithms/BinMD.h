@@ -67,9 +67,20 @@ private:
   template <typename MDE, size_t nd>
   void binByIterating(typename DataObjects::MDEventWorkspace<MDE, nd>::sptr ws);
 
+  /// How the events of a MDBox are binned
+  enum class BoxBinning { Skip, WholeBox, Events };
+
+  /// Method to work out how a single MDBox is binned
+  template <typename MDE, size_t nd>
+  BoxBinning classifyMDBox(DataObjects::MDBox<MDE, nd> *box,
+                           const size_t *const chunkMin,
+                           const size_t *const chunkMax,
+                           size_t &linearIndex) const;
+
   /// Method to bin a single MDBox
   template <typename MDE, size_t nd>
-  void binMDBox(DataObjects::MDBox<MDE, nd> *box, const size_t *const chunkMin,
+  void binMDBox(DataObjects::MDBox<MDE, nd> *box, const BoxBinning binning,
+                const size_t linearIndex, const size_t *const chunkMin,
                 const size_t *const chunkMax);
 
   /// The output MDHistoWorkspace
@@ -55,6 +55,24 @@ private:
   template <typename MDE, size_t nd>
   void integrate(typename DataObjects::MDEventWorkspace<MDE, nd>::sptr ws);
 
+  /// Sums over the sphere and the background shell of one peak
+  struct SphereSums {
+    signal_t signal = 0;
+    signal_t errorSquared = 0;
+    signal_t bgSignal = 0;
+    signal_t bgErrorSquared = 0;
+  };
+
+  /// Integrate the spheres and shells of all peaks in one pass over the boxes
+  template <typename MDE, size_t nd>
+  std::vector<SphereSums>
+  integrateSpheres(typename DataObjects::MDEventWorkspace<MDE, nd>::sptr ws,
+                   const std::vector<Mantid::Kernel::V3D> &centers,
+                   const std::vector<double> &peakRadii,
+                   const std::vector<double> &bgInnerRadii,
+                   const std::vector<double> &bgOuterRadii,
+                   const bool useOnePercentBackgroundCorrection);
+
   /// Input MDEventWorkspace
   Mantid::API::IMDEventWorkspace_sptr inWS;
 
@@ -8,6 +8,7 @@
 
 #include "MantidAPI/Algorithm.h"
 #include "MantidGeometry/Crystal/SymmetryOperationFactory.h"
+#include "MantidGeometry/IDTypes.h"
 #include "MantidMDAlgorithms/DllConfig.h"
 #include "MantidMDAlgorithms/SlicingAlgorithm.h"
 
@@ -30,6 +31,24 @@ public:
   }
 
 private:
+  /// The trajectories of the detectors of one run in the normalization
+  /// workspace, as given to calculateNormalization
+  struct Trajectories {
+    /// Matrix to convert from Q_lab to HKL
+    Kernel::DblMatrix transform;
+    /// Values of the dimensions other than Q or DeltaE
+    std::vector<coord_t> otherValues;
+    /// Lowest and highest momentum or energy transfer of each detector
+    std::vector<double> lowValues, highValues;
+    /// Polar and azimuthal angles of each detector
+    std::vector<double> theta, phi;
+    /// ID of each detector
+    std::vector<detid_t> detIDs;
+    /// Whether each detector contributes: not a monitor and not masked
+    std::vector<char> used;
+    bool operator==(const Trajectories &other) const;
+  };
+
   void init() override;
   void exec() override;
   void validateBinningForTemporaryDataWorkspace(
@@ -49,6 +68,9 @@ private:
   void calculateNormalization(const std::vector<coord_t> &otherValues,
                               const Geometry::SymmetryOperation &so,
                               uint16_t expInfoIndex, size_t soIndex);
+  void calculateNormalizationPerCharge(const Trajectories &trajectories,
+                                       std::vector<signal_t> &normalization,
+                                       API::Progress &prog);
   void calculateIntersections(std::vector<std::array<double, 4>> &intersections,
                               const double theta, const double phi,
                               const Kernel::DblMatrix &transform,
@@ -95,6 +117,12 @@ private:
   Kernel::V3D m_beamDir;
   /// ki-kf for Inelastic convention; kf-ki for Crystallography convention
   std::string convention;
+  /// Trajectories of the last normalization calculated for each symmetry
+  /// operation
+  std::vector<Trajectories> m_cachedTrajectories;
+  /// Normalization of m_cachedTrajectories for a unit proton charge, reused
+  /// by the following runs with the same trajectories
+  std::vector<std::vector<signal_t>> m_cachedNormalization;
 };
 
 } // namespace MDAlgorithms
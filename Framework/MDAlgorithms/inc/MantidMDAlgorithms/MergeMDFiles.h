@@ -65,6 +65,8 @@ private:
   DataObjects::MDBoxFlatTree m_BoxStruct;
   // the vector of box structures for contributing files components
   std::vector<DataObjects::MDBoxFlatTree> m_fileComponentsStructure;
+  // the IDs of the boxes holding events, in the order of their events on file
+  std::vector<size_t> m_mergeOrder;
 
 protected:
   /// Set to true if the output is cloned of the first one
@@ -34,6 +34,35 @@ using namespace Mantid::API;
 using namespace Mantid::Geometry;
 using namespace Mantid::DataObjects;
 
+namespace {
+/// Number of file backed boxes to load ahead of the one being binned
+constexpr size_t PREFETCH_BOXES = 32;
+
+/** Queue the next boxes whose events are binned for loading in the
+ * background
+ * @param fileIO :: the file based buffer of the workspace
+ * @param boxes :: the boxes to bin, in order
+ * @param loadEvents :: true for the boxes whose events are binned
+ * @param start :: index of the first box to consider
+ * @param stop :: index after the last box to consider
+ * @return the index after the last box considered
+ */
+size_t prefetchBoxes(Kernel::DiskBuffer *fileIO,
+                     const std::vector<API::IMDNode *> &boxes,
+                     const std::vector<bool> &loadEvents, const size_t start,
+                     const size_t stop) {
+  const size_t end = std::min(boxes.size(), stop);
+  std::vector<Kernel::ISaveable *> items;
+  items.reserve(end - start);
+  for (size_t i = start; i < end; ++i) {
+    if (loadEvents[i])
+      items.emplace_back(boxes[i]->getISaveable());
+  }
+  fileIO->prefetch(items);
+  return end;
+}
+} // namespace
+
 //----------------------------------------------------------------------------------------------
 /** Constructor
  */
@@ -71,11 +100,12 @@ void BinMD::init() {
   setPropertyGroup("IterateEvents", grp);
 
   declareProperty(
-      std::make_unique<PropertyWithValue<bool>>("Parallel", false,
+      std::make_unique<PropertyWithValue<bool>>("Parallel", true,
                                                 Direction::Input),
-      "Temporary parameter: true to run in parallel. This is ignored for "
-      "file-backed workspaces, where running in parallel makes things slower "
-      "due to disk thrashing.");
+      "Run in parallel, each thread binning a separate part of the output. "
+      "This gives the same result as running on one thread. It is ignored "
+      "for file-backed workspaces, where running in parallel makes things "
+      "slower due to disk thrashing.");
   setPropertyGroup("Parallel", grp);
 
   declareProperty(std::make_unique<WorkspaceProperty<IMDHistoWorkspace>>(
@@ -91,130 +121,148 @@ void BinMD::init() {
 }
 
 //----------------------------------------------------------------------------------------------
-/** Bin the contents of a MDBox
+/** Work out how a MDBox is binned, without looking at its events
  *
  * @param box :: pointer to the MDBox to bin
  * @param chunkMin :: the minimum index in each dimension to consider "valid"
  *(inclusive)
  * @param chunkMax :: the maximum index in each dimension to consider "valid"
  *(exclusive)
+ * @param linearIndex :: set to the bin holding the whole box, for WholeBox
+ * @return Skip if none of the events are binned, WholeBox if they are all in
+ * the same bin and Events if each event must be binned
  */
 template <typename MDE, size_t nd>
-inline void BinMD::binMDBox(MDBox<MDE, nd> *box, const size_t *const chunkMin,
-                            const size_t *const chunkMax) {
-  // An array to hold the rotated/transformed coordinates
-  auto outCenter = std::vector<coord_t>(m_outD);
-
-  // Evaluate whether the entire box is in the same bin
+BinMD::BoxBinning BinMD::classifyMDBox(MDBox<MDE, nd> *box,
+                                       const size_t *const chunkMin,
+                                       const size_t *const chunkMax,
+                                       size_t &linearIndex) const {
+  if (box->getIsMasked() || box->getNPoints() == 0)
+    return BoxBinning::Skip;
+
+  // Classify the whole box from its transformed vertexes
   if (box->getNPoints() > (1 << nd) * 2) {
     // There is a check that the number of events is enough for it to make sense
     // to do all this processing.
     size_t numVertexes = 0;
     auto vertexes = box->getVertexesArray(numVertexes);
 
-    // All vertexes have to be within THE SAME BIN = have the same linear index.
-    size_t lastLinearIndex = 0;
-    bool badOne = false;
-
+    // The transform is affine, so the events of the box are within the range
+    // of its transformed vertexes in each output dimension
+    std::vector<coord_t> outMin(m_outD, std::numeric_limits<coord_t>::max());
+    std::vector<coord_t> outMax(m_outD,
+                                std::numeric_limits<coord_t>::lowest());
+    // An array to hold the rotated/transformed coordinates
+    auto outCenter = std::vector<coord_t>(m_outD);
     for (size_t i = 0; i < numVertexes; i++) {
-      // Cache the center of the event (again for speed)
-      const coord_t *inCenter = vertexes.get() + i * nd;
-
-      // Now transform to the output dimensions
-      m_transform->apply(inCenter, outCenter.data());
-
-      // To build up the linear index
-      size_t linearIndex = 0;
-      // To mark VERTEXES outside range
-      badOne = false;
-
-      /// Loop through the dimensions on which we bin
+      m_transform->apply(vertexes.get() + i * nd, outCenter.data());
       for (size_t bd = 0; bd < m_outD; bd++) {
-        // What is the bin index in that dimension
-        coord_t x = outCenter[bd];
-        auto ix = size_t(x);
-        // Within range (for this chunk)?
-        if ((x >= 0) && (ix >= chunkMin[bd]) && (ix < chunkMax[bd])) {
-          // Build up the linear index
-          linearIndex += indexMultiplier[bd] * ix;
-        } else {
-          // Outside the range
-          badOne = true;
-          break;
-        }
-      } // (for each dim in MDHisto)
-
-      // Is the vertex at the same place as the last one?
-      if (!badOne) {
-        if ((i > 0) && (linearIndex != lastLinearIndex)) {
-          // Change of index
-          badOne = true;
-          break;
-        }
-        lastLinearIndex = linearIndex;
+        outMin[bd] = std::min(outMin[bd], outCenter[bd]);
+        outMax[bd] = std::max(outMax[bd], outCenter[bd]);
       }
+    }
 
-      // Was the vertex completely outside the range?
-      if (badOne)
-        break;
-    } // (for each vertex)
-
-    if (!badOne) {
-      // Yes, the entire box is within a single bin
-      //        std::cout << "Box at " << box->getExtentsStr() << " is within a
-      //        single bin.\n";
-      // Add the CACHED signal from the entire box
-      signals[lastLinearIndex] += box->getSignal();
-      errors[lastLinearIndex] += box->getErrorSquared();
-      // TODO: If DataObjects get a weight, this would need to get the summed
-      // weight.
-      numEvents[lastLinearIndex] += static_cast<signal_t>(box->getNPoints());
-
-      // And don't bother looking at each event. This may save lots of time
-      // loading from disk.
-      return;
+    linearIndex = 0;
+    bool singleBin = true;
+    for (size_t bd = 0; bd < m_outD; bd++) {
+      // Entirely outside of this chunk: none of the events are binned, so
+      // they are not even loaded
+      if (outMax[bd] < 0 || outMax[bd] < static_cast<coord_t>(chunkMin[bd]) ||
+          outMin[bd] >= static_cast<coord_t>(chunkMax[bd]))
+        return BoxBinning::Skip;
+      const auto ix = size_t(outMin[bd]);
+      if (outMin[bd] < 0 || ix < chunkMin[bd] || size_t(outMax[bd]) != ix)
+        singleBin = false;
+      else
+        linearIndex += indexMultiplier[bd] * ix;
     }
+    if (singleBin)
+      return BoxBinning::WholeBox;
+  }
+  return BoxBinning::Events;
+}
+
+//----------------------------------------------------------------------------------------------
+/** Bin the contents of a MDBox
+ *
+ * @param box :: pointer to the MDBox to bin
+ * @param binning :: how the box is binned, from classifyMDBox
+ * @param linearIndex :: the bin holding the whole box, for WholeBox
+ * @param chunkMin :: the minimum index in each dimension to consider "valid"
+ *(inclusive)
+ * @param chunkMax :: the maximum index in each dimension to consider "valid"
+ *(exclusive)
+ */
+template <typename MDE, size_t nd>
+inline void BinMD::binMDBox(MDBox<MDE, nd> *box, const BoxBinning binning,
+                            const size_t linearIndex,
+                            const size_t *const chunkMin,
+                            const size_t *const chunkMax) {
+  if (binning == BoxBinning::Skip)
+    return;
+  if (binning == BoxBinning::WholeBox) {
+    // Yes, the entire box is within a single bin
+    // Add the CACHED signal from the entire box
+    signals[linearIndex] += box->getSignal();
+    errors[linearIndex] += box->getErrorSquared();
+    // TODO: If DataObjects get a weight, this would need to get the summed
+    // weight.
+    numEvents[linearIndex] += static_cast<signal_t>(box->getNPoints());
+
+    // And don't bother looking at each event. This may save lots of time
+    // loading from disk.
+    return;
   }
 
   // If you get here, you could not determine that the entire box was in the
   // same bin.
-  // So you need to iterate through events.
+  // So you need to iterate through events. They are transformed in batches,
+  // which the transforms can vectorise.
+  constexpr size_t batchSize = 256;
+  std::vector<coord_t> inCenters(batchSize * nd);
+  std::vector<coord_t> outCoords(batchSize * m_outD);
+  std::vector<size_t> linearIndexes(batchSize);
+  std::vector<char> badOnes(batchSize);
+
   const std::vector<MDE> &events = box->getConstEvents();
-  for (auto it = events.begin(); it != events.end(); ++it) {
-    // Cache the center of the event (again for speed)
-    const coord_t *inCenter = it->getCenter();
+  for (size_t start = 0; start < events.size(); start += batchSize) {
+    const size_t numInBatch = std::min(batchSize, events.size() - start);
+    for (size_t k = 0; k < numInBatch; ++k) {
+      const coord_t *inCenter = events[start + k].getCenter();
+      std::copy(inCenter, inCenter + nd, inCenters.begin() + k * nd);
+    }
 
     // Now transform to the output dimensions
-    m_transform->apply(inCenter, outCenter.data());
-
-    // To build up the linear index
-    size_t linearIndex = 0;
-    // To mark events outside range
-    bool badOne = false;
+    m_transform->applyBatch(inCenters.data(), outCoords.data(), numInBatch);
 
+    // Build up the linear indexes, marking the events outside the range
+    std::fill(linearIndexes.begin(), linearIndexes.end(), 0);
+    std::fill(badOnes.begin(), badOnes.end(), 0);
     /// Loop through the dimensions on which we bin
     for (size_t bd = 0; bd < m_outD; bd++) {
-      // What is the bin index in that dimension
-      coord_t x = outCenter[bd];
-      auto ix = size_t(x);
-      // Within range (for this chunk)?
-      if ((x >= 0) && (ix >= chunkMin[bd]) && (ix < chunkMax[bd])) {
-        // Build up the linear index
-        linearIndex += indexMultiplier[bd] * ix;
-      } else {
-        // Outside the range
-        badOne = true;
-        break;
+      for (size_t k = 0; k < numInBatch; ++k) {
+        // What is the bin index in that dimension
+        const coord_t x = outCoords[k * m_outD + bd];
+        const auto ix = size_t(x);
+        // Within range (for this chunk)?
+        if ((x >= 0) && (ix >= chunkMin[bd]) && (ix < chunkMax[bd]))
+          linearIndexes[k] += indexMultiplier[bd] * ix;
+        else
+          badOnes[k] = 1;
       }
     } // (for each dim in MDHisto)
 
-    if (!badOne) {
+    for (size_t k = 0; k < numInBatch; ++k) {
+      if (badOnes[k])
+        continue;
+      const MDE &event = events[start + k];
       // Sum the signals as doubles to preserve precision
-      signals[linearIndex] += static_cast<signal_t>(it->getSignal());
-      errors[linearIndex] += static_cast<signal_t>(it->getErrorSquared());
+      signals[linearIndexes[k]] += static_cast<signal_t>(event.getSignal());
+      errors[linearIndexes[k]] +=
+          static_cast<signal_t>(event.getErrorSquared());
       // TODO: If DataObjects get a weight, this would need to get the summed
       // weight.
-      numEvents[linearIndex] += 1.0;
+      numEvents[linearIndexes[k]] += 1.0;
     }
   }
   // Done with the events list
@@ -254,14 +302,19 @@ void BinMD::binByIterating(typename MDEventWorkspace<MDE, nd>::sptr ws) {
   }
 
   // The dimension (in the output workspace) along which we chunk for parallel
-  // processing
-  // TODO: Find the smartest dimension to chunk against
+  // processing: the one with the most bins, to get the most chunks
   size_t chunkDimension = 0;
+  for (size_t bd = 1; bd < m_outD; bd++) {
+    if (m_binDimensions[bd]->getNBins() >
+        m_binDimensions[chunkDimension]->getNBins())
+      chunkDimension = bd;
+  }
 
   // How many bins (in that dimension) per chunk.
-  // Try to split it so each core will get 2 tasks:
+  // Try to split it so each core will get 4 tasks; the chunks are handed out
+  // dynamically so that cores finishing early take on the remaining ones:
   auto chunkNumBins = int(m_binDimensions[chunkDimension]->getNBins() /
-                          (PARALLEL_GET_MAX_THREADS * 2));
+                          (PARALLEL_GET_MAX_THREADS * 4));
   if (chunkNumBins < 1)
     chunkNumBins = 1;
 
@@ -329,12 +382,31 @@ void BinMD::binByIterating(typename MDEventWorkspace<MDE, nd>::sptr ws) {
         }
       }
 
+      // Work out how each box is binned first, so that only the boxes whose
+      // events are binned one by one are read from file
+      std::vector<BoxBinning> binnings(boxes.size(), BoxBinning::Skip);
+      std::vector<size_t> linearIndexes(boxes.size(), 0);
+      std::vector<bool> loadEvents(boxes.size(), false);
+      for (size_t i = 0; i < boxes.size(); ++i) {
+        auto *box = dynamic_cast<MDBox<MDE, nd> *>(boxes[i]);
+        if (box)
+          binnings[i] = this->classifyMDBox(box, chunkMin.data(),
+                                            chunkMax.data(), linearIndexes[i]);
+        loadEvents[i] = binnings[i] == BoxBinning::Events;
+      }
+
       // Go through every box for this chunk.
-      for (auto &boxe : boxes) {
-        auto *box = dynamic_cast<MDBox<MDE, nd> *>(boxe);
+      size_t prefetchedTo(0);
+      for (size_t i = 0; i < boxes.size(); ++i) {
+        // Keep the reading of file backed boxes ahead of the binning
+        if (bc->isFileBacked() && prefetchedTo <= i + PREFETCH_BOXES)
+          prefetchedTo = prefetchBoxes(bc->getFileIO(), boxes, loadEvents,
+                                       std::max(i, prefetchedTo),
+                                       i + 2 * PREFETCH_BOXES);
         // Perform the binning in this separate method.
-        if (box && !box->getIsMasked())
-          this->binMDBox(box, chunkMin.data(), chunkMax.data());
+        if (binnings[i] != BoxBinning::Skip)
+          this->binMDBox(static_cast<MDBox<MDE, nd> *>(boxes[i]), binnings[i],
+                         linearIndexes[i], chunkMin.data(), chunkMax.data());
 
         // Progress reporting
         if (prog)
@@ -8,19 +8,17 @@
 #include "MantidKernel/ArrayProperty.h"
 #include "MantidKernel/MultiThreaded.h"
 
-#include "MantidAPI/FrameworkManager.h"
 #include "MantidAPI/IMDHistoWorkspace.h"
-#include "MantidAPI/IMDIterator.h"
 #include "MantidAPI/Progress.h"
 
 #include "MantidDataObjects/MDHistoWorkspace.h"
-#include "MantidDataObjects/MDHistoWorkspaceIterator.h"
-#include "MantidGeometry/MDGeometry/MDBoxImplicitFunction.h"
 #include "MantidGeometry/MDGeometry/MDHistoDimension.h"
 
 #include <algorithm>
 #include <cmath>
+#include <functional>
 #include <map>
+#include <numeric>
 #include <utility>
 
 #include <memory>
@@ -177,6 +175,142 @@ void setMinMaxBins(Mantid::coord_t &pMin, Mantid::coord_t &pMax,
   numberOfBins =
       std::lround((pMax - pMin) / width); // round up to a whole number of bins.
 }
+
+/// The input bins overlapping one output bin along a dimension, each with the
+/// fraction of the input bin inside of the output bin
+using BinWeights = std::vector<std::pair<size_t, double>>;
+
+/**
+ * Find the fraction of each input bin inside of each output bin along one
+ * dimension. As in MDBoxImplicitFunction::fraction, bins only touching the
+ * output bin are left out.
+ * @param inDim : dimension of the input workspace
+ * @param outDim : matching dimension of the output workspace
+ * @return the input bins overlapping each output bin
+ */
+std::vector<BinWeights> overlapWeights(const IMDDimension &inDim,
+                                       const IMDDimension &outDim) {
+  const Mantid::coord_t inOrigin = inDim.getMinimum();
+  const Mantid::coord_t inWidth = inDim.getBinWidth();
+  const auto nIn = static_cast<double>(inDim.getNBins());
+  const Mantid::coord_t outOrigin = outDim.getMinimum();
+  const Mantid::coord_t outWidth = outDim.getBinWidth();
+  const Mantid::coord_t delta = outWidth / 2;
+
+  std::vector<BinWeights> weights(outDim.getNBins());
+  for (size_t out = 0; out < weights.size(); ++out) {
+    const Mantid::coord_t center =
+        outOrigin + (Mantid::coord_t(out) + 0.5f) * outWidth;
+    const Mantid::coord_t outMin = center - delta;
+    const Mantid::coord_t outMax = center + delta;
+    // Input bins that could overlap, with one to spare on each side
+    const double first = std::floor((outMin - inOrigin) / inWidth) - 1.;
+    const double last = std::ceil((outMax - inOrigin) / inWidth) + 1.;
+    const auto begin = static_cast<size_t>(std::min(nIn, std::max(0., first)));
+    const auto end = static_cast<size_t>(std::min(nIn, std::max(0., last)));
+    for (size_t in = begin; in < end; ++in) {
+      const Mantid::coord_t min = inOrigin + Mantid::coord_t(in) * inWidth;
+      const Mantid::coord_t max = min + inWidth;
+      if (max < outMin || min > outMax)
+        continue;
+      const Mantid::coord_t fraction =
+          (std::min(outMax, max) - std::max(outMin, min)) / (max - min);
+      if (fraction != 0)
+        weights[out].emplace_back(in, fraction);
+    }
+  }
+  return weights;
+}
+
+/**
+ * Check for output bins that are the input bins
+ * @param weights : input bins overlapping each output bin
+ * @param nIn : number of input bins
+ * @return true if each output bin is all of the matching input bin
+ */
+bool identityWeights(const std::vector<BinWeights> &weights,
+                     const size_t nIn) {
+  if (weights.size() != nIn)
+    return false;
+  for (size_t i = 0; i < nIn; ++i) {
+    if (weights[i].size() != 1 || weights[i][0].first != i ||
+        weights[i][0].second != 1.)
+      return false;
+  }
+  return true;
+}
+
+/// Signal, error squared and number of events of each bin
+struct BinArrays {
+  const Mantid::signal_t *signal;
+  const Mantid::signal_t *errorSquared;
+  const Mantid::signal_t *numEvents;
+};
+
+/// Writable signal, error squared and number of events of each bin
+struct MutableBinArrays {
+  Mantid::signal_t *signal;
+  Mantid::signal_t *errorSquared;
+  Mantid::signal_t *numEvents;
+};
+
+/// Storage for the bins of a partly integrated workspace
+struct BinBuffers {
+  explicit BinBuffers(size_t size)
+      : signal(size), errorSquared(size), numEvents(size) {}
+  BinArrays arrays() const {
+    return {signal.data(), errorSquared.data(), numEvents.data()};
+  }
+  MutableBinArrays mutableArrays() {
+    return {signal.data(), errorSquared.data(), numEvents.data()};
+  }
+  std::vector<Mantid::signal_t> signal;
+  std::vector<Mantid::signal_t> errorSquared;
+  std::vector<Mantid::signal_t> numEvents;
+};
+
+/**
+ * Integrate the bins along one dimension. The bins are laid out as
+ * (inner, dimension, outer) with the inner index running fastest, so the
+ * innermost loop runs over contiguous bins. Each output line is filled by one
+ * thread.
+ * @param weights : input bins overlapping each output bin
+ * @param nIn : number of input bins along the dimension
+ * @param inner : number of bins of the dimensions before this one
+ * @param outer : number of bins of the dimensions after this one
+ * @param source : bins to integrate
+ * @param masks : masked source bins, which do not contribute, or null
+ * @param target : output bins, overwritten
+ */
+void integrateDimension(const std::vector<BinWeights> &weights,
+                        const size_t nIn, const size_t inner,
+                        const size_t outer, const BinArrays &source,
+                        const bool *masks, const MutableBinArrays &target) {
+  const size_t nOut = weights.size();
+  const auto nLines = static_cast<int64_t>(outer * nOut);
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int64_t line = 0; line < nLines; ++line) {
+    const auto block = static_cast<size_t>(line) / nOut;
+    const auto out = static_cast<size_t>(line) % nOut;
+    Mantid::signal_t *signal = target.signal + line * inner;
+    Mantid::signal_t *errorSquared = target.errorSquared + line * inner;
+    Mantid::signal_t *numEvents = target.numEvents + line * inner;
+    std::fill_n(signal, inner, 0.);
+    std::fill_n(errorSquared, inner, 0.);
+    std::fill_n(numEvents, inner, 0.);
+    for (const auto &weight : weights[out]) {
+      const size_t start = (block * nIn + weight.first) * inner;
+      const double fraction = weight.second;
+      for (size_t i = 0; i < inner; ++i) {
+        if (masks && masks[start + i])
+          continue;
+        signal[i] += fraction * source.signal[start + i];
+        errorSquared[i] += fraction * source.errorSquared[start + i];
+        numEvents[i] += fraction * source.numEvents[start + i];
+      }
+    }
+  }
+}
 } // namespace
 
 /**
@@ -221,29 +355,6 @@ MDHistoWorkspace_sptr createShapedOutput(IMDHistoWorkspace const *const inWS,
   return std::make_shared<MDHistoWorkspace>(dimensions);
 }
 
-/**
- * Perform a weighted sum at the iterator position. This function does not
- * increment the iterator. Masked bins do not contribute.
- * @param iterator : Iterator to use in sum
- * @param box : Box implicit function defining valid region.
- * @param sumSignal : Accumlation in/out ref.
- * @param sumSQErrors : Accumulation error in/out ref. Squared value.
- * @param sumNEvents : Accumulation n_event in/out ref.
- */
-void performWeightedSum(MDHistoWorkspaceIterator const *const iterator,
-                        MDBoxImplicitFunction &box, double &sumSignal,
-                        double &sumSQErrors, double &sumNEvents) {
-  if (!iterator->getIsMasked()) {
-    const double weight = box.fraction(iterator->getBoxExtents());
-    if (weight != 0) {
-      sumSignal += weight * iterator->getSignal();
-      const double error = iterator->getError();
-      sumSQErrors += weight * (error * error);
-      sumNEvents += weight * double(iterator->getNumEventsFraction());
-    }
-  }
-}
-
 namespace Mantid {
 namespace MDAlgorithms {
 
@@ -331,107 +442,66 @@ void IntegrateMDHistoWorkspace::exec() {
      */
     MDHistoWorkspace_sptr outWS = createShapedOutput(inWS.get(), pbins, g_log);
 
-    Progress progress(this, 0.0, 1.0, size_t(outWS->getNPoints()));
+    auto histoWS = std::dynamic_pointer_cast<MDHistoWorkspace>(inWS);
+    if (!histoWS) {
+      throw std::runtime_error(
+          "Could not convert IMDHistoWorkspace to a MDHistoWorkspace");
+    }
 
-    // Store in each dimension
-    std::vector<Mantid::coord_t> binWidthsOut(nDims);
-    std::vector<int> widthVector(nDims); // used for nearest neighbour search
+    /* The fraction of an input bin inside of an output bin is the product of
+       the fractions along each dimension, so the integration is done one
+       dimension at a time. Dimensions whose binning does not change are
+       skipped, and those reducing the number of bins the most are done
+       first to keep the intermediate workspaces small.
+     */
+    std::vector<std::vector<BinWeights>> weights(nDims);
+    std::vector<size_t> order;
     for (size_t i = 0; i < nDims; ++i) {
-      binWidthsOut[i] = outWS->getDimension(i)->getBinWidth();
-
-      // Maximum width vector for region in output workspace corresponding to
-      // region in input workspace.
-
-      /* ceil(wout/win) = n_pixels in input corresponding to 1 pixel in output.
-         The width vector is the total width. So we always need to double it to
-         take account of the whole region.
-         For example, 8/4 = 2, but thats only 1 pixel on each side of the
-         center, we need 2 * that to give the correct answer of 4.
-      */
-      widthVector[i] =
-          2 * static_cast<int>(std::ceil(binWidthsOut[i] /
-                                         inWS->getDimension(i)->getBinWidth()));
-
-      if (widthVector[i] % 2 == 0) {
-        widthVector[i] += 1; // make it odd if not already.
-      }
+      weights[i] = overlapWeights(*inWS->getDimension(i),
+                                  *outWS->getDimension(i));
+      if (!identityWeights(weights[i], inWS->getDimension(i)->getNBins()))
+        order.emplace_back(i);
     }
-
-    // Outer loop over the output workspace iterator poistions.
-    const int nThreads = Mantid::API::FrameworkManager::Instance()
-                             .getNumOMPThreads(); // NThreads to Request
-
-    auto outIterators = outWS->createIterators(nThreads, nullptr);
-
-    PARALLEL_FOR_NO_WSP_CHECK()
-    for (int i = 0; i < int(outIterators.size()); ++i) { // NOLINT
-      PARALLEL_START_INTERUPT_REGION
-      auto outIterator =
-          dynamic_cast<MDHistoWorkspaceIterator *>(outIterators[i].get());
-      if (!outIterator) {
-        throw std::logic_error(
-            "Failed to cast iterator to MDHistoWorkspaceIterator");
+    if (order.empty())
+      order.emplace_back(0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      return weights[a].size() * inWS->getDimension(b)->getNBins() <
+             weights[b].size() * inWS->getDimension(a)->getNBins();
+    });
+
+    Progress progress(this, 0.0, 1.0, order.size());
+    std::vector<size_t> shape(nDims);
+    for (size_t i = 0; i < nDims; ++i)
+      shape[i] = inWS->getDimension(i)->getNBins();
+    BinArrays source{inWS->getSignalArray(), inWS->getErrorSquaredArray(),
+                     inWS->getNumEventsArray()};
+    std::unique_ptr<BinBuffers> current;
+    for (size_t step = 0; step < order.size(); ++step) {
+      const size_t dim = order[step];
+      const size_t nIn = shape[dim];
+      shape[dim] = weights[dim].size();
+      const size_t inner = std::accumulate(shape.begin(), shape.begin() + dim,
+                                           size_t(1), std::multiplies<>());
+      const size_t outer = std::accumulate(shape.begin() + dim + 1,
+                                           shape.end(), size_t(1),
+                                           std::multiplies<>());
+      std::unique_ptr<BinBuffers> next;
+      MutableBinArrays target{outWS->mutableSignalArray(),
+                              outWS->mutableErrorSquaredArray(),
+                              outWS->mutableNumEventsArray()};
+      if (step + 1 < order.size()) {
+        next = std::make_unique<BinBuffers>(inner * shape[dim] * outer);
+        target = next->mutableArrays();
       }
-
-      do {
-
-        Mantid::Kernel::VMD outIteratorCenter = outIterator->getCenter();
-
-        // Calculate the extents for this out iterator position.
-        std::vector<Mantid::coord_t> mins(nDims);
-        std::vector<Mantid::coord_t> maxs(nDims);
-        for (size_t j = 0; j < nDims; ++j) {
-          const coord_t delta = binWidthsOut[j] / 2;
-          mins[j] = outIteratorCenter[j] - delta;
-          maxs[j] = outIteratorCenter[j] + delta;
-        }
-        MDBoxImplicitFunction box(mins, maxs);
-
-        double sumSignal = 0;
-        double sumSQErrors = 0;
-        double sumNEvents = 0;
-
-        // Create a thread-local input iterator.
-
-        auto iterator = inWS->createIterator();
-        auto inIterator =
-            dynamic_cast<MDHistoWorkspaceIterator *>(iterator.get());
-        if (!inIterator) {
-          throw std::runtime_error(
-              "Could not convert IMDIterator to a MDHistoWorkspaceIterator");
-        }
-
-        /*
-        We jump to the iterator position which is closest in the model
-        coordinates
-        to the centre of our output iterator. This allows us to consider a much
-        smaller region of space as part of our inner loop
-        rather than iterating over the full set of boxes of the input workspace.
-        */
-        inIterator->jumpToNearest(outIteratorCenter);
-        performWeightedSum(inIterator, box, sumSignal, sumSQErrors,
-                           sumNEvents); // Use the present position. neighbours
-                                        // below exclude the current position.
-        // Look at all of the neighbours of our position. We previously
-        // calculated what the width vector would need to be.
-        auto neighbourIndexes =
-            inIterator->findNeighbourIndexesByWidth(widthVector);
-        for (auto neighbourIndex : neighbourIndexes) {
-          inIterator->jumpTo(neighbourIndex); // Go to that neighbour
-          performWeightedSum(inIterator, box, sumSignal, sumSQErrors,
-                             sumNEvents);
-        }
-
-        const size_t iteratorIndex = outIterator->getLinearIndex();
-        outWS->setSignalAt(iteratorIndex, sumSignal);
-        outWS->setErrorSquaredAt(iteratorIndex, sumSQErrors);
-        outWS->setNumEventsAt(iteratorIndex, sumNEvents);
-
-        progress.report();
-      } while (outIterator->next());
-      PARALLEL_END_INTERUPT_REGION
+      // Masked bins do not contribute
+      const bool *masks = step == 0 ? histoWS->getMaskArray() : nullptr;
+      integrateDimension(weights[dim], nIn, inner, outer, source, masks,
+                         target);
+      current = std::move(next);
+      if (current)
+        source = current->arrays();
+      progress.report();
     }
-    PARALLEL_CHECK_INTERUPT_REGION
     outWS->setDisplayNormalization(inWS->displayNormalizationHisto());
     this->setProperty("OutputWorkspace", outWS);
   }
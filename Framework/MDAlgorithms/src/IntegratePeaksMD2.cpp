@@ -29,14 +29,18 @@
 #include "MantidGeometry/Instrument/DetectorInfo.h"
 #include "MantidHistogramData/LinearGenerator.h"
 #include "MantidKernel/ListValidator.h"
+#include "MantidKernel/MultiThreaded.h"
 #include "MantidKernel/System.h"
 #include "MantidKernel/Utils.h"
 #include "MantidMDAlgorithms/GSLFunctions.h"
 #include "MantidMDAlgorithms/MDBoxMaskFunction.h"
 
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <gsl/gsl_integration.h>
+#include <limits>
+#include <tuple>
 
 namespace Mantid {
 namespace MDAlgorithms {
@@ -51,6 +55,137 @@ using namespace Mantid::DataObjects;
 using namespace Mantid::DataObjects;
 using namespace Mantid::Geometry;
 
+namespace {
+/** Uniform grid of cells over the integration regions of the peaks. Each cell
+ * lists the peaks whose region overlaps it, so that the peaks near a box are
+ * found without looking at every peak.
+ */
+class PeakRegionGrid {
+public:
+  /**
+   * @param centers :: centre of each peak
+   * @param reach :: radius of the region of each peak, peaks with a radius of
+   * zero or less are left out
+   */
+  PeakRegionGrid(const std::vector<V3D> &centers,
+                 const std::vector<double> &reach)
+      : m_centers(centers), m_reach(reach), m_cellSize(0.) {
+    double max[3];
+    for (size_t d = 0; d < 3; ++d) {
+      m_min[d] = std::numeric_limits<double>::max();
+      max[d] = std::numeric_limits<double>::lowest();
+      m_numCells[d] = 0;
+    }
+    size_t numRegions = 0;
+    for (size_t i = 0; i < centers.size(); ++i) {
+      if (reach[i] <= 0.)
+        continue;
+      ++numRegions;
+      m_cellSize = std::max(m_cellSize, reach[i]);
+      for (size_t d = 0; d < 3; ++d) {
+        m_min[d] = std::min(m_min[d], centers[i][d] - reach[i]);
+        max[d] = std::max(max[d], centers[i][d] + reach[i]);
+      }
+    }
+    if (numRegions == 0)
+      return;
+    // Cells as wide as the largest region, but no more than a few per region
+    const auto maxCells = static_cast<double>(8 * numRegions);
+    while (true) {
+      double numCells = 1.;
+      for (size_t d = 0; d < 3; ++d)
+        numCells *= std::floor((max[d] - m_min[d]) / m_cellSize) + 1.;
+      if (numCells <= maxCells)
+        break;
+      m_cellSize *= 2.;
+    }
+    for (size_t d = 0; d < 3; ++d)
+      m_numCells[d] =
+          static_cast<size_t>((max[d] - m_min[d]) / m_cellSize) + 1;
+    m_cells.resize(m_numCells[0] * m_numCells[1] * m_numCells[2]);
+    for (size_t i = 0; i < centers.size(); ++i) {
+      if (reach[i] <= 0.)
+        continue;
+      size_t low[3], high[3];
+      for (size_t d = 0; d < 3; ++d) {
+        low[d] = cell(d, centers[i][d] - reach[i]);
+        high[d] = cell(d, centers[i][d] + reach[i]);
+      }
+      forEachCell(low, high, [this, i](size_t index) {
+        m_cells[index].emplace_back(i);
+      });
+    }
+  }
+
+  /** Find the peaks whose region overlaps a box
+   * @param min :: lower corner of the box
+   * @param max :: upper corner of the box
+   * @param peaks :: filled with the indices of the peaks, in increasing order
+   */
+  void findPeaks(const double *min, const double *max,
+                 std::vector<size_t> &peaks) const {
+    peaks.clear();
+    if (m_cells.empty())
+      return;
+    size_t low[3], high[3];
+    for (size_t d = 0; d < 3; ++d) {
+      low[d] = cell(d, min[d]);
+      high[d] = cell(d, max[d]);
+    }
+    forEachCell(low, high, [this, &peaks](size_t index) {
+      peaks.insert(peaks.end(), m_cells[index].begin(), m_cells[index].end());
+    });
+    std::sort(peaks.begin(), peaks.end());
+    peaks.erase(std::unique(peaks.begin(), peaks.end()), peaks.end());
+    peaks.erase(std::remove_if(peaks.begin(), peaks.end(),
+                               [this, min, max](size_t peak) {
+                                 return !reaches(peak, min, max);
+                               }),
+                peaks.end());
+  }
+
+private:
+  /// Whether the region of a peak reaches into a box, allowing for the
+  /// rounding of the event coordinates
+  bool reaches(size_t peak, const double *min, const double *max) const {
+    double distanceSquared = 0.;
+    for (size_t d = 0; d < 3; ++d) {
+      const double x = m_centers[peak][d];
+      const double dist = x - std::max(min[d], std::min(x, max[d]));
+      distanceSquared += dist * dist;
+    }
+    const double reach = m_reach[peak] * (1. + 1e-5);
+    return distanceSquared <= reach * reach;
+  }
+
+  /// Index of the cell holding a coordinate along one dimension
+  size_t cell(size_t d, double x) const {
+    if (x <= m_min[d])
+      return 0;
+    return std::min(static_cast<size_t>((x - m_min[d]) / m_cellSize),
+                    m_numCells[d] - 1);
+  }
+
+  /// Call a function with the linear index of every cell in a range
+  template <typename Function>
+  void forEachCell(const size_t *low, const size_t *high,
+                   Function &&function) const {
+    for (size_t z = low[2]; z <= high[2]; ++z)
+      for (size_t y = low[1]; y <= high[1]; ++y)
+        for (size_t x = low[0]; x <= high[0]; ++x)
+          function(x + m_numCells[0] * (y + m_numCells[1] * z));
+  }
+
+  const std::vector<V3D> &m_centers;
+  const std::vector<double> &m_reach;
+  double m_min[3];
+  double m_cellSize;
+  size_t m_numCells[3];
+  /// Indices of the peaks overlapping each cell
+  std::vector<std::vector<size_t>> m_cells;
+};
+} // namespace
+
 /** Initialize the algorithm's properties.
  */
 void IntegratePeaksMD2::init() {
@@ -160,6 +295,15 @@ void IntegratePeaksMD2::init() {
                   "If this options is enabled, then the the top 1% of the "
                   "background will be removed"
                   "before the background subtraction.");
+
+  declareProperty(
+      "IntegrateInBatch", false,
+      "If true, the spheres and background shells of all of the peaks are "
+      "integrated together in one pass over the boxes of the workspace, "
+      "which is much faster for many peaks. With "
+      "UseOnePercentBackgroundCorrection, the top 1% of the events of each "
+      "whole background shell is removed, as without batching. Not used for "
+      "Ellipsoid or Cylinder.");
 }
 
 //----------------------------------------------------------------------------------------------
@@ -215,6 +359,8 @@ void IntegratePeaksMD2::integrate(typename MDEventWorkspace<MDE, nd>::sptr ws) {
   Workspace2D_sptr wsProfile2D, wsFit2D, wsDiff2D;
   size_t numSteps = 0;
   bool cylinderBool = getProperty("Cylinder");
+  const bool integrateInBatch =
+      getProperty("IntegrateInBatch") && !cylinderBool && !isEllipse;
   bool adaptiveQBackground = getProperty("AdaptiveQBackground");
   double adaptiveQMultiplier = getProperty("AdaptiveQMultiplier");
   double adaptiveQBackgroundMultiplier = 0.0;
@@ -307,7 +453,60 @@ void IntegratePeaksMD2::integrate(typename MDEventWorkspace<MDE, nd>::sptr ws) {
   // PRAGMA_OMP(parallel for schedule(dynamic, 10) )
   // Initialize progress reporting
   int nPeaks = peakWS->getNumberPeaks();
-  Progress progress(this, 0., 1., nPeaks);
+
+  // Get the peak center as a position in the dimensions of the workspace
+  auto peakPosition = [CoordinatesToUse](const IPeak &p) {
+    V3D pos;
+    if (CoordinatesToUse == Mantid::Kernel::QLab) //"Q (lab frame)"
+      pos = p.getQLabFrame();
+    else if (CoordinatesToUse == Mantid::Kernel::QSample) //"Q (sample frame)"
+      pos = p.getQSampleFrame();
+    else if (CoordinatesToUse == Mantid::Kernel::HKL) //"HKL"
+      pos = p.getHKL();
+    return pos;
+  };
+  // modulus of Q, only needed for the adaptive radius
+  auto peakLengthQ = [adaptiveQMultiplier](const V3D &pos) {
+    coord_t lenQpeak = 0.0;
+    if (adaptiveQMultiplier != 0.0) {
+      for (size_t d = 0; d < nd; ++d) {
+        const auto center = static_cast<coord_t>(pos[d]);
+        lenQpeak += center * center;
+      }
+      lenQpeak = std::sqrt(lenQpeak);
+    }
+    return lenQpeak;
+  };
+
+  // In batch mode, the spheres of all the peaks are integrated first. Peaks
+  // with a negative radius get empty spheres, they are not integrated below.
+  std::vector<SphereSums> batchSums;
+  if (integrateInBatch) {
+    std::vector<V3D> centers(nPeaks);
+    std::vector<double> peakRadii(nPeaks, 0.0);
+    std::vector<double> bgInnerRadii(nPeaks, 0.0);
+    std::vector<double> bgOuterRadii(nPeaks, 0.0);
+    for (int i = 0; i < nPeaks; ++i) {
+      centers[i] = peakPosition(peakWS->getPeak(i));
+      const coord_t lenQpeak = peakLengthQ(centers[i]);
+      const double adaptiveRadius =
+          adaptiveQMultiplier * lenQpeak + PeakRadius;
+      if (adaptiveRadius <= 0.0)
+        continue;
+      peakRadii[i] = adaptiveRadius;
+      if (BackgroundOuterRadius > PeakRadius) {
+        bgInnerRadii[i] =
+            adaptiveQBackgroundMultiplier * lenQpeak + BackgroundInnerRadius;
+        bgOuterRadii[i] =
+            adaptiveQBackgroundMultiplier * lenQpeak + BackgroundOuterRadius;
+      }
+    }
+    batchSums = integrateSpheres<MDE, nd>(ws, centers, peakRadii, bgInnerRadii,
+                                          bgOuterRadii,
+                                          useOnePercentBackgroundCorrection);
+  }
+
+  Progress progress(this, integrateInBatch ? 0.5 : 0., 1., nPeaks);
   for (int i = 0; i < nPeaks; ++i) {
     if (this->getCancel())
       break; // User cancellation
@@ -317,13 +516,7 @@ void IntegratePeaksMD2::integrate(typename MDEventWorkspace<MDE, nd>::sptr ws) {
     IPeak &p = peakWS->getPeak(i);
 
     // Get the peak center as a position in the dimensions of the workspace
-    V3D pos;
-    if (CoordinatesToUse == Mantid::Kernel::QLab) //"Q (lab frame)"
-      pos = p.getQLabFrame();
-    else if (CoordinatesToUse == Mantid::Kernel::QSample) //"Q (sample frame)"
-      pos = p.getQSampleFrame();
-    else if (CoordinatesToUse == Mantid::Kernel::HKL) //"HKL"
-      pos = p.getHKL();
+    const V3D pos = peakPosition(p);
 
     // Do not integrate if sphere is off edge of detector
 
@@ -356,14 +549,7 @@ void IntegratePeaksMD2::integrate(typename MDEventWorkspace<MDE, nd>::sptr ws) {
     double background_total = 0.0;
     if (!cylinderBool) {
       // modulus of Q
-      coord_t lenQpeak = 0.0;
-      if (adaptiveQMultiplier != 0.0) {
-        lenQpeak = 0.0;
-        for (size_t d = 0; d < nd; ++d) {
-          lenQpeak += center[d] * center[d];
-        }
-        lenQpeak = std::sqrt(lenQpeak);
-      }
+      const coord_t lenQpeak = peakLengthQ(pos);
       double adaptiveRadius = adaptiveQMultiplier * lenQpeak + PeakRadius;
       if (adaptiveRadius <= 0.0) {
         g_log.error() << "Error: Radius for integration sphere of peak " << i
@@ -397,12 +583,17 @@ void IntegratePeaksMD2::integrate(typename MDEventWorkspace<MDE, nd>::sptr ws) {
       // Integrate spherical background shell if specified
       if (BackgroundOuterRadius > PeakRadius) {
         // Get the total signal inside background shell
-        ws->getBox()->integrateSphere(
-            getRadiusSq,
-            static_cast<coord_t>(pow(BackgroundOuterRadiusVector[i], 2)),
-            bgSignal, bgErrorSquared,
-            static_cast<coord_t>(pow(BackgroundInnerRadiusVector[i], 2)),
-            useOnePercentBackgroundCorrection);
+        if (integrateInBatch) {
+          bgSignal = batchSums[i].bgSignal;
+          bgErrorSquared = batchSums[i].bgErrorSquared;
+        } else {
+          ws->getBox()->integrateSphere(
+              getRadiusSq,
+              static_cast<coord_t>(pow(BackgroundOuterRadiusVector[i], 2)),
+              bgSignal, bgErrorSquared,
+              static_cast<coord_t>(pow(BackgroundInnerRadiusVector[i], 2)),
+              useOnePercentBackgroundCorrection);
+        }
         // correct bg signal by Vpeak/Vshell (same for sphere and ellipse)
         bgSignal *= scaleFactor;
         bgErrorSquared *= scaleFactor * scaleFactor;
@@ -461,10 +652,15 @@ void IntegratePeaksMD2::integrate(typename MDEventWorkspace<MDE, nd>::sptr ws) {
         }
       }
       // spherical integration of signal
-      ws->getBox()->integrateSphere(
-          getRadiusSq, static_cast<coord_t>(adaptiveRadius * adaptiveRadius),
-          signal, errorSquared, 0.0 /* innerRadiusSquared */,
-          useOnePercentBackgroundCorrection);
+      if (integrateInBatch) {
+        signal = batchSums[i].signal;
+        errorSquared = batchSums[i].errorSquared;
+      } else {
+        ws->getBox()->integrateSphere(
+            getRadiusSq, static_cast<coord_t>(adaptiveRadius * adaptiveRadius),
+            signal, errorSquared, 0.0 /* innerRadiusSquared */,
+            useOnePercentBackgroundCorrection);
+      }
     } else {
       CoordTransformDistance cylinder(nd, center, dimensionsUsed, 2);
 
@@ -713,6 +909,150 @@ void IntegratePeaksMD2::integrate(typename MDEventWorkspace<MDE, nd>::sptr ws) {
   setProperty("OutputWorkspace", peakWS);
 }
 
+//----------------------------------------------------------------------------------------------
+/** Integrate the spheres and background shells of many peaks together. The
+ * leaf boxes are visited once each, in parallel, and the events of a box are
+ * only looked at for the peaks whose background shell or sphere reaches into
+ * it, found with a grid over the peak regions. Boxes that no peak reaches
+ * into are not loaded from file.
+ *
+ * The sums are those of MDGridBox::integrateSphere for each peak, except that
+ * the top 1% of the background is removed from the whole shell at once,
+ * rather than from each box the shell only partly covers.
+ *
+ * @param ws :: MDEventWorkspace to integrate
+ * @param centers :: centre of each peak
+ * @param peakRadii :: radius of the sphere of each peak, 0 for none
+ * @param bgInnerRadii :: inner radius of the background shell of each peak
+ * @param bgOuterRadii :: outer radius of the background shell of each peak,
+ * 0 for none
+ * @param useOnePercentBackgroundCorrection :: remove the top 1% of the
+ * background
+ * @return the signal and error in the sphere and the shell of each peak, the
+ * background is not scaled to the volume of the sphere
+ */
+template <typename MDE, size_t nd>
+std::vector<IntegratePeaksMD2::SphereSums> IntegratePeaksMD2::integrateSpheres(
+    typename MDEventWorkspace<MDE, nd>::sptr ws,
+    const std::vector<V3D> &centers,
+    const std::vector<double> &peakRadii,
+    const std::vector<double> &bgInnerRadii,
+    const std::vector<double> &bgOuterRadii,
+    const bool useOnePercentBackgroundCorrection) {
+  const size_t nPeaks = centers.size();
+  std::vector<double> reach(nPeaks);
+  for (size_t i = 0; i < nPeaks; ++i)
+    reach[i] = std::max(peakRadii[i], bgOuterRadii[i]);
+  const PeakRegionGrid grid(centers, reach);
+
+  // The leaves come depth first, so neighbouring boxes are of one subtree
+  std::vector<API::IMDNode *> boxes;
+  ws->getBox()->getBoxes(boxes, 1000, true);
+  const auto numBoxes = static_cast<int64_t>(boxes.size());
+
+  // The signal and error of the background events of each peak, kept until
+  // all of them are known when the top 1% is removed
+  using ShellEvent = std::tuple<size_t, signal_t, signal_t>;
+  std::vector<std::vector<ShellEvent>> threadShells(
+      useOnePercentBackgroundCorrection ? PARALLEL_GET_MAX_THREADS : 0);
+  std::vector<std::vector<SphereSums>> threadSums(
+      PARALLEL_GET_MAX_THREADS, std::vector<SphereSums>(nPeaks));
+  Progress progress(this, 0., 0.5, numBoxes);
+  PARALLEL_FOR_IF(!ws->isFileBacked())
+  for (int64_t i = 0; i < numBoxes; ++i) {
+    PARALLEL_START_INTERUPT_REGION
+    progress.report();
+    auto *box = dynamic_cast<MDBox<MDE, nd> *>(boxes[i]);
+    if (!box || box->getNPoints() == 0)
+      continue;
+    double min[nd], max[nd];
+    for (size_t d = 0; d < nd; ++d) {
+      min[d] = box->getExtents(d).getMin();
+      max[d] = box->getExtents(d).getMax();
+    }
+    std::vector<size_t> peaks;
+    grid.findPeaks(min, max, peaks);
+    if (peaks.empty())
+      continue;
+
+    auto &sums = threadSums[PARALLEL_THREAD_NUMBER];
+    const std::vector<MDE> &events = box->getConstEvents();
+    for (const size_t peak : peaks) {
+      coord_t center[nd];
+      for (size_t d = 0; d < nd; ++d)
+        center[d] = static_cast<coord_t>(centers[peak][d]);
+      const auto radiusSquared =
+          static_cast<coord_t>(peakRadii[peak] * peakRadii[peak]);
+      const auto outerSquared =
+          static_cast<coord_t>(pow(bgOuterRadii[peak], 2));
+      const auto innerSquared =
+          static_cast<coord_t>(pow(bgInnerRadii[peak], 2));
+      for (const auto &event : events) {
+        coord_t distanceSquared = 0;
+        for (size_t d = 0; d < nd; ++d) {
+          const coord_t dist = event.getCenter(d) - center[d];
+          distanceSquared += dist * dist;
+        }
+        if (distanceSquared < radiusSquared) {
+          sums[peak].signal += static_cast<signal_t>(event.getSignal());
+          sums[peak].errorSquared +=
+              static_cast<signal_t>(event.getErrorSquared());
+        }
+        if (distanceSquared < outerSquared && distanceSquared > innerSquared) {
+          if (useOnePercentBackgroundCorrection) {
+            threadShells[PARALLEL_THREAD_NUMBER].emplace_back(
+                peak, static_cast<signal_t>(event.getSignal()),
+                static_cast<signal_t>(event.getErrorSquared()));
+          } else {
+            sums[peak].bgSignal += static_cast<signal_t>(event.getSignal());
+            sums[peak].bgErrorSquared +=
+                static_cast<signal_t>(event.getErrorSquared());
+          }
+        }
+      }
+    }
+    box->releaseEvents();
+    PARALLEL_END_INTERUPT_REGION
+  }
+  PARALLEL_CHECK_INTERUPT_REGION
+
+  std::vector<SphereSums> result(nPeaks);
+  for (const auto &sums : threadSums) {
+    for (size_t i = 0; i < nPeaks; ++i) {
+      result[i].signal += sums[i].signal;
+      result[i].errorSquared += sums[i].errorSquared;
+      result[i].bgSignal += sums[i].bgSignal;
+      result[i].bgErrorSquared += sums[i].bgErrorSquared;
+    }
+  }
+
+  if (useOnePercentBackgroundCorrection) {
+    std::vector<ShellEvent> shells;
+    for (auto &shell : threadShells) {
+      shells.insert(shells.end(), shell.cbegin(), shell.cend());
+      std::vector<ShellEvent>().swap(shell);
+    }
+    // Sorted by peak, then by signal. Remove top 1% of the background of
+    // each peak.
+    std::sort(shells.begin(), shells.end());
+    auto it = shells.cbegin();
+    while (it != shells.cend()) {
+      const size_t peak = std::get<0>(*it);
+      auto end = std::find_if(it, shells.cend(), [peak](const ShellEvent &e) {
+        return std::get<0>(e) != peak;
+      });
+      const auto numKept = static_cast<size_t>(
+          0.99 * static_cast<double>(std::distance(it, end)));
+      for (auto kept = it; kept != it + numKept; ++kept) {
+        result[peak].bgSignal += std::get<1>(*kept);
+        result[peak].bgErrorSquared += std::get<2>(*kept);
+      }
+      it = end;
+    }
+  }
+  return result;
+}
+
 /**
  * Calculate the covariance matrix of a spherical region and store the
  * eigenvectors and eigenvalues that diagonalise the covariance matrix in the
@@ -590,9 +590,12 @@ void LoadMD::doLoad(typename MDEventWorkspace<MDE, nd>::sptr ws) {
     loader->openFile(m_filename, "r");
 
     const std::vector<uint64_t> &BoxEventIndex = FlatBoxTree.getEventIndex();
-    prog->setNumSteps(numBoxes);
+    const auto boxesInFileOrder = FlatBoxTree.getBoxesInFileOrder();
+    prog->setNumSteps(boxesInFileOrder.size());
 
-    for (size_t i = 0; i < numBoxes; i++) {
+    // Read the boxes in the order of their events on file, so the file is
+    // read from start to end
+    for (const auto i : boxesInFileOrder) {
       prog->report();
       auto *box = dynamic_cast<MDBox<MDE, nd> *>(boxTree[i]);
       if (!box)
@@ -57,6 +57,26 @@ constexpr double energyToK = 8.0 * M_PI * M_PI *
 static bool abs_compare(double a, double b) {
   return (std::fabs(a) < std::fabs(b));
 }
+
+// the largest size of the copies of the normalization made for the threads, in
+// number of bins: 256 MB
+constexpr size_t MAX_NORMALIZATION_COPIES_POINTS = 32 * 1024 * 1024;
+
+// the largest size of the normalizations kept for reuse by the following runs,
+// one per symmetry operation, in number of bins: 256 MB
+constexpr size_t MAX_CACHED_NORMALIZATION_POINTS = 32 * 1024 * 1024;
+
+// the indices of the first of the sorted values x above the lower of a and b,
+// and of the first one not below the higher of a and b
+std::pair<size_t, size_t> valuesBetween(const std::vector<double> &x, double a,
+                                        double b) {
+  if (a > b)
+    std::swap(a, b);
+  const auto first = std::upper_bound(x.cbegin(), x.cend(), a);
+  const auto last = std::lower_bound(first, x.cend(), b);
+  return {static_cast<size_t>(first - x.cbegin()),
+          static_cast<size_t>(last - x.cbegin())};
+}
 } // namespace
 
 // Register the algorithm into the AlgorithmFactory
@@ -73,6 +93,14 @@ MDNorm::MDNorm()
       m_Ei(0.0), m_diffraction(true), m_accumulate(false), m_dEIntegrated(true),
       m_samplePos(), m_beamDir(), convention("") {}
 
+/// Whether the trajectories are the same, and so is their normalization
+bool MDNorm::Trajectories::operator==(const Trajectories &other) const {
+  return transform == other.transform && otherValues == other.otherValues &&
+         lowValues == other.lowValues && highValues == other.highValues &&
+         theta == other.theta && phi == other.phi && detIDs == other.detIDs &&
+         used == other.used;
+}
+
 /// Algorithms name for identification. @see Algorithm::name
 const std::string MDNorm::name() const { return "MDNorm"; }
 
@@ -476,6 +504,14 @@ void MDNorm::exec() {
   this->setProperty("OutputDataWorkspace", outputDataWS);
 
   m_numExptInfos = outputDataWS->getNumExperimentInfo();
+  // Keep the normalization of every symmetry operation for the following runs,
+  // unless that takes too much memory
+  const size_t numCached =
+      m_numSymmOps * m_normWS->getNPoints() <= MAX_CACHED_NORMALIZATION_POINTS
+          ? m_numSymmOps
+          : 1;
+  m_cachedTrajectories.assign(numCached, Trajectories());
+  m_cachedNormalization.assign(numCached, std::vector<signal_t>());
   // loop over all experiment infos
   for (uint16_t expInfoIndex = 0; expInfoIndex < m_numExptInfos;
        expInfoIndex++) {
@@ -1144,13 +1180,13 @@ void MDNorm::calculateNormalization(const std::vector<coord_t> &otherValues,
                                     const Geometry::SymmetryOperation &so,
                                     uint16_t expInfoIndex, size_t soIndex) {
   const auto &currentExptInfo = *(m_inputWS->getExperimentInfo(expInfoIndex));
-  std::vector<double> lowValues, highValues;
+  Trajectories trajectories;
   auto *lowValuesLog = dynamic_cast<VectorDoubleProperty *>(
       currentExptInfo.getLog("MDNorm_low"));
-  lowValues = (*lowValuesLog)();
+  trajectories.lowValues = (*lowValuesLog)();
   auto *highValuesLog = dynamic_cast<VectorDoubleProperty *>(
       currentExptInfo.getLog("MDNorm_high"));
-  highValues = (*highValuesLog)();
+  trajectories.highValues = (*highValuesLog)();
 
   DblMatrix R = currentExptInfo.run().getGoniometerMatrix();
   DblMatrix soMatrix(3, 3);
@@ -1163,11 +1199,88 @@ void MDNorm::calculateNormalization(const std::vector<coord_t> &otherValues,
   soMatrix.Invert();
   DblMatrix Qtransform = R * m_UB * soMatrix * m_W;
   Qtransform.Invert();
+  trajectories.transform = Qtransform;
+  trajectories.otherValues = otherValues;
   const double protonCharge = currentExptInfo.run().getProtonCharge();
   const auto &spectrumInfo = currentExptInfo.spectrumInfo();
 
-  // Mappings
+  // Directions of the detectors
   const auto ndets = static_cast<int64_t>(spectrumInfo.size());
+  trajectories.theta.resize(ndets);
+  trajectories.phi.resize(ndets);
+  trajectories.detIDs.resize(ndets);
+  trajectories.used.resize(ndets);
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int64_t i = 0; i < ndets; i++) {
+    trajectories.used[i] = spectrumInfo.hasDetectors(i) &&
+                           !spectrumInfo.isMonitor(i) &&
+                           !spectrumInfo.isMasked(i);
+    if (!trajectories.used[i])
+      continue;
+    const auto &detector = spectrumInfo.detector(i);
+    trajectories.theta[i] = detector.getTwoTheta(m_samplePos, m_beamDir);
+    trajectories.phi[i] = detector.getPhi();
+    // If the dtefctor is a group, this should be the ID of the first detector
+    trajectories.detIDs[i] = detector.getID();
+  }
+
+  double progStep = 0.7 / static_cast<double>(m_numExptInfos * m_numSymmOps);
+  auto progIndex = static_cast<double>(soIndex + expInfoIndex * m_numSymmOps);
+  auto prog =
+      std::make_unique<API::Progress>(this, 0.3 + progStep * progIndex,
+                                      0.3 + progStep * (1. + progIndex), ndets);
+
+  // Runs measured with the same goniometer settings, such as the runs of a
+  // scan repeated to collect more data, have the same trajectories for each
+  // symmetry operation.
+  const size_t cacheIndex = soIndex % m_cachedNormalization.size();
+  auto &cachedTrajectories = m_cachedTrajectories[cacheIndex];
+  auto &normalization = m_cachedNormalization[cacheIndex];
+  if (normalization.size() != m_normWS->getNPoints() ||
+      !(trajectories == cachedTrajectories)) {
+    calculateNormalizationPerCharge(trajectories, normalization, *prog);
+    cachedTrajectories = std::move(trajectories);
+  } else {
+    g_log.debug() << "Run " << expInfoIndex << " has the same trajectories as "
+                  << "the previous one for symmetry operation " << soIndex
+                  << ", reusing its normalization.\n";
+  }
+
+  if (m_accumulate) {
+    std::transform(normalization.cbegin(), normalization.cend(),
+                   m_normWS->getSignalArray(), m_normWS->mutableSignalArray(),
+                   [protonCharge](const signal_t a, const signal_t b) {
+                     return protonCharge * a + b;
+                   });
+  } else {
+    std::transform(
+        normalization.cbegin(), normalization.cend(),
+        m_normWS->mutableSignalArray(),
+        [protonCharge](const signal_t a) { return protonCharge * a; });
+  }
+  m_accumulate = true;
+}
+
+/**
+ * Calculate the normalization for a unit proton charge of the trajectories of
+ * one run for one symmetry operation.
+ *
+ * The detectors are shared out among the threads. Each thread accumulates
+ * into its own copy of the normalization, and the copies are added at the end,
+ * unless the copies would take too much memory.
+ * @param trajectories - the trajectories of the detectors
+ * @param normalization - set to the normalization, one value per bin
+ * @param prog - progress reporter, one step per detector
+ */
+void MDNorm::calculateNormalizationPerCharge(
+    const Trajectories &trajectories, std::vector<signal_t> &normalization,
+    API::Progress &prog) {
+  const auto &otherValues = trajectories.otherValues;
+  const auto &lowValues = trajectories.lowValues;
+  const auto &highValues = trajectories.highValues;
+  const auto ndets = static_cast<int64_t>(trajectories.used.size());
+
+  // Mappings
   bool haveSA = false;
   API::MatrixWorkspace_const_sptr solidAngleWS =
       getProperty("SolidAngleWorkspace");
@@ -1183,35 +1296,33 @@ void MDNorm::calculateNormalization(const std::vector<coord_t> &otherValues,
                       : detid2index_map();
 
   const size_t vmdDims = (m_diffraction) ? 3 : 4;
-  std::vector<std::atomic<signal_t>> signalArray(m_normWS->getNPoints());
+  const size_t nPoints = m_normWS->getNPoints();
   std::vector<std::array<double, 4>> intersections;
   std::vector<double> xValues, yValues;
   std::vector<coord_t> pos, posNew;
 
-  double progStep = 0.7 / static_cast<double>(m_numExptInfos * m_numSymmOps);
-  auto progIndex = static_cast<double>(soIndex + expInfoIndex * m_numSymmOps);
-  auto prog =
-      std::make_unique<API::Progress>(this, 0.3 + progStep * progIndex,
-                                      0.3 + progStep * (1. + progIndex), ndets);
   bool safe = true;
   if (m_diffraction) {
     safe = Kernel::threadSafe(*integrFlux);
   }
+  const auto numThreads =
+      static_cast<size_t>(safe ? PARALLEL_GET_MAX_THREADS : 1);
+  const bool threadCopies =
+      nPoints * numThreads <= MAX_NORMALIZATION_COPIES_POINTS;
+  std::vector<std::vector<signal_t>> threadSignal(threadCopies ? numThreads
+                                                               : 0);
+  std::vector<std::atomic<signal_t>> signalArray(threadCopies ? 0 : nPoints);
+
   // cppcheck-suppress syntaxError
 PRAGMA_OMP(parallel for private(intersections, xValues, yValues, pos, posNew) if (safe))
 for (int64_t i = 0; i < ndets; i++) {
   PARALLEL_START_INTERUPT_REGION
 
-  if (!spectrumInfo.hasDetectors(i) || spectrumInfo.isMonitor(i) ||
-      spectrumInfo.isMasked(i)) {
+  if (!trajectories.used[i]) {
     continue;
   }
 
-  const auto &detector = spectrumInfo.detector(i);
-  double theta = detector.getTwoTheta(m_samplePos, m_beamDir);
-  double phi = detector.getPhi();
-  // If the dtefctor is a group, this should be the ID of the first detector
-  const auto detID = detector.getID();
+  const auto detID = trajectories.detIDs[i];
 
   // get the flux spectrum number
   size_t wsIdx = 0;
@@ -1225,15 +1336,15 @@ for (int64_t i = 0; i < ndets; i++) {
   }
 
   // Intersections
-  this->calculateIntersections(intersections, theta, phi, Qtransform,
+  this->calculateIntersections(intersections, trajectories.theta[i],
+                               trajectories.phi[i], trajectories.transform,
                                lowValues[i], highValues[i]);
   if (intersections.empty())
     continue;
   // Get solid angle for this contribution
-  double solid = protonCharge;
+  double solid = 1.;
   if (haveSA) {
-    solid =
-        solidAngleWS->y(solidAngDetToIdx.find(detID)->second)[0] * protonCharge;
+    solid = solidAngleWS->y(solidAngDetToIdx.find(detID)->second)[0];
   }
   if (m_diffraction) {
     // -- calculate integrals for the intersection --
@@ -1289,32 +1400,44 @@ for (int64_t i = 0; i < ndets; i++) {
       // transform kf to energy transfer
       pos[3] = static_cast<coord_t>(m_Ei - pos[3] * pos[3] / energyToK);
       // signal = energy distance between two consecutive intersections *solid
-      // angle *PC
+      // angle
       signal = solid * delta;
     }
     m_transformation.multiplyPoint(pos, posNew);
     size_t linIndex = m_normWS->getLinearIndexAtCoord(posNew.data());
     if (linIndex == size_t(-1))
       continue;
-    Mantid::Kernel::AtomicOp(signalArray[linIndex], signal,
-                             std::plus<signal_t>());
+    if (threadCopies) {
+      auto &signalCopy = threadSignal[PARALLEL_THREAD_NUMBER];
+      if (signalCopy.empty())
+        signalCopy.resize(nPoints, 0.);
+      signalCopy[linIndex] += signal;
+    } else {
+      Mantid::Kernel::AtomicOp(signalArray[linIndex], signal,
+                               std::plus<signal_t>());
+    }
   }
 
-  prog->report();
+  prog.report();
 
   PARALLEL_END_INTERUPT_REGION
 }
 PARALLEL_CHECK_INTERUPT_REGION
-if (m_accumulate) {
-  std::transform(
-      signalArray.cbegin(), signalArray.cend(), m_normWS->getSignalArray(),
-      m_normWS->mutableSignalArray(),
-      [](const std::atomic<signal_t> &a, const signal_t &b) { return a + b; });
+
+normalization.assign(nPoints, 0.);
+if (threadCopies) {
+  const auto numPoints = static_cast<int64_t>(nPoints);
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int64_t j = 0; j < numPoints; j++) {
+    for (const auto &signalCopy : threadSignal) {
+      if (!signalCopy.empty())
+        normalization[j] += signalCopy[j];
+    }
+  }
 } else {
   std::copy(signalArray.cbegin(), signalArray.cend(),
-            m_normWS->mutableSignalArray());
+            normalization.begin());
 }
-m_accumulate = true;
 }
 
 /**
@@ -1373,19 +1496,18 @@ void MDNorm::calculateIntersections(
     double fmom = (kfmax - kfmin) / (hEnd - hStart);
     double fk = (kEnd - kStart) / (hEnd - hStart);
     double fl = (lEnd - lStart) / (hEnd - hStart);
-    for (size_t i = 0; i < hNBins; i++) {
+    const auto range = valuesBetween(m_hX, hStart, hEnd);
+    for (size_t i = range.first; i < range.second; i++) {
       double hi = m_hX[i];
-      if (((hStart - hi) * (hEnd - hi) < 0)) {
-        // if hi is between hStart and hEnd, then ki and li will be between
-        // kStart, kEnd and lStart, lEnd and momi will be between kfmin and
-        // kfmax
-        double ki = fk * (hi - hStart) + kStart;
-        double li = fl * (hi - hStart) + lStart;
-        if ((ki >= m_kX[0]) && (ki <= m_kX[kNBins - 1]) && (li >= m_lX[0]) &&
-            (li <= m_lX[lNBins - 1])) {
-          double momi = fmom * (hi - hStart) + kfmin;
-          intersections.push_back({{hi, ki, li, momi}});
-        }
+      // if hi is between hStart and hEnd, then ki and li will be between
+      // kStart, kEnd and lStart, lEnd and momi will be between kfmin and
+      // kfmax
+      double ki = fk * (hi - hStart) + kStart;
+      double li = fl * (hi - hStart) + lStart;
+      if ((ki >= m_kX[0]) && (ki <= m_kX[kNBins - 1]) && (li >= m_lX[0]) &&
+          (li <= m_lX[lNBins - 1])) {
+        double momi = fmom * (hi - hStart) + kfmin;
+        intersections.push_back({{hi, ki, li, momi}});
       }
     }
   }
@@ -1394,19 +1516,18 @@ void MDNorm::calculateIntersections(
     double fmom = (kfmax - kfmin) / (kEnd - kStart);
     double fh = (hEnd - hStart) / (kEnd - kStart);
     double fl = (lEnd - lStart) / (kEnd - kStart);
-    for (size_t i = 0; i < kNBins; i++) {
+    const auto range = valuesBetween(m_kX, kStart, kEnd);
+    for (size_t i = range.first; i < range.second; i++) {
       double ki = m_kX[i];
-      if (((kStart - ki) * (kEnd - ki) < 0)) {
-        // if ki is between kStart and kEnd, then hi and li will be between
-        // hStart, hEnd and lStart, lEnd and momi will be between kfmin and
-        // kfmax
-        double hi = fh * (ki - kStart) + hStart;
-        double li = fl * (ki - kStart) + lStart;
-        if ((hi >= m_hX[0]) && (hi <= m_hX[hNBins - 1]) && (li >= m_lX[0]) &&
-            (li <= m_lX[lNBins - 1])) {
-          double momi = fmom * (ki - kStart) + kfmin;
-          intersections.push_back({{hi, ki, li, momi}});
-        }
+      // if ki is between kStart and kEnd, then hi and li will be between
+      // hStart, hEnd and lStart, lEnd and momi will be between kfmin and
+      // kfmax
+      double hi = fh * (ki - kStart) + hStart;
+      double li = fl * (ki - kStart) + lStart;
+      if ((hi >= m_hX[0]) && (hi <= m_hX[hNBins - 1]) && (li >= m_lX[0]) &&
+          (li <= m_lX[lNBins - 1])) {
+        double momi = fmom * (ki - kStart) + kfmin;
+        intersections.push_back({{hi, ki, li, momi}});
       }
     }
   }
@@ -1417,16 +1538,15 @@ void MDNorm::calculateIntersections(
     double fh = (hEnd - hStart) / (lEnd - lStart);
     double fk = (kEnd - kStart) / (lEnd - lStart);
 
-    for (size_t i = 0; i < lNBins; i++) {
+    const auto range = valuesBetween(m_lX, lStart, lEnd);
+    for (size_t i = range.first; i < range.second; i++) {
       double li = m_lX[i];
-      if (((lStart - li) * (lEnd - li) < 0)) {
-        double hi = fh * (li - lStart) + hStart;
-        double ki = fk * (li - lStart) + kStart;
-        if ((hi >= m_hX[0]) && (hi <= m_hX[hNBins - 1]) && (ki >= m_kX[0]) &&
-            (ki <= m_kX[kNBins - 1])) {
-          double momi = fmom * (li - lStart) + kfmin;
-          intersections.push_back({{hi, ki, li, momi}});
-        }
+      double hi = fh * (li - lStart) + hStart;
+      double ki = fk * (li - lStart) + kStart;
+      if ((hi >= m_hX[0]) && (hi <= m_hX[hNBins - 1]) && (ki >= m_kX[0]) &&
+          (ki <= m_kX[kNBins - 1])) {
+        double momi = fmom * (li - lStart) + kfmin;
+        intersections.push_back({{hi, ki, li, momi}});
       }
     }
   }
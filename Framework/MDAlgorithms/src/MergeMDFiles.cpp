@@ -18,6 +18,8 @@
 #include <Poco/File.h>
 #include <boost/scoped_ptr.hpp>
 
+#include <limits>
+
 using namespace Mantid::Kernel;
 using namespace Mantid::API;
 using namespace Mantid::DataObjects;
@@ -59,9 +61,11 @@ void MergeMDFiles::init() {
       "Optional: if specified, the workspace created will be file-backed. \n"
       "If not, it will be created in memory.");
 
-  declareProperty("Parallel", false,
-                  "Run the loading tasks in parallel.\n"
-                  "This can be faster but might use more memory.");
+  declareProperty("Parallel", true,
+                  "Merge the events of several boxes in parallel.\n"
+                  "The input files are still read one block at a time. The "
+                  "boxes are merged in groups that fit in the write buffer of "
+                  "a file-backed output, so this does not use more memory.");
 
   declareProperty(std::make_unique<WorkspaceProperty<IMDEventWorkspace>>(
                       "OutputWorkspace", "", Direction::Output),
@@ -131,20 +135,37 @@ void MergeMDFiles::loadBoxData() {
   }
 
   const std::vector<int> &boxType = m_BoxStruct.getBoxType();
-  // calculate event positions in the target file.
+  for (auto mdBox : Boxes)
+    mdBox->clear();
+  // calculate event positions in the target file, in the Morton order of the
+  // boxes (see MDBoxMortonIndex) as SaveMD does. The boxes are merged in this
+  // order, so the output file is written sequentially.
+  m_mergeOrder.clear();
   uint64_t eventsStart = 0;
+  for (const auto &entry : m_BoxStruct.getMortonIndex().entries()) {
+    const size_t ID = entry.boxId;
+    uint64_t nEvents = targetEventIndexes[2 * ID + 1];
+    targetEventIndexes[ID * 2] = eventsStart;
+    if (m_fileBasedTargetWS)
+      Boxes[ID]->setFileBacked(eventsStart, nEvents, false);
+    m_mergeOrder.emplace_back(ID);
+
+    eventsStart += nEvents;
+  }
+  // the boxes not in the index, which are empty
   for (auto mdBox : Boxes) {
-    mdBox->clear();
     size_t ID = mdBox->getID();
-
     // avoid grid boxes;
-    if (boxType[ID] == 2)
+    if (boxType[ID] == 2 ||
+        (boxType[ID] == 1 && targetEventIndexes[2 * ID + 1] > 0))
       continue;
 
     uint64_t nEvents = targetEventIndexes[2 * ID + 1];
     targetEventIndexes[ID * 2] = eventsStart;
     if (m_fileBasedTargetWS)
       mdBox->setFileBacked(eventsStart, nEvents, false);
+    if (nEvents > 0)
+      m_mergeOrder.emplace_back(ID);
 
     eventsStart += nEvents;
   }
@@ -172,19 +193,27 @@ uint64_t MergeMDFiles::loadEventsFromSubBoxes(API::IMDNode *TargetBox) {
     nBoxEvents += numFileEvents[iw];
   }
 
-  // At this point memory required is known, so it is reserved all in one go
-  TargetBox->reserveMemoryForLoad(nBoxEvents);
-
-  for (size_t iw = 0; iw < this->m_EventLoader.size(); iw++) {
-    size_t ID = TargetBox->getID();
-    uint64_t fileLocation =
-        m_fileComponentsStructure[iw].getEventIndex()[2 * ID + 0];
-    if (numFileEvents[iw] == 0)
-      continue;
-    TargetBox->loadAndAddFrom(m_EventLoader[iw], fileLocation,
-                              numFileEvents[iw]);
+  std::vector<coord_t> boxData;
+  {
+    // Neither the file loaders nor the NeXus API can be used by several
+    // threads at once, so the reads of all boxes are done one at a time
+    std::lock_guard<std::mutex> lock(m_fileMutex);
+    std::vector<coord_t> fileData;
+    for (size_t iw = 0; iw < this->m_EventLoader.size(); iw++) {
+      size_t ID = TargetBox->getID();
+      uint64_t fileLocation =
+          m_fileComponentsStructure[iw].getEventIndex()[2 * ID + 0];
+      if (numFileEvents[iw] == 0)
+        continue;
+      m_EventLoader[iw]->loadBlock(fileData, fileLocation, numFileEvents[iw]);
+      boxData.insert(boxData.end(), fileData.cbegin(), fileData.cend());
+    }
   }
 
+  // Turning the data into events does not touch the files, so boxes are
+  // merged in parallel
+  TargetBox->setEventsData(boxData);
+
   return nBoxEvents;
 }
 
@@ -203,8 +232,8 @@ void MergeMDFiles::doExecByCloning(
   m_OutIWS = ws;
   m_MDEventType = ws->getEventTypeName();
 
-  // Run the tasks in parallel? TODO: enable
-  // bool Parallel = this->getProperty("Parallel");
+  // Merge the boxes in parallel?
+  const bool parallel = this->getProperty("Parallel");
 
   // Fix the box controller settings in the output workspace so that it splits
   // normally
@@ -236,70 +265,68 @@ void MergeMDFiles::doExecByCloning(
   // positions of the target workspace
   this->loadBoxData();
 
-  size_t numBoxes = m_BoxStruct.getNBoxes();
-  // Progress report based on events processed.
-  m_progress = std::make_unique<Progress>(this, 0.1, 0.9, size_t(numBoxes));
+  // Progress report based on boxes merged.
+  m_progress = std::make_unique<Progress>(this, 0.1, 0.9, m_mergeOrder.size());
   m_progress->setNotifyStep(0.1);
 
-  // For tracking progress
-  // uint64_t m_totalEventsInTasks = 0;
-
-  // Prepare thread pool
   CPUTimer overallTime;
 
-  auto ts = new ThreadSchedulerFIFO();
-  ThreadPool tp(ts);
-
   Kernel::DiskBuffer *DiskBuf(nullptr);
+  // The largest number of events held in memory at once
+  uint64_t maxBatchEvents = std::numeric_limits<uint64_t>::max();
   if (m_fileBasedTargetWS) {
     DiskBuf = bc->getFileIO();
+    maxBatchEvents = DiskBuf->getWriteBufferSize();
   }
 
   this->m_totalLoaded = 0;
   std::vector<API::IMDNode *> &boxes = m_BoxStruct.getBoxes();
+  const std::vector<uint64_t> &targetEventIndexes = m_BoxStruct.getEventIndex();
+
+  size_t batchStart = 0;
+  while (batchStart < m_mergeOrder.size()) {
+    // take the next boxes in file order, as many as fit in the memory allowed
+    size_t batchEnd = batchStart;
+    uint64_t batchEvents = 0;
+    do {
+      batchEvents += targetEventIndexes[2 * m_mergeOrder[batchEnd] + 1];
+      batchEnd++;
+    } while (batchEnd < m_mergeOrder.size() &&
+             batchEvents + targetEventIndexes[2 * m_mergeOrder[batchEnd] + 1] <=
+                 maxBatchEvents);
+
+    // load all contributed events into the boxes; the events of a box are
+    // built while the next box is read
+    const auto batchSize = static_cast<int64_t>(batchEnd - batchStart);
+    PARALLEL_FOR_IF(parallel)
+    for (int64_t i = 0; i < batchSize; i++) {
+      PARALLEL_START_INTERUPT_REGION
+      API::IMDNode *box = boxes[m_mergeOrder[batchStart + size_t(i)]];
+      const uint64_t nEvents = this->loadEventsFromSubBoxes(box);
+      {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        m_totalLoaded += nEvents;
+      }
+      m_progress->report("Loading and merging box data");
+      PARALLEL_END_INTERUPT_REGION
+    }
+    PARALLEL_CHECK_INTERUPT_REGION
 
-  for (size_t ib = 0; ib < numBoxes; ib++) {
-    auto box = boxes[ib];
-    if (!box->isBox())
-      continue;
-    // load all contributed events into current box;
-    this->loadEventsFromSubBoxes(boxes[ib]);
-
+    // write the merged boxes out in file order and release their memory; the
+    // data positions have been already pre-calculated
     if (DiskBuf) {
-      if (box->getDataInMemorySize() >
-          0) { // data position has been already pre-calculated
+      for (size_t ib = batchStart; ib < batchEnd; ib++) {
+        API::IMDNode *box = boxes[m_mergeOrder[ib]];
         box->getISaveable()->save();
         box->clearDataFromMemory();
-        // Kernel::ISaveable *Saver = box->getISaveable();
-        // DiskBuf->toWrite(Saver);
       }
     }
-    // else
-    //{   size_t ID = box->getID();
-    //    uint64_t filePosition = targetEventIndexes[2*ID];
-    //    box->saveAt(saver.get(), filePosition);
-    //}
-    //
-    // if (!Parallel)
-    //{
-    //  // Run the task serially only
-    //  task->run();
-    //  delete task;
-    //}
-    // else
-    //{
-    //  // Enqueue to run in parallel (at the joinAll() call below).
-    //  ts->push(task);
-    //}
-
-    m_progress->reportIncrement(ib, "Loading and merging box data");
+    batchStart = batchEnd;
   }
   if (DiskBuf) {
     DiskBuf->flushCache();
     bc->getFileIO()->flushData();
   }
-  //// Run any final tasks
-  // tp.joinAll();
   g_log.information() << overallTime << " to do all the adding.\n";
 
   // Close any open file handle
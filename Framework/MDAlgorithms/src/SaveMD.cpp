@@ -177,7 +177,9 @@ void SaveMD::doSaveEvents(typename MDEventWorkspace<MDE, nd>::sptr ws) {
       // saveable and that the boxes were not saved.
       BoxFlatStruct.setBoxesFilePositions(true);
       prog->resetNumSteps(boxes.size(), 0.06, 0.90);
-      for (auto &boxe : boxes) {
+      // write the boxes in the order they are laid out on file
+      for (const auto i : BoxFlatStruct.getBoxesInFileOrder()) {
+        auto &boxe = boxes[i];
         auto saveableTag = boxe->getISaveable();
         if (saveableTag) // only boxes can be saveable
         {
@@ -207,8 +209,8 @@ void SaveMD::doSaveEvents(typename MDEventWorkspace<MDE, nd>::sptr ws) {
       std::vector<API::IMDNode *> &boxes = BoxFlatStruct.getBoxes();
       std::vector<uint64_t> &eventIndex = BoxFlatStruct.getEventIndex();
       prog->resetNumSteps(boxes.size(), 0.06, 0.90);
-      for (size_t i = 0; i < boxes.size(); i++) {
-        if (eventIndex[2 * i + 1] == 0 || boxes[i]->getIsMasked())
+      for (const auto i : BoxFlatStruct.getBoxesInFileOrder()) {
+        if (boxes[i]->getIsMasked())
           continue;
         boxes[i]->saveAt(Saver.get(), eventIndex[2 * i]);
         prog->report("Saving Box");
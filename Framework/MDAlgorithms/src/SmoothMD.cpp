@@ -9,6 +9,7 @@
 #include "MantidAPI/IMDHistoWorkspace.h"
 #include "MantidAPI/IMDIterator.h"
 #include "MantidAPI/Progress.h"
+#include "MantidDataObjects/MDHistoWorkspace.h"
 #include "MantidDataObjects/MDHistoWorkspaceIterator.h"
 #include "MantidKernel/ArrayBoundedValidator.h"
 #include "MantidKernel/ArrayProperty.h"
@@ -18,6 +19,7 @@
 #include "MantidKernel/MultiThreaded.h"
 #include "MantidKernel/PropertyWithValue.h"
 #include <boost/tuple/tuple.hpp>
+#include <algorithm>
 #include <limits>
 #include <map>
 #include <memory>
@@ -271,7 +273,9 @@ SmoothMD::hatSmooth(const IMDHistoWorkspace_const_sptr &toSmooth,
  * The Gaussian function is linearly separable, allowing convolution
  * of a multidimensional Gaussian kernel with the workspace to be carried out by
  * a convolution with a 1D Gaussian kernel in each dimension. This
- * reduces the number of calculations overall.
+ * reduces the number of calculations overall. Each 1D convolution works
+ * directly on the signal and error arrays, with the bins shared between
+ * threads.
  * @param toSmooth : Workspace to smooth
  * @param widthVector : Width vector
  * @param weightingWS : Weighting workspace (optional)
@@ -283,31 +287,30 @@ SmoothMD::gaussianSmooth(const IMDHistoWorkspace_const_sptr &toSmooth,
                          OptionalIMDHistoWorkspace_const_sptr weightingWS) {
 
   const bool useWeights = weightingWS.is_initialized();
-  uint64_t nPoints = toSmooth->getNPoints();
-  Progress progress(this, 0.0, 1.0, size_t(double(nPoints) * 1.1));
+  const auto histoWS =
+      std::dynamic_pointer_cast<const MDHistoWorkspace>(toSmooth);
+  if (!histoWS) {
+    throw std::logic_error(
+        "Failed to cast IMDHistoWorkspace to MDHistoWorkspace");
+  }
+  const auto nPoints = static_cast<int64_t>(toSmooth->getNPoints());
+  Progress progress(this, 0.0, 1.0, widthVector.size() + 1);
   // Create the output workspace
   IMDHistoWorkspace_sptr outWS(toSmooth->clone().release());
   // Create a temporary workspace
   IMDHistoWorkspace_sptr tempWS(toSmooth->clone().release());
-  // Report ~10% progress
-  progress.reportIncrement(size_t(double(nPoints) * 0.1));
-
-  // Create a kernel for each dimension and
-  std::vector<KernelVector> gaussian_kernels;
-  gaussian_kernels.reserve(widthVector.size());
-  for (const auto width : widthVector) {
-    gaussian_kernels.emplace_back(gaussianKernel(width));
-  }
+  progress.report();
 
-  const int nThreads = Mantid::API::FrameworkManager::Instance()
-                           .getNumOMPThreads(); // NThreads to Request
+  // Masked bins are left as they are. Bins with a zero weight are set to NaN.
+  const bool *masks = histoWS->getMaskArray();
+  const signal_t *weights =
+      useWeights ? (*weightingWS)->getSignalArray() : nullptr;
 
   auto write_ws = tempWS;
+  size_t stride = 1;
   for (size_t dimension_number = 0; dimension_number < widthVector.size();
        ++dimension_number) {
 
-    auto iterators = toSmooth->createIterators(nThreads, nullptr);
-
     // Alternately write to each workspace
     IMDHistoWorkspace_sptr read_ws;
     if (dimension_number % 2 == 0) {
@@ -318,67 +321,59 @@ SmoothMD::gaussianSmooth(const IMDHistoWorkspace_const_sptr &toSmooth,
       write_ws = outWS;
     }
 
-    PARALLEL_FOR_NO_WSP_CHECK()
-    for (int it = 0; it < int(iterators.size()); ++it) { // NOLINT
-
-      PARALLEL_START_INTERUPT_REGION
-      auto iterator =
-          dynamic_cast<MDHistoWorkspaceIterator *>(iterators[it].get());
-      if (!iterator) {
-        throw std::logic_error(
-            "Failed to cast IMDIterator to MDHistoWorkspaceIterator");
+    // The kernel, renormalised where it overlaps the edges of the workspace,
+    // for each bin along this dimension
+    const KernelVector kernel = gaussianKernel(widthVector[dimension_number]);
+    const auto kernelSize = static_cast<int64_t>(kernel.size());
+    const int64_t halfWidth = kernelSize / 2;
+    const auto nBins = static_cast<int64_t>(
+        toSmooth->getDimension(dimension_number)->getNBins());
+    std::vector<KernelVector> kernels(nBins);
+    for (int64_t bin = 0; bin < nBins; ++bin) {
+      std::vector<bool> indexValidity(kernel.size());
+      for (int64_t k = 0; k < kernelSize; ++k) {
+        const int64_t neighbour = bin + k - halfWidth;
+        indexValidity[k] = neighbour >= 0 && neighbour < nBins;
       }
+      kernels[bin] = renormaliseKernel(kernel, indexValidity);
+    }
 
-      do {
-
-        // Gets linear index at current position
-        size_t iteratorIndex = iterator->getLinearIndex();
-
-        if (useWeights) {
-
-          // Check that we could measure here.
-          if ((*weightingWS)->getSignalAt(iteratorIndex) == 0) {
-
-            write_ws->setSignalAt(iteratorIndex,
-                                  std::numeric_limits<double>::quiet_NaN());
-            write_ws->setErrorSquaredAt(
-                iteratorIndex, std::numeric_limits<double>::quiet_NaN());
-
-            continue; // Skip we couldn't measure here.
-          }
-        }
-
-        std::pair<std::vector<size_t>, std::vector<bool>> indexesAndValidity =
-            iterator->findNeighbourIndexesByWidth1D(
-                static_cast<int>(gaussian_kernels[dimension_number].size()),
-                static_cast<int>(dimension_number));
-        std::vector<size_t> neighbourIndexes = std::get<0>(indexesAndValidity);
-        std::vector<bool> indexValidity = std::get<1>(indexesAndValidity);
-        auto normalised_kernel = renormaliseKernel(
-            gaussian_kernels[dimension_number], indexValidity);
-
-        // Convolve signal with kernel
-        double sumSignal = 0;
-        double sumSquareError = 0;
-        double error = 0;
-        for (size_t i = 0; i < neighbourIndexes.size(); ++i) {
-          if (indexValidity[i]) {
-            sumSignal += read_ws->getSignalAt(neighbourIndexes[i]) *
-                         normalised_kernel[i];
-            error =
-                read_ws->getErrorAt(neighbourIndexes[i]) * normalised_kernel[i];
-            sumSquareError += error * error;
-          }
-
-          write_ws->setSignalAt(iteratorIndex, sumSignal);
-          write_ws->setErrorSquaredAt(iteratorIndex, sumSquareError);
-        }
-        progress.report();
+    const signal_t *readSignals = read_ws->getSignalArray();
+    const signal_t *readErrorsSquared = read_ws->getErrorSquaredArray();
+    signal_t *writeSignals = write_ws->mutableSignalArray();
+    signal_t *writeErrorsSquared = write_ws->mutableErrorSquaredArray();
+    const auto step = static_cast<int64_t>(stride);
 
-      } while (iterator->next());
-      PARALLEL_END_INTERUPT_REGION
+    PARALLEL_FOR_NO_WSP_CHECK()
+    for (int64_t i = 0; i < nPoints; ++i) {
+      if (masks[i])
+        continue;
+      if (useWeights && weights[i] == 0) {
+        // Skip we couldn't measure here.
+        writeSignals[i] = std::numeric_limits<double>::quiet_NaN();
+        writeErrorsSquared[i] = std::numeric_limits<double>::quiet_NaN();
+        continue;
+      }
+      const int64_t bin = (i / step) % nBins;
+      const KernelVector &binKernel = kernels[bin];
+      const int64_t kMin = std::max(int64_t(0), halfWidth - bin);
+      const int64_t kMax = std::min(kernelSize, nBins - bin + halfWidth);
+
+      // Convolve signal with kernel
+      double sumSignal = 0;
+      double sumSquareError = 0;
+      for (int64_t k = kMin; k < kMax; ++k) {
+        const int64_t neighbour = i + (k - halfWidth) * step;
+        sumSignal += readSignals[neighbour] * binKernel[k];
+        const double error =
+            std::sqrt(readErrorsSquared[neighbour]) * binKernel[k];
+        sumSquareError += error * error;
+      }
+      writeSignals[i] = sumSignal;
+      writeErrorsSquared[i] = sumSquareError;
     }
-    PARALLEL_CHECK_INTERUPT_REGION
+    stride *= static_cast<size_t>(nBins);
+    progress.report();
   }
 
   return write_ws;
@@ -364,6 +364,42 @@ public:
                       outWS->displayNormalization(), histNorm);
   }
 
+  void test_3D_integration_of_two_dimensions_with_mask() {
+
+    /*
+     * Integrate y over [2.5, 7.5], which covers four whole bins and half of
+     * two others, and z over the full range, keeping x. One bin is masked.
+     */
+
+    using namespace Mantid::DataObjects;
+    MDHistoWorkspace_sptr ws = MDEventsTestHelper::makeFakeMDHistoWorkspace(
+        1.0 /*signal*/, 3 /*nd*/, 10 /*nbins*/, 10 /*max*/, 1.0 /*error sq*/);
+    // x = 4, y = 5, z = 5
+    ws->setMDMaskAt(4 + 10 * 5 + 100 * 5, true);
+
+    IntegrateMDHistoWorkspace alg;
+    alg.setChild(true);
+    alg.setRethrows(true);
+    alg.initialize();
+    alg.setProperty("InputWorkspace", ws);
+    alg.setProperty("P1Bin", std::vector<double>(0));
+    alg.setProperty("P2Bin", std::vector<double>{2.5, 7.5});
+    alg.setProperty("P3Bin", std::vector<double>{0, 10});
+    alg.setPropertyValue("OutputWorkspace", "dummy");
+    alg.execute();
+    IMDHistoWorkspace_sptr outWS = alg.getProperty("OutputWorkspace");
+
+    TS_ASSERT_EQUALS(10, outWS->getNPoints());
+    for (size_t i = 0; i < outWS->getNPoints(); ++i) {
+      // 5 bins in y times 10 bins in z, less the masked one
+      const double expected = i == 4 ? 49.0 : 50.0;
+      TSM_ASSERT_DELTA("Wrong integrated value", expected,
+                       outWS->getSignalAt(i), 1e-4);
+      TSM_ASSERT_DELTA("Wrong error value", std::sqrt(expected),
+                       outWS->getErrorAt(i), 1e-4);
+    }
+  }
+
   void test_2d_partial_binning() {
 
     /*
@@ -26,6 +26,7 @@
 #include <boost/math/special_functions/pow.hpp>
 
 #include <cxxtest/TestSuite.h>
+#include <numeric>
 #include <random>
 
 #include <MantidDataObjects/PeakShapeEllipsoid.h>
@@ -435,6 +436,125 @@ public:
                          peakWS->getPeak(0).getIntensity(), 1500);
   }
 
+  //-------------------------------------------------------------------------------
+  /// Integrating all of the peaks in one pass gives the same intensities
+  void test_exec_IntegrateInBatch() {
+    createMDEW();
+    addPeak(1000, 0., 0., 0., 1.0);
+    addPeak(1000, 2., 3., 4., 0.5);
+    addPeak(1000, 6., 6., 6., 2.0);
+    // Background under all of the peaks
+    addPeak(3000, 2., 2., 2., 8.0);
+    MDEventWorkspace3Lean::sptr mdews =
+        AnalysisDataService::Instance().retrieveWS<MDEventWorkspace3Lean>(
+            "IntegratePeaksMD2Test_MDEWS");
+    mdews->setCoordinateSystem(Mantid::Kernel::HKL);
+
+    Instrument_sptr inst =
+        ComponentCreationHelper::createTestInstrumentRectangular(1, 100, 0.05);
+    PeaksWorkspace_sptr peakWS(new PeaksWorkspace());
+    peakWS->setInstrument(inst);
+    // The last peak has a shell overlapping the first two
+    for (const auto &hkl : {V3D(0., 0., 0.), V3D(2., 3., 4.), V3D(6., 6., 6.),
+                            V3D(1., 1.5, 2.)})
+      peakWS->addPeak(Peak(inst, 15050, 1.0, hkl));
+    AnalysisDataService::Instance().addOrReplace("IntegratePeaksMD2Test_peaks",
+                                                 peakWS);
+
+    const auto single = integrateAll(false);
+    const auto batch = integrateAll(true);
+    TS_ASSERT_EQUALS(batch->getNumberPeaks(), 4);
+    for (int i = 0; i < batch->getNumberPeaks(); ++i) {
+      TS_ASSERT_DELTA(batch->getPeak(i).getIntensity(),
+                      single->getPeak(i).getIntensity(), 1e-3);
+      TS_ASSERT_DELTA(batch->getPeak(i).getSigmaIntensity(),
+                      single->getPeak(i).getSigmaIntensity(), 1e-3);
+    }
+    TS_ASSERT_DELTA(batch->getPeak(1).getIntensity(), 1000.0, 30.0);
+
+    AnalysisDataService::Instance().remove("IntegratePeaksMD2Test_MDEWS");
+    AnalysisDataService::Instance().remove("IntegratePeaksMD2Test_peaks");
+  }
+
+  /// In batch mode, the top 1% of the background of the whole shell of a peak
+  /// is removed at once
+  void test_exec_IntegrateInBatch_OnePercentBackgroundCorrection() {
+    createMDEW();
+    addPeak(1000, 2., 3., 4., 0.5);
+    // Background spread over many boxes of the shell
+    addPeak(20000, 2., 3., 4., 2.0);
+    MDEventWorkspace3Lean::sptr mdews =
+        AnalysisDataService::Instance().retrieveWS<MDEventWorkspace3Lean>(
+            "IntegratePeaksMD2Test_MDEWS");
+    mdews->setCoordinateSystem(Mantid::Kernel::HKL);
+
+    Instrument_sptr inst =
+        ComponentCreationHelper::createTestInstrumentRectangular(1, 100, 0.05);
+    PeaksWorkspace_sptr peakWS(new PeaksWorkspace());
+    peakWS->setInstrument(inst);
+    const V3D center(2., 3., 4.);
+    peakWS->addPeak(Peak(inst, 15050, 1.0, center));
+    AnalysisDataService::Instance().addOrReplace("IntegratePeaksMD2Test_peaks",
+                                                 peakWS);
+
+    // The radii as set by integrateAll, adapted to |Q|
+    const double lenQ = center.norm();
+    const double radius = 0.01 * lenQ + 0.8;
+    const double innerRadius = 0.01 * lenQ + 1.0;
+    const double outerRadius = 0.01 * lenQ + 1.5;
+    double signal = 0.;
+    std::vector<double> shell;
+    std::vector<IMDNode *> boxes;
+    mdews->getBox()->getBoxes(boxes, 1000, true);
+    for (auto node : boxes) {
+      auto box = dynamic_cast<MDBox<MDLeanEvent<3>, 3> *>(node);
+      for (const auto &event : box->getConstEvents()) {
+        const double distance =
+            V3D(event.getCenter(0), event.getCenter(1), event.getCenter(2))
+                .distance(center);
+        if (distance < radius)
+          signal += event.getSignal();
+        if (distance > innerRadius && distance < outerRadius)
+          shell.emplace_back(event.getSignal());
+      }
+    }
+    std::sort(shell.begin(), shell.end());
+    shell.resize(static_cast<size_t>(0.99 * static_cast<double>(shell.size())));
+    const double bgSignal = std::accumulate(shell.cbegin(), shell.cend(), 0.);
+    const double scaleFactor =
+        pow(radius, 3) / (pow(outerRadius, 3) - pow(innerRadius, 3));
+
+    const auto batch = integrateAll(true, true);
+    TS_ASSERT_DELTA(batch->getPeak(0).getIntensity(),
+                    signal - scaleFactor * bgSignal, 1e-3);
+
+    AnalysisDataService::Instance().remove("IntegratePeaksMD2Test_MDEWS");
+    AnalysisDataService::Instance().remove("IntegratePeaksMD2Test_peaks");
+  }
+
+  /// Integrate the spheres and shells of all peaks, one by one or in batch
+  static PeaksWorkspace_sptr
+  integrateAll(const bool inBatch,
+               const bool useOnePercentBackgroundCorrection = false) {
+    IntegratePeaksMD2 alg;
+    alg.initialize();
+    alg.setChild(true);
+    alg.setPropertyValue("InputWorkspace", "IntegratePeaksMD2Test_MDEWS");
+    alg.setPropertyValue("PeaksWorkspace", "IntegratePeaksMD2Test_peaks");
+    alg.setPropertyValue("OutputWorkspace", "unused_for_child");
+    alg.setProperty("PeakRadius", 0.8);
+    alg.setProperty("BackgroundInnerRadius", 1.0);
+    alg.setProperty("BackgroundOuterRadius", 1.5);
+    alg.setProperty("AdaptiveQMultiplier", 0.01);
+    alg.setProperty("AdaptiveQBackground", true);
+    // The 1% correction is applied to the whole shell in batch mode
+    alg.setProperty("UseOnePercentBackgroundCorrection",
+                    useOnePercentBackgroundCorrection);
+    alg.setProperty("IntegrateInBatch", inBatch);
+    TS_ASSERT_THROWS_NOTHING(alg.execute());
+    return alg.getProperty("OutputWorkspace");
+  }
+
   //-------------------------------------------------------------------------------
   //// Tests of ellipsoidal integration
 
@@ -0,0 +1,197 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2020 ISIS Rutherford Appleton Laboratory UKRI,
+//   NScD Oak Ridge National Laboratory, European Spallation Source,
+//   Institut Laue - Langevin & CSNS, Institute of High Energy Physics, CAS
+// SPDX - License - Identifier: GPL - 3.0 +
+#pragma once
+
+#include "MantidAPI/ExperimentInfo.h"
+#include "MantidAPI/IMDEventWorkspace.h"
+#include "MantidAPI/IMDHistoWorkspace.h"
+#include "MantidAPI/Run.h"
+#include "MantidGeometry/MDGeometry/GeneralFrame.h"
+#include "MantidGeometry/MDGeometry/QSample.h"
+#include "MantidKernel/MultiThreaded.h"
+#include "MantidMDAlgorithms/CreateMDWorkspace.h"
+#include "MantidMDAlgorithms/MDNorm.h"
+#include "MantidTestHelpers/ComponentCreationHelper.h"
+
+#include <cxxtest/TestSuite.h>
+
+#include <cmath>
+#include <numeric>
+
+using Mantid::MDAlgorithms::CreateMDWorkspace;
+using Mantid::MDAlgorithms::MDNorm;
+using namespace Mantid::API;
+
+class MDNormTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static MDNormTest *createSuite() { return new MDNormTest(); }
+  static void destroySuite(MDNormTest *suite) { delete suite; }
+
+  void test_Init() {
+    MDNorm alg;
+    TS_ASSERT_THROWS_NOTHING(alg.initialize())
+    TS_ASSERT(alg.isInitialized())
+  }
+
+  void test_normalization_covers_the_energy_range_of_each_detector() {
+    // The trajectories start and end on bin edges of DeltaE, and lie inside
+    // the Q range: each detector adds (high - low) * charge in all
+    const auto inputWS = createInputWorkspace({2.});
+    const auto norm = runMDNorm(inputWS, "");
+    TS_ASSERT_DELTA(sum(norm), 2. * NUM_DETECTORS * (HIGH - LOW), 1e-9);
+  }
+
+  void test_parallel_normalization_matches_serial() {
+    const auto inputWS = createInputWorkspace({1.});
+    const int maxThreads = PARALLEL_GET_MAX_THREADS;
+    PARALLEL_SET_NUM_THREADS(1);
+    const auto serial = runMDNorm(inputWS, "x,y,z;-x,-y,z");
+    PARALLEL_SET_NUM_THREADS(maxThreads);
+    const auto parallel = runMDNorm(inputWS, "x,y,z;-x,-y,z");
+    assertSameValues(parallel, serial);
+    TS_ASSERT_DELTA(sum(serial), 2. * NUM_DETECTORS * (HIGH - LOW), 1e-9);
+  }
+
+  void test_reused_normalization_matches_separate_runs() {
+    // The second run has the same trajectories, so its normalization is
+    // scaled from the first one for each symmetry operation
+    const auto twoRunsWS = createInputWorkspace({1., 3.});
+    const auto reused = runMDNorm(twoRunsWS, "x,y,z;-x,-y,z");
+
+    // The same runs normalized by separate calls, accumulated
+    MDNorm first;
+    first.setChild(true);
+    first.initialize();
+    setProperties(first, createInputWorkspace({1.}), "x,y,z;-x,-y,z");
+    first.execute();
+    TS_ASSERT(first.isExecuted());
+    IMDHistoWorkspace_sptr firstData = first.getProperty("OutputDataWorkspace");
+    IMDHistoWorkspace_sptr firstNorm =
+        first.getProperty("OutputNormalizationWorkspace");
+
+    MDNorm second;
+    second.setChild(true);
+    second.initialize();
+    setProperties(second, createInputWorkspace({3.}), "x,y,z;-x,-y,z");
+    second.setProperty("TemporaryDataWorkspace", firstData);
+    second.setProperty("TemporaryNormalizationWorkspace", firstNorm);
+    second.execute();
+    TS_ASSERT(second.isExecuted());
+    IMDHistoWorkspace_sptr separateWS =
+        second.getProperty("OutputNormalizationWorkspace");
+    const std::vector<double> separate(
+        separateWS->getSignalArray(),
+        separateWS->getSignalArray() + separateWS->getNPoints());
+
+    assertSameValues(reused, separate);
+    TS_ASSERT_DELTA(sum(reused), 4. * 2. * NUM_DETECTORS * (HIGH - LOW),
+                    1e-9);
+  }
+
+private:
+  static constexpr size_t NUM_DETECTORS = 12;
+  static constexpr double EI = 10.;
+  // DeltaE range of the trajectories, on bin edges of the DeltaE binning
+  static constexpr double LOW = -2.;
+  static constexpr double HIGH = 4.;
+
+  /// A 4D workspace in Q_sample and DeltaE, with a run per proton charge
+  IMDEventWorkspace_sptr
+  createInputWorkspace(const std::vector<double> &charges) {
+    CreateMDWorkspace create;
+    create.setChild(true);
+    create.initialize();
+    create.setProperty("Dimensions", 4);
+    create.setPropertyValue("Extents", "-5,5,-5,5,-5,5,-2,4");
+    create.setPropertyValue("Names", "Q_sample_x,Q_sample_y,Q_sample_z,DeltaE");
+    create.setPropertyValue("Units", "U,U,U,meV");
+    const std::string q = Mantid::Geometry::QSample::QSampleName;
+    create.setPropertyValue(
+        "Frames", q + "," + q + "," + q + "," +
+                      Mantid::Geometry::GeneralFrame::GeneralFrameName);
+    create.setPropertyValue("OutputWorkspace", "unused_for_child");
+    create.execute();
+    IMDEventWorkspace_sptr ws = create.getProperty("OutputWorkspace");
+
+    std::vector<double> L2(NUM_DETECTORS, 2.), polar, azimuth;
+    for (size_t i = 0; i < NUM_DETECTORS; ++i) {
+      polar.emplace_back(0.3 + 0.1 * static_cast<double>(i));
+      azimuth.emplace_back(0.5 * static_cast<double>(i));
+    }
+    auto instrument =
+        ComponentCreationHelper::createCylInstrumentWithDetInGivenPositions(
+            L2, polar, azimuth);
+    for (const double charge : charges) {
+      auto info = std::make_shared<ExperimentInfo>();
+      info->setInstrument(instrument);
+      auto &run = info->mutableRun();
+      run.addProperty("Ei", EI);
+      run.addProperty("MDNorm_low", std::vector<double>(NUM_DETECTORS, LOW));
+      run.addProperty("MDNorm_high", std::vector<double>(NUM_DETECTORS, HIGH));
+      run.setProtonCharge(charge);
+      ws->addExperimentInfo(info);
+    }
+    return ws;
+  }
+
+  void setProperties(MDNorm &alg, const IMDEventWorkspace_sptr &inputWS,
+                     const std::string &symmetryOperations) {
+    alg.setProperty("InputWorkspace", inputWS);
+    alg.setProperty("RLU", false);
+    alg.setPropertyValue("Dimension0Name", "QDimension0");
+    alg.setPropertyValue("Dimension0Binning", "-5,0.5,5");
+    alg.setPropertyValue("Dimension1Name", "QDimension1");
+    alg.setPropertyValue("Dimension1Binning", "-5,0.5,5");
+    alg.setPropertyValue("Dimension2Name", "QDimension2");
+    alg.setPropertyValue("Dimension2Binning", "-5,0.5,5");
+    alg.setPropertyValue("Dimension3Name", "DeltaE");
+    alg.setPropertyValue("Dimension3Binning", "-2,0.5,4");
+    alg.setPropertyValue("SymmetryOperations", symmetryOperations);
+    alg.setPropertyValue("OutputWorkspace", "unused_for_child");
+    alg.setPropertyValue("OutputDataWorkspace", "unused_for_child_data");
+    alg.setPropertyValue("OutputNormalizationWorkspace",
+                         "unused_for_child_norm");
+  }
+
+  /// The signal of the normalization workspace
+  std::vector<double> runMDNorm(const IMDEventWorkspace_sptr &inputWS,
+                                const std::string &symmetryOperations) {
+    MDNorm alg;
+    alg.setChild(true);
+    alg.initialize();
+    setProperties(alg, inputWS, symmetryOperations);
+    TS_ASSERT_THROWS_NOTHING(alg.execute());
+    TS_ASSERT(alg.isExecuted());
+    IMDHistoWorkspace_sptr norm =
+        alg.getProperty("OutputNormalizationWorkspace");
+    TS_ASSERT(norm);
+    if (!norm)
+      return {};
+    return std::vector<double>(norm->getSignalArray(),
+                               norm->getSignalArray() + norm->getNPoints());
+  }
+
+  static double sum(const std::vector<double> &values) {
+    return std::accumulate(values.cbegin(), values.cend(), 0.);
+  }
+
+  static void assertSameValues(const std::vector<double> &actual,
+                               const std::vector<double> &expected) {
+    TS_ASSERT_EQUALS(actual.size(), expected.size());
+    if (actual.size() != expected.size())
+      return;
+    size_t numDifferent = 0;
+    for (size_t i = 0; i < actual.size(); ++i) {
+      if (std::fabs(actual[i] - expected[i]) >
+          1e-12 * (1. + std::fabs(expected[i])))
+        ++numDifferent;
+    }
+    TS_ASSERT_EQUALS(numDifferent, 0);
+  }
+};
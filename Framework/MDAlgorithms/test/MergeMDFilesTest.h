@@ -28,11 +28,19 @@ public:
     TS_ASSERT(alg.isInitialized())
   }
 
-  void test_exec() { do_test_exec(""); }
+  void test_exec() { do_test_exec("", false); }
 
-  void test_exec_fileBacked() { do_test_exec("MergeMDFilesTest_OutputWS.nxs"); }
+  void test_exec_parallel() { do_test_exec("", true); }
 
-  void do_test_exec(const std::string &OutputFilename) {
+  void test_exec_fileBacked() {
+    do_test_exec("MergeMDFilesTest_OutputWS.nxs", false);
+  }
+
+  void test_exec_fileBacked_parallel() {
+    do_test_exec("MergeMDFilesTest_OutputWS.nxs", true);
+  }
+
+  void do_test_exec(const std::string &OutputFilename, const bool parallel) {
     if (OutputFilename != "") {
       if (Poco::File(OutputFilename).exists())
         Poco::File(OutputFilename).remove();
@@ -68,6 +76,7 @@ public:
         alg.setPropertyValue("OutputFilename", OutputFilename));
     TS_ASSERT_THROWS_NOTHING(
         alg.setPropertyValue("OutputWorkspace", outWSName));
+    TS_ASSERT_THROWS_NOTHING(alg.setProperty("Parallel", parallel));
 
     // clean up possible rubbish from previous runs
     std::string fullName = alg.getPropertyValue("OutputFilename");
@@ -98,6 +107,13 @@ public:
     // Check that each box has at least SOMETHING
     for (size_t i = 0; i < box->getNumChildren(); i++)
       TS_ASSERT_LESS_THAN(1, box->getChild(i)->getNPoints());
+    // Each box holds the events of the same box of every input
+    for (size_t i = 0; i < box->getNumChildren(); i++) {
+      uint64_t expected = 0;
+      for (const auto &inWorkspace : inWorkspaces)
+        expected += inWorkspace->getBox()->getChild(i)->getNPoints();
+      TS_ASSERT_EQUALS(box->getChild(i)->getNPoints(), expected);
+    }
 
     if (!OutputFilename.empty()) {
       TS_ASSERT(ws->isFileBacked());
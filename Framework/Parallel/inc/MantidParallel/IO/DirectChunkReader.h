@@ -0,0 +1,63 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2020 ISIS Rutherford Appleton Laboratory UKRI,
+//   NScD Oak Ridge National Laboratory, European Spallation Source,
+//   Institut Laue - Langevin & CSNS, Institute of High Energy Physics, CAS
+// SPDX - License - Identifier: GPL - 3.0 +
+#pragma once
+
+#include <H5Cpp.h>
+#include <vector>
+
+#include "MantidParallel/DllConfig.h"
+
+namespace Mantid {
+namespace Parallel {
+namespace IO {
+
+/** DirectChunkReader reads parts of a one-dimensional, chunked HDF5 data set
+  by fetching the raw, still compressed chunks with H5Dread_chunk and
+  decompressing them on several threads.
+
+  When libhdf5 reads a compressed data set it decompresses the chunks one
+  after the other while holding its global lock. On fast storage this, rather
+  than the disk, limits how fast events are loaded.
+
+  Only the deflate (gzip) and shuffle filters are decoded here. If the data
+  set uses other filters, is not chunked, or a chunk was never written, read()
+  returns false and the data must be read with the normal HDF5 API. The same
+  happens with HDF5 older than 1.10.2, which has no H5Dread_chunk.
+*/
+class MANTID_PARALLEL_DLL DirectChunkReader {
+public:
+  DirectChunkReader() = default;
+  explicit DirectChunkReader(const H5::DataSet &dataSet);
+
+  bool isSupported() const;
+  bool read(void *buffer, const H5::DataType &memType, const size_t start,
+            const size_t count) const;
+
+private:
+  enum class Filter { Deflate, Shuffle };
+
+  bool decode(std::vector<char> &chunk, const uint32_t filterMask) const;
+  bool inflate(std::vector<char> &chunk) const;
+  void unshuffle(std::vector<char> &chunk) const;
+
+  H5::DataSet m_dataSet;
+  bool m_supported{false};
+  /// Type of the elements of the data set in the file
+  H5::DataType m_dataType;
+  /// Number of elements in the data set
+  hsize_t m_size{0};
+  /// Number of elements in a chunk
+  hsize_t m_chunkSize{0};
+  /// Size of an element in bytes
+  size_t m_elementSize{0};
+  /// Filters of the data set, in the order they are applied when writing
+  std::vector<Filter> m_filters;
+};
+
+} // namespace IO
+} // namespace Parallel
+} // namespace Mantid
@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "MantidParallel/DllConfig.h"
+#include "MantidParallel/IO/DirectChunkReader.h"
 #include "MantidParallel/IO/NXEventDataSource.h"
 #include "MantidParallel/IO/PulseTimeGenerator.h"
 #include "MantidTypes/Core/DateAndTime.h"
@@ -49,6 +50,8 @@ private:
   const std::vector<std::string> m_bankNames;
   H5::DataSet m_id;
   H5::DataSet m_time_offset;
+  DirectChunkReader m_idChunks;
+  DirectChunkReader m_timeOffsetChunks;
 };
 
 namespace detail {
@@ -83,6 +86,39 @@ void read(T *buffer, const H5::DataSet &dataSet, size_t start, size_t count) {
   dataSet.read(buffer, dataType, memSpace, dataSpace);
 }
 
+/// Return the native HDF5 type of T.
+template <class T> const H5::DataType &nativeType();
+template <> inline const H5::DataType &nativeType<int32_t>() {
+  return H5::PredType::NATIVE_INT32;
+}
+template <> inline const H5::DataType &nativeType<int64_t>() {
+  return H5::PredType::NATIVE_INT64;
+}
+template <> inline const H5::DataType &nativeType<uint32_t>() {
+  return H5::PredType::NATIVE_UINT32;
+}
+template <> inline const H5::DataType &nativeType<uint64_t>() {
+  return H5::PredType::NATIVE_UINT64;
+}
+template <> inline const H5::DataType &nativeType<float>() {
+  return H5::PredType::NATIVE_FLOAT;
+}
+template <> inline const H5::DataType &nativeType<double>() {
+  return H5::PredType::NATIVE_DOUBLE;
+}
+
+/** Read subset of data set and write the result into buffer. Compressed
+ * chunks are decoded in parallel by chunkReader if the data set is stored as
+ * the native type of T.
+ *
+ * The subset is given by a start index and a count. */
+template <class T>
+void read(T *buffer, const DirectChunkReader &chunkReader,
+          const H5::DataSet &dataSet, size_t start, size_t count) {
+  if (!chunkReader.read(buffer, nativeType<T>(), start, count))
+    read(buffer, dataSet, start, count);
+}
+
 /** Read subset of data set from group and write the result into buffer.
  *
  * The subset is given by a start index and a count. */
@@ -181,6 +217,8 @@ NXEventDataLoader<TimeOffsetType>::setBankIndex(const size_t bank) {
   m_group = m_root.openGroup(m_bankNames[bank]);
   m_id = m_group.openDataSet("event_id");
   m_time_offset = m_group.openDataSet("event_time_offset");
+  m_idChunks = DirectChunkReader(m_id);
+  m_timeOffsetChunks = DirectChunkReader(m_time_offset);
   return detail::makeEventDataPartitioner<TimeOffsetType>(
       m_group.openDataSet("event_index").getDataType(),
       m_group.openDataSet("event_time_zero").getDataType(), m_group,
@@ -192,7 +230,7 @@ template <class TimeOffsetType>
 void NXEventDataLoader<TimeOffsetType>::readEventID(int32_t *buffer,
                                                     size_t start,
                                                     size_t count) const {
-  detail::read(buffer, m_id, start, count);
+  detail::read(buffer, m_idChunks, m_id, start, count);
 }
 
 /// Read subset given by start and count from event_time_offset and write it
@@ -200,7 +238,7 @@ void NXEventDataLoader<TimeOffsetType>::readEventID(int32_t *buffer,
 template <class TimeOffsetType>
 void NXEventDataLoader<TimeOffsetType>::readEventTimeOffset(
     TimeOffsetType *buffer, size_t start, size_t count) const {
-  detail::read(buffer, m_time_offset, start, count);
+  detail::read(buffer, m_timeOffsetChunks, m_time_offset, start, count);
 }
 
 /// Read and return the `units` attribute from event_time_offset.
@@ -0,0 +1,201 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2020 ISIS Rutherford Appleton Laboratory UKRI,
+//   NScD Oak Ridge National Laboratory, European Spallation Source,
+//   Institut Laue - Langevin & CSNS, Institute of High Energy Physics, CAS
+// SPDX - License - Identifier: GPL - 3.0 +
+#include "MantidParallel/IO/DirectChunkReader.h"
+#include "MantidKernel/MultiThreaded.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <zlib.h>
+
+namespace Mantid {
+namespace Parallel {
+namespace IO {
+
+/** Constructor. Inspects the layout and filters of the data set to find out
+ * if its chunks can be decoded directly. They never are with HDF5 older than
+ * 1.10.2, which cannot read raw chunks.
+ * @param dataSet :: the data set to read from
+ */
+DirectChunkReader::DirectChunkReader(const H5::DataSet &dataSet)
+    : m_dataSet(dataSet) {
+#if H5_VERSION_GE(1, 10, 2)
+  const H5::DataSpace dataSpace = dataSet.getSpace();
+  if (dataSpace.getSimpleExtentNdims() != 1)
+    return;
+  dataSpace.getSimpleExtentDims(&m_size);
+
+  m_dataType = dataSet.getDataType();
+  const auto typeClass = m_dataType.getClass();
+  if (typeClass != H5T_INTEGER && typeClass != H5T_FLOAT)
+    return;
+  m_elementSize = m_dataType.getSize();
+
+  const H5::DSetCreatPropList properties = dataSet.getCreatePlist();
+  if (properties.getLayout() != H5D_CHUNKED)
+    return;
+  properties.getChunk(1, &m_chunkSize);
+
+  const int numFilters = properties.getNfilters();
+  for (int i = 0; i < numFilters; ++i) {
+    unsigned int flags;
+    size_t numValues = 0;
+    unsigned int config;
+    char name[1];
+    const auto filter =
+        properties.getFilter(i, flags, numValues, nullptr, 0, name, config);
+    if (filter == H5Z_FILTER_DEFLATE)
+      m_filters.emplace_back(Filter::Deflate);
+    else if (filter == H5Z_FILTER_SHUFFLE)
+      m_filters.emplace_back(Filter::Shuffle);
+    else
+      return;
+  }
+  // Without compression libhdf5 reads just as fast
+  m_supported = std::find(m_filters.cbegin(), m_filters.cend(),
+                          Filter::Deflate) != m_filters.cend();
+#endif
+}
+
+/// Return true if the chunks of the data set can be decoded directly
+bool DirectChunkReader::isSupported() const { return m_supported; }
+
+/** Read a range of elements. The chunks are copied as they are stored in the
+ * file, so this is only done if that is the type of the buffer: a data set of
+ * another size, sign or byte order is left to libhdf5 to convert.
+ * @param buffer :: buffer to write count elements to
+ * @param memType :: the native HDF5 type of the elements of the buffer
+ * @param start :: index of the first element to read
+ * @param count :: number of elements to read
+ * @return false if the data must be read with the HDF5 API instead
+ * @throws std::out_of_range if the range is outside of the data set
+ * @throws std::runtime_error if a chunk cannot be read or decompressed
+ */
+bool DirectChunkReader::read(void *buffer, const H5::DataType &memType,
+                             const size_t start, const size_t count) const {
+  if (!m_supported || !(m_dataType == memType))
+    return false;
+  if (start >= m_size)
+    throw std::out_of_range("Start index is beyond end of file");
+  if (count > m_size - start)
+    throw std::out_of_range("End index is beyond end of file");
+  if (count == 0)
+    return true;
+
+  const hsize_t firstChunk = start / m_chunkSize;
+  const size_t numChunks = (start + count - 1) / m_chunkSize - firstChunk + 1;
+
+  // Fetching the raw chunks goes through libhdf5, one at a time
+  std::vector<std::vector<char>> chunks(numChunks);
+  std::vector<uint32_t> filterMasks(numChunks);
+#if H5_VERSION_GE(1, 10, 2)
+  const hid_t id = m_dataSet.getId();
+  for (size_t i = 0; i < numChunks; ++i) {
+    hsize_t offset = (firstChunk + i) * m_chunkSize;
+    hsize_t numBytes = 0;
+    if (H5Dget_chunk_storage_size(id, &offset, &numBytes) < 0 ||
+        numBytes == 0)
+      // Never written, libhdf5 supplies the fill value
+      return false;
+    chunks[i].resize(numBytes);
+    if (H5Dread_chunk(id, H5P_DEFAULT, &offset, &filterMasks[i],
+                      chunks[i].data()) < 0)
+      throw std::runtime_error("Failed to read a chunk of HDF5 data set " +
+                               m_dataSet.getObjName());
+  }
+#else
+  // Not reached, the reader is never supported
+  return false;
+#endif
+
+  // Decompressing them does not, so is done in parallel
+  auto output = static_cast<char *>(buffer);
+  std::atomic<bool> failed{false};
+  PARALLEL_FOR_NO_WSP_CHECK()
+  for (int64_t i = 0; i < static_cast<int64_t>(numChunks); ++i) {
+    auto &chunk = chunks[i];
+    if (!decode(chunk, filterMasks[i])) {
+      failed = true;
+      continue;
+    }
+    const size_t chunkStart = (firstChunk + i) * m_chunkSize;
+    const size_t from = std::max(start, chunkStart);
+    const size_t to =
+        std::min(start + count, chunkStart + static_cast<size_t>(m_chunkSize));
+    std::memcpy(output + (from - start) * m_elementSize,
+                chunk.data() + (from - chunkStart) * m_elementSize,
+                (to - from) * m_elementSize);
+    std::vector<char>().swap(chunk);
+  }
+  if (failed)
+    throw std::runtime_error(
+        "Failed to decompress a chunk of HDF5 data set " +
+        m_dataSet.getObjName());
+  return true;
+}
+
+/** Undo the filters applied to a chunk
+ * @param chunk :: the raw chunk, replaced by the decoded one
+ * @param filterMask :: bit i is set if filter i was not applied to the chunk
+ * @return false if the chunk is corrupt
+ */
+bool DirectChunkReader::decode(std::vector<char> &chunk,
+                               const uint32_t filterMask) const {
+  // Filters are undone in the reverse order to that they were applied in
+  for (size_t i = m_filters.size(); i-- > 0;) {
+    if (filterMask & (1u << i))
+      continue;
+    if (m_filters[i] == Filter::Deflate) {
+      if (!inflate(chunk))
+        return false;
+    } else {
+      unshuffle(chunk);
+    }
+  }
+  return chunk.size() == m_chunkSize * m_elementSize;
+}
+
+/** Decompress a chunk written by the deflate filter
+ * @param chunk :: the compressed chunk, replaced by the uncompressed one
+ * @return false if the chunk cannot be decompressed
+ */
+bool DirectChunkReader::inflate(std::vector<char> &chunk) const {
+  std::vector<char> uncompressed(m_chunkSize * m_elementSize);
+  auto size = static_cast<uLongf>(uncompressed.size());
+  if (uncompress(reinterpret_cast<Bytef *>(uncompressed.data()), &size,
+                 reinterpret_cast<const Bytef *>(chunk.data()),
+                 static_cast<uLong>(chunk.size())) != Z_OK)
+    return false;
+  uncompressed.resize(size);
+  chunk.swap(uncompressed);
+  return true;
+}
+
+/** Undo the shuffle filter, which stores the first byte of all elements,
+ * then the second byte of all elements, and so on. Trailing bytes that do not
+ * make up a whole element are not shuffled.
+ * @param chunk :: the shuffled chunk, replaced by the original one
+ */
+void DirectChunkReader::unshuffle(std::vector<char> &chunk) const {
+  if (m_elementSize <= 1)
+    return;
+  const size_t numElements = chunk.size() / m_elementSize;
+  std::vector<char> unshuffled(chunk.size());
+  for (size_t byte = 0; byte < m_elementSize; ++byte) {
+    const char *source = chunk.data() + byte * numElements;
+    for (size_t element = 0; element < numElements; ++element)
+      unshuffled[element * m_elementSize + byte] = source[element];
+  }
+  std::copy(chunk.cbegin() + numElements * m_elementSize, chunk.cend(),
+            unshuffled.begin() + numElements * m_elementSize);
+  chunk.swap(unshuffled);
+}
+
+} // namespace IO
+} // namespace Parallel
+} // namespace Mantid
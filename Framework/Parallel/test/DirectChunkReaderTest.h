@@ -0,0 +1,159 @@
+// Mantid Repository : https://github.com/mantidproject/mantid
+//
+// Copyright &copy; 2020 ISIS Rutherford Appleton Laboratory UKRI,
+//   NScD Oak Ridge National Laboratory, European Spallation Source,
+//   Institut Laue - Langevin & CSNS, Institute of High Energy Physics, CAS
+// SPDX - License - Identifier: GPL - 3.0 +
+#pragma once
+
+#include <cxxtest/TestSuite.h>
+
+#include "MantidParallel/IO/DirectChunkReader.h"
+
+#include <H5Cpp.h>
+#include <Poco/File.h>
+#include <numeric>
+
+using namespace Mantid::Parallel::IO;
+
+class DirectChunkReaderTest : public CxxTest::TestSuite {
+public:
+  // This pair of boilerplate methods prevent the suite being created statically
+  // This means the constructor isn't called when running other tests
+  static DirectChunkReaderTest *createSuite() {
+    return new DirectChunkReaderTest();
+  }
+  static void destroySuite(DirectChunkReaderTest *suite) { delete suite; }
+
+  DirectChunkReaderTest() {
+    removeFile();
+    H5::H5File file(FILENAME, H5F_ACC_EXCL);
+    std::vector<int32_t> ids(SIZE);
+    std::iota(ids.begin(), ids.end(), -1000);
+    std::vector<float> tofs(SIZE);
+    for (size_t i = 0; i < SIZE; ++i)
+      tofs[i] = 0.5f * static_cast<float>(i % 997);
+    write(file, "deflate", ids, H5::PredType::NATIVE_INT32, false, true);
+    write(file, "shuffle_deflate", tofs, H5::PredType::NATIVE_FLOAT, true,
+          true);
+    write(file, "chunked", ids, H5::PredType::NATIVE_INT32, false, false);
+    write(file, "big_endian", ids, H5::PredType::STD_I32BE, false, true);
+  }
+
+  ~DirectChunkReaderTest() override { removeFile(); }
+
+  void test_deflate_is_supported() {
+    H5::H5File file(FILENAME, H5F_ACC_RDONLY);
+    DirectChunkReader reader(file.openDataSet("deflate"));
+    TS_ASSERT_EQUALS(reader.isSupported(), DIRECT_READS);
+    assertReadMatchesHDF5<int32_t>(file, "deflate",
+                                   H5::PredType::NATIVE_INT32);
+  }
+
+  void test_shuffle_and_deflate_are_supported() {
+    H5::H5File file(FILENAME, H5F_ACC_RDONLY);
+    DirectChunkReader reader(file.openDataSet("shuffle_deflate"));
+    TS_ASSERT_EQUALS(reader.isSupported(), DIRECT_READS);
+    assertReadMatchesHDF5<float>(file, "shuffle_deflate",
+                                 H5::PredType::NATIVE_FLOAT);
+  }
+
+  void test_uncompressed_is_left_to_hdf5() {
+    H5::H5File file(FILENAME, H5F_ACC_RDONLY);
+    DirectChunkReader reader(file.openDataSet("chunked"));
+    TS_ASSERT(!reader.isSupported());
+    int32_t value;
+    TS_ASSERT(!reader.read(&value, H5::PredType::NATIVE_INT32, 0, 1));
+  }
+
+  void test_element_size_mismatch_is_left_to_hdf5() {
+    H5::H5File file(FILENAME, H5F_ACC_RDONLY);
+    DirectChunkReader reader(file.openDataSet("deflate"));
+    int64_t value;
+    TS_ASSERT(!reader.read(&value, H5::PredType::NATIVE_INT64, 0, 1));
+  }
+
+  void test_type_mismatch_of_the_same_size_is_left_to_hdf5() {
+    H5::H5File file(FILENAME, H5F_ACC_RDONLY);
+    DirectChunkReader reader(file.openDataSet("deflate"));
+    uint32_t unsignedValue;
+    TS_ASSERT(!reader.read(&unsignedValue, H5::PredType::NATIVE_UINT32, 0, 1));
+    float floatValue;
+    TS_ASSERT(!reader.read(&floatValue, H5::PredType::NATIVE_FLOAT, 0, 1));
+  }
+
+  void test_byte_order_mismatch_is_left_to_hdf5() {
+    H5::H5File file(FILENAME, H5F_ACC_RDONLY);
+    DirectChunkReader reader(file.openDataSet("big_endian"));
+    TS_ASSERT_EQUALS(reader.isSupported(), DIRECT_READS);
+    int32_t value;
+    TS_ASSERT(!reader.read(&value, H5::PredType::NATIVE_INT32, 0, 1));
+  }
+
+  void test_range_beyond_end_throws() {
+    if (!DIRECT_READS)
+      return;
+    H5::H5File file(FILENAME, H5F_ACC_RDONLY);
+    DirectChunkReader reader(file.openDataSet("deflate"));
+    std::vector<int32_t> buffer(2);
+    const auto &type = H5::PredType::NATIVE_INT32;
+    TS_ASSERT_THROWS(reader.read(buffer.data(), type, SIZE, 1),
+                     const std::out_of_range &);
+    TS_ASSERT_THROWS(reader.read(buffer.data(), type, SIZE - 1, 2),
+                     const std::out_of_range &);
+  }
+
+private:
+  const std::string FILENAME{"DirectChunkReaderTest.h5"};
+  // Raw chunks can only be read from HDF5 1.10.2 on
+  static constexpr bool DIRECT_READS = H5_VERSION_GE(1, 10, 2);
+  // Not a multiple of the chunk size, so the last chunk is partly used
+  static constexpr size_t SIZE = 10000;
+  static constexpr hsize_t CHUNK_SIZE = 1024;
+
+  void removeFile() {
+    if (Poco::File(FILENAME).exists())
+      Poco::File(FILENAME).remove();
+  }
+
+  template <class T>
+  void write(H5::H5File &file, const std::string &name,
+             const std::vector<T> &data, const H5::PredType &type,
+             const bool shuffle, const bool deflate) {
+    const hsize_t size = data.size();
+    H5::DataSpace dataSpace(1, &size);
+    H5::DSetCreatPropList properties;
+    properties.setChunk(1, &CHUNK_SIZE);
+    if (shuffle)
+      properties.setShuffle();
+    if (deflate)
+      properties.setDeflate(6);
+    auto dataSet = file.createDataSet(name, type, dataSpace, properties);
+    dataSet.write(data.data(), type);
+  }
+
+  template <class T>
+  void assertReadMatchesHDF5(H5::H5File &file, const std::string &name,
+                             const H5::PredType &type) {
+    const auto dataSet = file.openDataSet(name);
+    DirectChunkReader reader(dataSet);
+    const std::vector<std::pair<size_t, size_t>> ranges{
+        {0, SIZE}, {0, 1}, {1000, 100}, {1023, 2}, {5000, 3000}, {SIZE - 7, 7}};
+    for (const auto &range : ranges) {
+      std::vector<T> expected(range.second);
+      hsize_t start = range.first;
+      hsize_t count = range.second;
+      H5::DataSpace fileSpace = dataSet.getSpace();
+      fileSpace.selectHyperslab(H5S_SELECT_SET, &count, &start);
+      H5::DataSpace memSpace(1, &count);
+      dataSet.read(expected.data(), type, memSpace, fileSpace);
+
+      std::vector<T> values(range.second);
+      TS_ASSERT_EQUALS(
+          reader.read(values.data(), type, range.first, range.second),
+          DIRECT_READS);
+      if (DIRECT_READS)
+        TS_ASSERT_EQUALS(values, expected);
+    }
+  }
+};
@@ -10,6 +10,7 @@
 System test for MDNorm
 """
 from mantid.simpleapi import *
+import numpy
 import systemtesting
 
 
@@ -63,6 +64,32 @@ class MDNormCORELLITest(systemtesting.MantidSystemTest):
                OutputDataWorkspace='dataMD',
                OutputNormalizationWorkspace='normMD')
 
+        # A repeated run reuses the normalization of each symmetry operation
+        # and must add the same normalization again
+        CloneWorkspace(InputWorkspace='md', OutputWorkspace='mdRepeat')
+        MergeMD(InputWorkspaces='md,mdRepeat', OutputWorkspace='mdTwice')
+        MDNorm(InputWorkspace='mdTwice',
+               SolidAngleWorkspace='SolidAngle',
+               FluxWorkspace='Flux',
+               QDimension0='1,1,0',
+               QDimension1='1,-1,0',
+               QDimension2='0,0,1',
+               Dimension0Name='QDimension0',
+               Dimension0Binning='-10.0,0.1,10.0',
+               Dimension1Name='QDimension1',
+               Dimension1Binning='-10.0,0.1,10.0',
+               Dimension2Name='QDimension2',
+               Dimension2Binning='-0.1,0.1',
+               SymmetryOperations='P 31 2 1',
+               OutputWorkspace='resultTwice',
+               OutputDataWorkspace='dataTwiceMD',
+               OutputNormalizationWorkspace='normTwiceMD')
+        norm = mtd['normMD'].getSignalArray()
+        normTwice = mtd['normTwiceMD'].getSignalArray()
+        self.assertTrue(numpy.allclose(normTwice, 2 * norm, rtol=1e-10))
+        DeleteWorkspace('mdRepeat')
+        DeleteWorkspace('mdTwice')
+
         # Check that we test these problematic cases
         self.assertRaises(ValueError, mantid.simpleapi.MDNorm,
                           InputWorkspace='md',